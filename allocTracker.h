@@ -0,0 +1,329 @@
+/***********************************************************************
+ * Component:
+ *    ALLOC TRACKER
+ * Summary:
+ *    Count every call to the global operator new and delete: how many,
+ *    how many bytes, how many bytes are still live, the peak, and
+ *    a histogram of the sizes. This sees the list nodes, the vector
+ *    buffers, and the hash buckets, where the Spy only sees itself.
+ *
+ *    The replacement operators are only compiled into the one file
+ *    that defines TRACK_ALLOCATIONS before including this header.
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>     // for std::size_t
+#include <cstdint>     // for std::uint64_t
+#include <cstdlib>     // for std::malloc and std::free
+#include <atomic>      // for std::atomic
+#include <new>         // for std::bad_alloc and std::align_val_t
+
+enum { NUM_SIZE_CLASSES = 32 };  // 1, 2, 4, ... 2^31 and bigger
+
+/*************************************************************
+ * ALLOC STATS
+ * A snapshot of the allocation counters
+ *************************************************************/
+struct AllocStats
+{
+   std::uint64_t numAlloc;        // calls to operator new
+   std::uint64_t numFree;         // calls to operator delete
+   std::uint64_t bytesAlloc;      // bytes handed out
+   std::uint64_t bytesFree;       // bytes given back
+   std::int64_t  bytesLive;       // bytesAlloc - bytesFree
+   std::int64_t  bytesPeak;       // the most bytesLive has been
+   std::uint64_t histogram[NUM_SIZE_CLASSES]; // allocations by size class
+};
+
+/*************************************************************
+ * ALLOC TRACKER
+ * Each thread keeps its own counters, as the Spy does, so a unit
+ * test running next to others sees only its own allocations. The
+ * totals across all threads are kept as well for benchmarks.
+ *************************************************************/
+class AllocTracker
+{
+public:
+   // is the global operator new being replaced in this program?
+   static bool enabled()
+   {
+#ifdef TRACK_ALLOCATIONS
+      return true;
+#else
+      return false;
+#endif // TRACK_ALLOCATIONS
+   }
+
+   // the allocations made by this thread since the last reset()
+   static AllocStats thread()
+   {
+      return threadStats();
+   }
+
+   // the allocations made by every thread since the last resetTotal()
+   static AllocStats total()
+   {
+      Totals & t = totals();
+      AllocStats stats = {};
+      stats.numAlloc   = t.numAlloc.load(std::memory_order_relaxed);
+      stats.numFree    = t.numFree.load(std::memory_order_relaxed);
+      stats.bytesAlloc = t.bytesAlloc.load(std::memory_order_relaxed);
+      stats.bytesFree  = t.bytesFree.load(std::memory_order_relaxed);
+      stats.bytesLive  = t.bytesLive.load(std::memory_order_relaxed);
+      stats.bytesPeak  = t.bytesPeak.load(std::memory_order_relaxed);
+      for (int i = 0; i < NUM_SIZE_CLASSES; i++)
+         stats.histogram[i] = t.histogram[i].load(std::memory_order_relaxed);
+      return stats;
+   }
+
+   // reset this thread's counters for a new test
+   static void reset() noexcept
+   {
+      threadStats() = AllocStats();
+   }
+
+   // reset the totals for a new benchmark. Live bytes are kept.
+   static void resetTotal() noexcept
+   {
+      Totals & t = totals();
+      t.numAlloc.store(0, std::memory_order_relaxed);
+      t.numFree.store(0, std::memory_order_relaxed);
+      t.bytesAlloc.store(0, std::memory_order_relaxed);
+      t.bytesFree.store(0, std::memory_order_relaxed);
+      t.bytesPeak.store(t.bytesLive.load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+      for (int i = 0; i < NUM_SIZE_CLASSES; i++)
+         t.histogram[i].store(0, std::memory_order_relaxed);
+   }
+
+   // which histogram bucket does an allocation of this size go in?
+   static int sizeClass(std::size_t size) noexcept
+   {
+      int i = 0;
+      while (i < NUM_SIZE_CLASSES - 1 && (std::size_t(1) << i) < size)
+         i++;
+      return i;
+   }
+
+   // called by operator new
+   static void recordAlloc(std::size_t size) noexcept
+   {
+      int i = sizeClass(size);
+
+      AllocStats & s = threadStats();
+      s.numAlloc++;
+      s.bytesAlloc += size;
+      s.bytesLive += size;
+      if (s.bytesLive > s.bytesPeak)
+         s.bytesPeak = s.bytesLive;
+      s.histogram[i]++;
+
+      Totals & t = totals();
+      t.numAlloc.fetch_add(1, std::memory_order_relaxed);
+      t.bytesAlloc.fetch_add(size, std::memory_order_relaxed);
+      t.histogram[i].fetch_add(1, std::memory_order_relaxed);
+      std::int64_t live = t.bytesLive.fetch_add(size, std::memory_order_relaxed) + size;
+      std::int64_t peak = t.bytesPeak.load(std::memory_order_relaxed);
+      while (live > peak &&
+             !t.bytesPeak.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+         ;
+   }
+
+   // called by operator delete
+   static void recordFree(std::size_t size) noexcept
+   {
+      AllocStats & s = threadStats();
+      s.numFree++;
+      s.bytesFree += size;
+      s.bytesLive -= size;
+
+      Totals & t = totals();
+      t.numFree.fetch_add(1, std::memory_order_relaxed);
+      t.bytesFree.fetch_add(size, std::memory_order_relaxed);
+      t.bytesLive.fetch_sub(size, std::memory_order_relaxed);
+   }
+
+private:
+   // the counters shared by all the threads
+   struct Totals
+   {
+      std::atomic<std::uint64_t> numAlloc;
+      std::atomic<std::uint64_t> numFree;
+      std::atomic<std::uint64_t> bytesAlloc;
+      std::atomic<std::uint64_t> bytesFree;
+      std::atomic<std::int64_t>  bytesLive;
+      std::atomic<std::int64_t>  bytesPeak;
+      std::atomic<std::uint64_t> histogram[NUM_SIZE_CLASSES];
+   };
+
+   // zero-initialized without a constructor so operator new can
+   // use them before main() and while threads are shutting down
+   static Totals & totals() noexcept
+   {
+      static Totals t;
+      return t;
+   }
+   static AllocStats & threadStats() noexcept
+   {
+      static thread_local AllocStats s;
+      return s;
+   }
+};
+
+#ifdef TRACK_ALLOCATIONS
+
+/*************************************************************
+ * GLOBAL OPERATOR NEW and DELETE
+ * Each block carries a header in front of it with its size, so
+ * delete knows how many bytes are going away, and the address
+ * malloc() returned, so delete can free it. The header is 16
+ * bytes to keep the block aligned as malloc() does; a type
+ * aligned past that gets its block moved up to the next
+ * multiple of its alignment, with the header still just before.
+ *
+ * The operators are never inlined. GCC would otherwise see
+ * through new and delete to malloc() and free() at each call
+ * and warn that they do not match.
+ *************************************************************/
+#if defined(_MSC_VER)
+#define ALLOC_TRACKER_NOINLINE __declspec(noinline)
+#else
+#define ALLOC_TRACKER_NOINLINE __attribute__((noinline))
+#endif
+
+namespace allocTrackerDetail
+{
+   enum { HEADER = 16 };
+
+   struct Header
+   {
+      std::size_t size;    // what the user asked for
+      void *      pBlock;  // what malloc() returned
+   };
+   static_assert(sizeof(Header) <= HEADER, "the header must fit in front of the block");
+
+   inline void * allocate(std::size_t size, std::size_t align = HEADER) noexcept
+   {
+      if (align < HEADER)
+         align = HEADER;
+      // malloc() is 16-byte aligned, so the header and the padding up
+      // to the alignment together never take more than align bytes
+      char * pBlock = (char *)std::malloc(size + align);
+      if (nullptr == pBlock)
+         return nullptr;
+      std::uintptr_t user = ((std::uintptr_t)pBlock + HEADER + align - 1) & ~(std::uintptr_t)(align - 1);
+      Header * pHeader = (Header *)(user - HEADER);
+      pHeader->size = size;
+      pHeader->pBlock = pBlock;
+      AllocTracker::recordAlloc(size);
+      return (void *)user;
+   }
+
+   inline void deallocate(void * pUser) noexcept
+   {
+      if (nullptr == pUser)
+         return;
+      Header * pHeader = (Header *)((std::uintptr_t)pUser - HEADER);
+      AllocTracker::recordFree(pHeader->size);
+      std::free(pHeader->pBlock);
+   }
+}
+
+ALLOC_TRACKER_NOINLINE void * operator new(std::size_t size)
+{
+   void * p = allocTrackerDetail::allocate(size);
+   if (nullptr == p)
+      throw std::bad_alloc();
+   return p;
+}
+ALLOC_TRACKER_NOINLINE void * operator new[](std::size_t size)
+{
+   return operator new(size);
+}
+ALLOC_TRACKER_NOINLINE void * operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+   return allocTrackerDetail::allocate(size);
+}
+ALLOC_TRACKER_NOINLINE void * operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+   return allocTrackerDetail::allocate(size);
+}
+ALLOC_TRACKER_NOINLINE void operator delete(void * p) noexcept
+{
+   allocTrackerDetail::deallocate(p);
+}
+ALLOC_TRACKER_NOINLINE void operator delete[](void * p) noexcept
+{
+   allocTrackerDetail::deallocate(p);
+}
+ALLOC_TRACKER_NOINLINE void operator delete(void * p, std::size_t) noexcept
+{
+   allocTrackerDetail::deallocate(p);
+}
+ALLOC_TRACKER_NOINLINE void operator delete[](void * p, std::size_t) noexcept
+{
+   allocTrackerDetail::deallocate(p);
+}
+ALLOC_TRACKER_NOINLINE void operator delete(void * p, const std::nothrow_t &) noexcept
+{
+   allocTrackerDetail::deallocate(p);
+}
+ALLOC_TRACKER_NOINLINE void operator delete[](void * p, const std::nothrow_t &) noexcept
+{
+   allocTrackerDetail::deallocate(p);
+}
+
+/*************************************************************
+ * GLOBAL OPERATOR NEW and DELETE, OVER-ALIGNED
+ * For a type with alignas() past what new normally gives
+ *************************************************************/
+ALLOC_TRACKER_NOINLINE void * operator new(std::size_t size, std::align_val_t align)
+{
+   void * p = allocTrackerDetail::allocate(size, static_cast<std::size_t>(align));
+   if (nullptr == p)
+      throw std::bad_alloc();
+   return p;
+}
+ALLOC_TRACKER_NOINLINE void * operator new[](std::size_t size, std::align_val_t align)
+{
+   return operator new(size, align);
+}
+ALLOC_TRACKER_NOINLINE void * operator new(std::size_t size, std::align_val_t align,
+                                           const std::nothrow_t &) noexcept
+{
+   return allocTrackerDetail::allocate(size, static_cast<std::size_t>(align));
+}
+ALLOC_TRACKER_NOINLINE void * operator new[](std::size_t size, std::align_val_t align,
+                                             const std::nothrow_t &) noexcept
+{
+   return allocTrackerDetail::allocate(size, static_cast<std::size_t>(align));
+}
+ALLOC_TRACKER_NOINLINE void operator delete(void * p, std::align_val_t) noexcept
+{
+   allocTrackerDetail::deallocate(p);
+}
+ALLOC_TRACKER_NOINLINE void operator delete[](void * p, std::align_val_t) noexcept
+{
+   allocTrackerDetail::deallocate(p);
+}
+ALLOC_TRACKER_NOINLINE void operator delete(void * p, std::size_t, std::align_val_t) noexcept
+{
+   allocTrackerDetail::deallocate(p);
+}
+ALLOC_TRACKER_NOINLINE void operator delete[](void * p, std::size_t, std::align_val_t) noexcept
+{
+   allocTrackerDetail::deallocate(p);
+}
+ALLOC_TRACKER_NOINLINE void operator delete(void * p, std::align_val_t,
+                                            const std::nothrow_t &) noexcept
+{
+   allocTrackerDetail::deallocate(p);
+}
+ALLOC_TRACKER_NOINLINE void operator delete[](void * p, std::align_val_t,
+                                              const std::nothrow_t &) noexcept
+{
+   allocTrackerDetail::deallocate(p);
+}
+
+#endif // TRACK_ALLOCATIONS
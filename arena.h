@@ -0,0 +1,185 @@
+/***********************************************************************
+ * Header:
+ *    ARENA
+ * Summary:
+ *    A bump-pointer arena for containers that are built once, used,
+ *    and thrown away together. Allocating is moving a pointer forward;
+ *    freeing one node does nothing; release() gives everything back
+ *    at once.
+ *
+ *    This will contain the class definition of:
+ *        arena              : The blocks of memory and the bump pointer
+ *        arena_allocator<T> : An allocator drawing from one arena
+ *
+ *    An arena can start on a buffer the caller provides, such as one
+ *    on the stack. Until that buffer is used up it never calls malloc().
+ *    After that it takes blocks from operator new, each twice as big
+ *    as the last.
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>     // for std::size_t
+#include <cstdint>     // for std::uintptr_t
+#include <new>         // for ::operator new
+#include <type_traits> // for std::true_type
+
+namespace custom
+{
+
+/**************************************************
+ * ARENA
+ * Memory handed out front to back and taken back all at once
+ **************************************************/
+class arena
+{
+public:
+   //
+   // Construct
+   //
+
+   // take blocks from operator new, starting with this many bytes
+   explicit arena(std::size_t blockSize = 4096) :
+      pBuffer(nullptr), sizeBuffer(0), sizeNext(blockSize),
+      pCurrent(nullptr), pEnd(nullptr), pBlocks(nullptr), numUsed(0)
+   {
+   }
+
+   // use the caller's buffer first; it must outlive the arena
+   arena(void * buffer, std::size_t size) :
+      pBuffer(static_cast<char *>(buffer)), sizeBuffer(size), sizeNext(size ? size : 4096),
+      pCurrent(pBuffer), pEnd(pBuffer + size), pBlocks(nullptr), numUsed(0)
+   {
+   }
+
+   arena(const arena & rhs) = delete;
+   arena & operator = (const arena & rhs) = delete;
+  ~arena()
+   {
+      release();
+   }
+
+   //
+   // Allocate
+   //
+
+   // size bytes aligned to align, which is a power of two
+   void * allocate(std::size_t size, std::size_t align = alignof(std::max_align_t))
+   {
+      char * p = alignUp(pCurrent, align);
+      if (nullptr == pCurrent || p + size > pEnd)
+      {
+         grow(size + align);
+         p = alignUp(pCurrent, align);
+      }
+      pCurrent = p + size;
+      numUsed += size;
+      return p;
+   }
+
+   // free everything, keeping the caller's buffer for next time
+   void release() noexcept
+   {
+      while (pBlocks)
+      {
+         Block * p = pBlocks;
+         pBlocks = p->pNext;
+         ::operator delete(p);
+      }
+      pCurrent = pBuffer;
+      pEnd = pBuffer + sizeBuffer;
+      numUsed = 0;
+   }
+
+   //
+   // Status
+   //
+
+   // bytes handed out since the last release()
+   std::size_t used() const { return numUsed; }
+
+private:
+   // each block from operator new starts with a link to the one before
+   struct Block
+   {
+      Block * pNext;
+   };
+
+   static char * alignUp(char * p, std::size_t align) noexcept
+   {
+      std::uintptr_t n = reinterpret_cast<std::uintptr_t>(p);
+      return reinterpret_cast<char *>((n + align - 1) & ~std::uintptr_t(align - 1));
+   }
+
+   // start a new block with room for at least size bytes
+   void grow(std::size_t size)
+   {
+      std::size_t sizeBlock = sizeNext > size ? sizeNext : size;
+      sizeNext = sizeBlock * 2;
+
+      char * p = static_cast<char *>(::operator new(sizeof(Block) + sizeBlock));
+      Block * pBlock = reinterpret_cast<Block *>(p);
+      pBlock->pNext = pBlocks;
+      pBlocks = pBlock;
+
+      pCurrent = p + sizeof(Block);
+      pEnd = pCurrent + sizeBlock;
+   }
+
+   char * pBuffer;          // the caller's buffer, if any
+   std::size_t sizeBuffer;  // its size
+   std::size_t sizeNext;    // the size of the next block from operator new
+   char * pCurrent;         // the next free byte
+   char * pEnd;             // one past the end of the current block
+   Block * pBlocks;         // the blocks from operator new, newest first
+   std::size_t numUsed;     // bytes handed out
+};
+
+/**************************************************
+ * ARENA ALLOCATOR
+ * Draws from one arena. Deallocate does nothing; the memory
+ * comes back when the arena is released. Containers see
+ * is_monotonic and skip freeing nodes one at a time.
+ **************************************************/
+template <typename T>
+class arena_allocator
+{
+public:
+   typedef T value_type;
+   typedef std::true_type is_monotonic;
+
+   // the arena follows the data when a container is moved or swapped
+   typedef std::true_type propagate_on_container_move_assignment;
+   typedef std::true_type propagate_on_container_swap;
+
+   arena_allocator(arena & a) noexcept : pArena(&a) {}
+   template <class U>
+   arena_allocator(const arena_allocator<U> & rhs) noexcept : pArena(rhs.pArena) {}
+
+   T * allocate(std::size_t n)
+   {
+      return static_cast<T *>(pArena->allocate(n * sizeof(T), alignof(T)));
+   }
+
+   void deallocate(T *, std::size_t) noexcept
+   {
+   }
+
+   arena * pArena;   // where the memory comes from
+};
+
+// two allocators are the same when they share an arena
+template <class T, class U>
+bool operator == (const arena_allocator<T> & lhs, const arena_allocator<U> & rhs) noexcept
+{
+   return lhs.pArena == rhs.pArena;
+}
+template <class T, class U>
+bool operator != (const arena_allocator<T> & lhs, const arena_allocator<U> & rhs) noexcept
+{
+   return lhs.pArena != rhs.pArena;
+}
+
+} // namespace custom
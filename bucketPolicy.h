@@ -0,0 +1,84 @@
+/***********************************************************************
+ * Header:
+ *    BUCKET POLICY
+ * Summary:
+ *    How a hash table turns a hash into a bucket index. Each policy
+ *    fixes the number of buckets at compile time and maps a hash onto
+ *    [0, count) without a run-time division.
+ *
+ *    This will contain:
+ *        bucket_modulo<N>    : hash % N, N known to the compiler
+ *        bucket_fibonacci<B> : 2^B buckets from the top bits of
+ *                              hash * 2^64 / phi
+ *        bucket_fastrange<N> : Lemire's multiply and shift onto N
+ *
+ *    A % by a variable is a 64-bit divide, 20 to 40 cycles on every
+ *    insert, find and erase. A % by a constant is turned into a
+ *    multiply by its reciprocal and a shift by the compiler, so
+ *    bucket_modulo keeps prime counts cheap. The other two are a
+ *    single multiply. Because std::hash of an integer is the integer
+ *    itself, both first multiply by the golden ratio so the low bits
+ *    of the key reach the high bits they read.
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>     // for std::size_t
+#include <cstdint>     // for std::uint64_t
+
+namespace custom
+{
+
+/**************************************************
+ * BUCKET MODULO
+ * The remainder by a constant count
+ **************************************************/
+template <std::size_t N>
+struct bucket_modulo
+{
+   static_assert(N > 0, "a hash needs at least one bucket");
+   static const std::size_t count = N;
+   static std::size_t index(std::size_t hash)
+   {
+      return hash % N;
+   }
+};
+
+/**************************************************
+ * BUCKET FIBONACCI
+ * 2^BITS buckets: the top BITS bits of the hash
+ * times 2^64 divided by the golden ratio
+ **************************************************/
+template <unsigned int BITS>
+struct bucket_fibonacci
+{
+   static_assert(BITS > 0 && BITS < 64, "between 2 and 2^63 buckets");
+   static const std::size_t count = std::size_t(1) << BITS;
+   static std::size_t index(std::size_t hash)
+   {
+      return static_cast<std::size_t>(
+         (static_cast<std::uint64_t>(hash) * 11400714819323198485ull) >> (64 - BITS));
+   }
+};
+
+/**************************************************
+ * BUCKET FAST RANGE
+ * Any count: the top 32 bits of the scrambled hash
+ * are a fraction of 2^32, scaled up to N
+ **************************************************/
+template <std::size_t N>
+struct bucket_fastrange
+{
+   static_assert(N > 0 && N <= 0xFFFFFFFFu, "between 1 and 2^32 - 1 buckets");
+   static const std::size_t count = N;
+   static std::size_t index(std::size_t hash)
+   {
+      std::uint64_t fraction =
+         (static_cast<std::uint64_t>(hash) * 11400714819323198485ull) >> 32;
+      return static_cast<std::size_t>((fraction * N) >> 32);
+   }
+};
+
+} // namespace custom
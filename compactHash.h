@@ -0,0 +1,542 @@
+/***********************************************************************
+ * Header:
+ *    COMPACT HASH
+ * Summary:
+ *    An unordered set laid out the way std::unordered_set is: every
+ *    element is on one singly linked chain, and each bucket is a single
+ *    pointer to the node just before its first element. A bucket of
+ *    custom::unordered_set is a whole custom::list, with a size, a head
+ *    and a tail, and each of its nodes has two links. Here a node is one
+ *    link and the data, so an 8-byte key costs 16 bytes plus its share
+ *    of the bucket array.
+ *
+ *    This will contain the class definition of:
+ *        compact_unordered_set                 : The set itself
+ *        compact_unordered_set::iterator       : Forward through every element
+ *        compact_unordered_set::local_iterator : Forward through one bucket
+ *
+ *    The chain is walked only forward. The node before a bucket's first
+ *    element is what the bucket points to, so inserting at the front of a
+ *    bucket and erasing its first element are both O(1). The first bucket
+ *    on the chain points to beforeBegin, a link that lives in the set.
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>     // for std::size_t
+#include <memory>      // for std::allocator_traits
+#include <functional>  // for std::hash
+#include <utility>     // for std::move
+#include "pair.h"      // for the return value of insert()
+
+class TestCompactHash;     // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * COMPACT UNORDERED SET
+ * A set implemented as a hash with singly linked chains.
+ * The bucket array doubles when there are more elements
+ * than buckets. An empty set may have no bucket array
+ * yet; then bucket() is 0 and every bucket is empty.
+ ************************************************/
+template <typename T, typename Hash = std::hash<T>, typename A = std::allocator<T>>
+class compact_unordered_set
+{
+   friend class ::TestCompactHash;   // give unit tests access to the privates
+
+   struct NodeBase;
+   struct Node;
+   typedef typename std::allocator_traits<A>::template rebind_alloc<Node> NodeAlloc;
+   typedef std::allocator_traits<NodeAlloc> NodeTraits;
+   typedef typename std::allocator_traits<A>::template rebind_alloc<NodeBase *> BucketAlloc;
+   typedef std::allocator_traits<BucketAlloc> BucketTraits;
+
+public:
+   //
+   // Construct
+   //
+   compact_unordered_set() : buckets(nullptr), numBuckets(0), numElements(0)
+   {
+      beforeBegin.pNext = nullptr;
+   }
+   explicit compact_unordered_set(const A & a) :
+      buckets(nullptr), numBuckets(0), numElements(0), nodeAlloc(a)
+   {
+      beforeBegin.pNext = nullptr;
+   }
+   compact_unordered_set(const compact_unordered_set & rhs) :
+      buckets(nullptr), numBuckets(0), numElements(0),
+      nodeAlloc(NodeTraits::select_on_container_copy_construction(rhs.nodeAlloc))
+   {
+      beforeBegin.pNext = nullptr;
+      *this = rhs;
+   }
+   compact_unordered_set(compact_unordered_set && rhs) :
+      buckets(nullptr), numBuckets(0), numElements(0), nodeAlloc(std::move(rhs.nodeAlloc))
+   {
+      beforeBegin.pNext = nullptr;
+      steal(rhs);
+   }
+   template <class Iterator>
+   compact_unordered_set(Iterator first, Iterator last) :
+      buckets(nullptr), numBuckets(0), numElements(0)
+   {
+      beforeBegin.pNext = nullptr;
+      for (; first != last; ++first)
+         insert(*first);
+   }
+   compact_unordered_set(const std::initializer_list<T> & il) :
+      buckets(nullptr), numBuckets(0), numElements(0)
+   {
+      beforeBegin.pNext = nullptr;
+      insert(il);
+   }
+  ~compact_unordered_set()
+   {
+      clear();
+      freeBuckets();
+   }
+
+   //
+   // Assign
+   //
+   compact_unordered_set & operator = (const compact_unordered_set & rhs)
+   {
+      if (this != &rhs)
+      {
+         clear();
+         reserve(rhs.numElements);
+         for (NodeBase * p = rhs.beforeBegin.pNext; p; p = p->pNext)
+            insert(static_cast<Node *>(p)->data);
+      }
+      return *this;
+   }
+   compact_unordered_set & operator = (compact_unordered_set && rhs)
+   {
+      clear();
+
+      // nodes from another allocator cannot be stolen, only their data
+      if (!NodeTraits::propagate_on_container_move_assignment::value &&
+          !(nodeAlloc == rhs.nodeAlloc))
+      {
+         reserve(rhs.numElements);
+         for (NodeBase * p = rhs.beforeBegin.pNext; p; p = p->pNext)
+            insert(std::move(static_cast<Node *>(p)->data));
+         rhs.clear();
+         return *this;
+      }
+
+      freeBuckets();
+      moveAllocator(rhs.nodeAlloc, typename NodeTraits::propagate_on_container_move_assignment());
+      steal(rhs);
+      return *this;
+   }
+   compact_unordered_set & operator = (const std::initializer_list<T> & il)
+   {
+      clear();
+      insert(il);
+      return *this;
+   }
+   void swap(compact_unordered_set & rhs)
+   {
+      compact_unordered_set temp(std::move(*this));
+      *this = std::move(rhs);
+      rhs = std::move(temp);
+   }
+
+   //
+   // Iterator
+   //
+   class iterator;
+   class local_iterator;
+   iterator begin() const { return iterator(beforeBegin.pNext); }
+   iterator end()   const { return iterator(nullptr); }
+   local_iterator begin(size_t iBucket) const
+   {
+      NodeBase * pBefore = numBuckets ? buckets[iBucket] : nullptr;
+      return local_iterator(pBefore ? pBefore->pNext : nullptr, iBucket, numBuckets);
+   }
+   local_iterator end(size_t iBucket) const
+   {
+      return local_iterator(nullptr, iBucket, numBuckets);
+   }
+
+   //
+   // Access
+   //
+   size_t bucket(const T & t) const
+   {
+      return numBuckets ? Hash()(t) % numBuckets : 0;
+   }
+   iterator find(const T & t) const
+   {
+      NodeBase * pBefore = findBefore(t);
+      return iterator(pBefore ? pBefore->pNext : nullptr);
+   }
+
+   //
+   // Insert
+   //
+   custom::pair<iterator, bool> insert(const T & t)
+   {
+      return emplaceNode(t);
+   }
+   custom::pair<iterator, bool> insert(T && t)
+   {
+      return emplaceNode(std::move(t));
+   }
+   void insert(const std::initializer_list<T> & il)
+   {
+      reserve(numElements + il.size());
+      for (auto & t : il)
+         insert(t);
+   }
+   void reserve(size_t num)
+   {
+      if (num > numBuckets)
+         rehash(num < 10 ? 10 : num);
+   }
+   void rehash(size_t num);
+
+   //
+   // Remove
+   //
+   void clear() noexcept
+   {
+      NodeBase * p = beforeBegin.pNext;
+      while (p)
+      {
+         NodeBase * pNext = p->pNext;
+         freeNode(static_cast<Node *>(p));
+         p = pNext;
+      }
+      beforeBegin.pNext = nullptr;
+      for (size_t i = 0; i < numBuckets; i++)
+         buckets[i] = nullptr;
+      numElements = 0;
+   }
+   iterator erase(const T & t);
+
+   //
+   // Status
+   //
+   size_t size()         const { return numElements; }
+   bool   empty()        const { return numElements == 0; }
+   size_t bucket_count() const { return numBuckets; }
+   size_t bucket_size(size_t i) const
+   {
+      size_t num = 0;
+      for (local_iterator it = begin(i); it != end(i); ++it)
+         num++;
+      return num;
+   }
+   A get_allocator() const { return A(nodeAlloc); }
+
+private:
+   // a link in the chain. beforeBegin is one of these without data
+   struct NodeBase
+   {
+      NodeBase * pNext;
+   };
+   struct Node : NodeBase
+   {
+      template <class U>
+      Node(U && data) : data(std::forward<U>(data)) { this->pNext = nullptr; }
+      T data;
+   };
+
+   // which bucket does this node hash to?
+   size_t bucketOf(NodeBase * p) const
+   {
+      return Hash()(static_cast<Node *>(p)->data) % numBuckets;
+   }
+
+   // the node before t, or nullptr if t is not here
+   NodeBase * findBefore(const T & t) const;
+
+   // put t in the set unless it is already there
+   template <class U>
+   custom::pair<iterator, bool> emplaceNode(U && t);
+
+   // link a node in at the front of bucket i
+   void linkFront(size_t i, NodeBase * p)
+   {
+      if (buckets[i])
+      {
+         p->pNext = buckets[i]->pNext;
+         buckets[i]->pNext = p;
+      }
+      else
+      {
+         // a new bucket goes at the front of the whole chain
+         p->pNext = beforeBegin.pNext;
+         beforeBegin.pNext = p;
+         if (p->pNext)
+            buckets[bucketOf(p->pNext)] = p;
+         buckets[i] = &beforeBegin;
+      }
+   }
+
+   // take everything rhs has
+   void steal(compact_unordered_set & rhs)
+   {
+      buckets = rhs.buckets;
+      numBuckets = rhs.numBuckets;
+      numElements = rhs.numElements;
+      beforeBegin.pNext = rhs.beforeBegin.pNext;
+      if (beforeBegin.pNext)
+         buckets[bucketOf(beforeBegin.pNext)] = &beforeBegin;
+
+      rhs.buckets = nullptr;
+      rhs.numBuckets = 0;
+      rhs.numElements = 0;
+      rhs.beforeBegin.pNext = nullptr;
+   }
+
+   template <class U>
+   Node * allocateNode(U && data)
+   {
+      Node * p = NodeTraits::allocate(nodeAlloc, 1);
+      try
+      {
+         NodeTraits::construct(nodeAlloc, p, std::forward<U>(data));
+      }
+      catch (...)
+      {
+         NodeTraits::deallocate(nodeAlloc, p, 1);
+         throw;
+      }
+      return p;
+   }
+   void freeNode(Node * p)
+   {
+      NodeTraits::destroy(nodeAlloc, p);
+      NodeTraits::deallocate(nodeAlloc, p, 1);
+   }
+   void freeBuckets()
+   {
+      if (buckets)
+      {
+         BucketAlloc bucketAlloc(nodeAlloc);
+         BucketTraits::deallocate(bucketAlloc, buckets, numBuckets);
+      }
+      buckets = nullptr;
+      numBuckets = 0;
+   }
+
+   // the allocator follows the nodes only when it says it should
+   void moveAllocator(NodeAlloc & rhs, std::true_type) { nodeAlloc = std::move(rhs); }
+   void moveAllocator(NodeAlloc &,     std::false_type) { }
+
+   NodeBase ** buckets;    // the node before each bucket's first, or nullptr
+   size_t numBuckets;      // the size of buckets
+   size_t numElements;     // the number of elements in the set
+   NodeBase beforeBegin;   // the link in front of the first node
+   NodeAlloc nodeAlloc;    // where the nodes and buckets come from
+};
+
+
+/************************************************
+ * COMPACT UNORDERED SET ITERATOR
+ * Every element on the chain, in chain order
+ ************************************************/
+template <typename T, typename Hash, typename A>
+class compact_unordered_set <T, Hash, A> ::iterator
+{
+   friend class ::TestCompactHash;   // give unit tests access to the privates
+   friend class compact_unordered_set;
+public:
+   iterator() : p(nullptr) {}
+   iterator(NodeBase * p) : p(p) {}
+
+   bool operator != (const iterator & rhs) const { return p != rhs.p; }
+   bool operator == (const iterator & rhs) const { return p == rhs.p; }
+
+   T & operator * () { return static_cast<Node *>(p)->data; }
+
+   iterator & operator ++ ()
+   {
+      p = p->pNext;
+      return *this;
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator tmp(*this);
+      p = p->pNext;
+      return tmp;
+   }
+
+private:
+   NodeBase * p;
+};
+
+
+/************************************************
+ * COMPACT UNORDERED SET LOCAL ITERATOR
+ * The elements of one bucket. They sit together on the
+ * chain, so this stops at the first node from another bucket.
+ ************************************************/
+template <typename T, typename Hash, typename A>
+class compact_unordered_set <T, Hash, A> ::local_iterator
+{
+   friend class ::TestCompactHash;   // give unit tests access to the privates
+   friend class compact_unordered_set;
+public:
+   local_iterator() : p(nullptr), iBucket(0), numBuckets(0) {}
+   local_iterator(NodeBase * p, size_t iBucket, size_t numBuckets) :
+      p(p), iBucket(iBucket), numBuckets(numBuckets) {}
+
+   bool operator != (const local_iterator & rhs) const { return p != rhs.p; }
+   bool operator == (const local_iterator & rhs) const { return p == rhs.p; }
+
+   T & operator * () { return static_cast<Node *>(p)->data; }
+
+   local_iterator & operator ++ ()
+   {
+      p = p->pNext;
+      if (p && Hash()(static_cast<Node *>(p)->data) % numBuckets != iBucket)
+         p = nullptr;
+      return *this;
+   }
+   local_iterator operator ++ (int postfix)
+   {
+      local_iterator tmp(*this);
+      ++(*this);
+      return tmp;
+   }
+
+private:
+   NodeBase * p;
+   size_t iBucket;
+   size_t numBuckets;
+};
+
+
+/*****************************************
+ * COMPACT UNORDERED SET :: FIND BEFORE
+ * Walk t's bucket looking for it, keeping the node behind
+ ****************************************/
+template <typename T, typename Hash, typename A>
+typename compact_unordered_set <T, Hash, A> ::NodeBase *
+compact_unordered_set <T, Hash, A> ::findBefore(const T & t) const
+{
+   if (numElements == 0 || numBuckets == 0)
+      return nullptr;
+
+   size_t i = bucket(t);
+   NodeBase * pBefore = buckets[i];
+   if (nullptr == pBefore)
+      return nullptr;
+
+   for (NodeBase * p = pBefore->pNext; p && bucketOf(p) == i; pBefore = p, p = p->pNext)
+      if (static_cast<Node *>(p)->data == t)
+         return pBefore;
+   return nullptr;
+}
+
+/*****************************************
+ * COMPACT UNORDERED SET :: EMPLACE NODE
+ * Insert t at the front of its bucket, growing first
+ * if there would be more elements than buckets
+ ****************************************/
+template <typename T, typename Hash, typename A>
+template <class U>
+custom::pair<typename compact_unordered_set <T, Hash, A> ::iterator, bool>
+compact_unordered_set <T, Hash, A> ::emplaceNode(U && t)
+{
+   NodeBase * pBefore = findBefore(t);
+   if (pBefore)
+      return custom::pair<iterator, bool>(iterator(pBefore->pNext), false);
+
+   if (numElements + 1 > numBuckets)
+      rehash(numBuckets < 10 ? 10 : numBuckets * 2);
+
+   Node * pNode = allocateNode(std::forward<U>(t));
+   linkFront(bucketOf(pNode), pNode);
+   numElements++;
+   return custom::pair<iterator, bool>(iterator(pNode), true);
+}
+
+/*****************************************
+ * COMPACT UNORDERED SET :: ERASE
+ * Unlink t from the chain and fix the buckets
+ * it was the boundary of
+ ****************************************/
+template <typename T, typename Hash, typename A>
+typename compact_unordered_set <T, Hash, A> ::iterator
+compact_unordered_set <T, Hash, A> ::erase(const T & t)
+{
+   NodeBase * pBefore = findBefore(t);
+   if (nullptr == pBefore)
+      return end();
+
+   NodeBase * p = pBefore->pNext;
+   NodeBase * pNext = p->pNext;
+   size_t i = bucketOf(p);
+   size_t iNext = pNext ? bucketOf(pNext) : i;
+
+   if (pBefore == buckets[i])
+   {
+      // p was the first in its bucket and maybe the only one
+      if (nullptr == pNext || iNext != i)
+      {
+         if (pNext)
+            buckets[iNext] = buckets[i];
+         buckets[i] = nullptr;
+      }
+   }
+   else if (pNext && iNext != i)
+      // p was the last in its bucket: the next bucket now follows pBefore
+      buckets[iNext] = pBefore;
+
+   pBefore->pNext = pNext;
+   freeNode(static_cast<Node *>(p));
+   numElements--;
+   return iterator(pNext);
+}
+
+/*****************************************
+ * COMPACT UNORDERED SET :: REHASH
+ * Move to num buckets, relinking every node
+ * without moving or copying its data
+ ****************************************/
+template <typename T, typename Hash, typename A>
+void compact_unordered_set <T, Hash, A> ::rehash(size_t num)
+{
+   if (num <= numBuckets)
+      return;
+
+   BucketAlloc bucketAlloc(nodeAlloc);
+   NodeBase ** bucketsNew = BucketTraits::allocate(bucketAlloc, num);
+   for (size_t i = 0; i < num; i++)
+      bucketsNew[i] = nullptr;
+
+   NodeBase * p = beforeBegin.pNext;
+   freeBuckets();
+   buckets = bucketsNew;
+   numBuckets = num;
+   beforeBegin.pNext = nullptr;
+
+   while (p)
+   {
+      NodeBase * pNext = p->pNext;
+      linkFront(bucketOf(p), p);
+      p = pNext;
+   }
+}
+
+/*****************************************
+ * SWAP
+ * Stand-alone compact unordered set swap
+ ****************************************/
+template <typename T, typename Hash, typename A>
+void swap(compact_unordered_set <T, Hash, A> & lhs, compact_unordered_set <T, Hash, A> & rhs)
+{
+   lhs.swap(rhs);
+}
+
+} // namespace custom
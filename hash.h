@@ -19,10 +19,15 @@
 
 #pragma once
 
-#include "list.h"     // because this->buckets[0] is a list
-#include <memory>     // for std::allocator
-#include <functional> // for std::hash
-#include <cmath>      // for std::ceil
+#include "list.h"         // because this->buckets[0] is a list
+#include "pair.h"         // for the return value of insert()
+#include "bucketPolicy.h" // for bucket_modulo
+#include "simd.h"         // for simd::find over the small elements
+#include <memory>         // for std::allocator
+#include <functional>     // for std::hash
+#include <cmath>          // for std::ceil
+#include <new>            // for placement new
+#include <utility>        // for std::move
    
 
 class TestHash;             // forward declaration for Hash unit tests
@@ -30,10 +35,40 @@ class TestHash;             // forward declaration for Hash unit tests
 namespace custom
 {
 /************************************************
- * UNORDERED SET
- * A set implemented as a hash
+ * SMALL STORAGE
+ * Raw, aligned room for N elements of T inside the
+ * set. A set with no small mode has none.
  ************************************************/
+template <typename T, std::size_t N>
+struct small_storage
+{
+   T * data() { return reinterpret_cast<T *>(bytes); }
+   const T * data() const { return reinterpret_cast<const T *>(bytes); }
+   alignas(T) unsigned char bytes[N * sizeof(T)];
+};
+
 template <typename T>
+struct small_storage <T, 0>
+{
+   T * data() { return nullptr; }
+   const T * data() const { return nullptr; }
+};
+
+/************************************************
+ * UNORDERED SET
+ * A set implemented as a hash. The elements are hashed with
+ * the set's own copy of Hash, so a seeded_hash gives each set
+ * its own seed. The bucket nodes come from the allocator A, and
+ * Buckets says how many buckets there are and which one
+ * a hash falls in.
+ *
+ * With SmallN above zero, the first SmallN elements are kept
+ * in a flat array inside the set and found by a linear search,
+ * SIMD for integers. Only the insert that would make SmallN + 1
+ * moves them into the buckets. A small set allocates nothing.
+ ************************************************/
+template <typename T, typename Hash = std::hash<T>, typename A = std::allocator<T>,
+          typename Buckets = bucket_modulo<10>, std::size_t SmallN = 0>
 class unordered_set
 {
    friend class ::TestHash;   // give unit tests access to the privates
@@ -43,19 +78,38 @@ public:
    //
    unordered_set() : numElements(0)
    {
+      constructBuckets(A());
    }
-   unordered_set(unordered_set&  rhs) // copy construct
+   explicit unordered_set(const A & a) : // every bucket draws from a
+      unordered_set(Hash(), a)
+   {
+   }
+   explicit unordered_set(const Hash & hash, const A & a = A()) : // hash with this one
+      numElements(0), hasher(hash)
+   {
+      constructBuckets(a);
+   }
+   unordered_set(const unordered_set& rhs) : // copy construct, asking rhs's allocator for ours
+      unordered_set(rhs.hasher,
+                    std::allocator_traits<A>::select_on_container_copy_construction(rhs.get_allocator()))
    {
       *this = rhs;
    }
-   unordered_set(unordered_set&& rhs) // move construct 
+   unordered_set(unordered_set&& rhs) : // move construct, taking over rhs's allocator
+      unordered_set(rhs.hasher, rhs.get_allocator())
    {
       *this = std::move(rhs);
    }
+   ~unordered_set()
+   {
+      destroySmall();
+      destroyBuckets(bucket_count());
+   }
 
    template <class Iterator>
    unordered_set(Iterator first, Iterator last) : numElements(0) // iterator constructor 
    {
+      constructBuckets(A());
       while (first != last)
       {
          insert(*first);
@@ -66,23 +120,46 @@ public:
    //
    // Assign
    //
-   unordered_set& operator=(unordered_set& rhs)
+   unordered_set& operator=(const unordered_set& rhs)
    {
+      // s = s would destroy the small elements before copying them
+      if (this == &rhs)
+         return *this;
+
+      // copy the small elements, if rhs is still small
+      destroySmall();
+      for (size_t i = 0; i < rhs.numSmall(); i++)
+         new (small.data() + i) T(rhs.small.data()[i]);
+      isSmall = rhs.isSmall;
+
       numElements = rhs.numElements;
+      hasher = rhs.hasher; // the elements are where rhs's hash put them
 
       // copy assign each element from rhs 
-      for (size_t i = 0; i < 10; i++)
+      for (size_t i = 0; i < bucket_count(); i++)
          buckets[i] = rhs.buckets[i];
 
       return *this;
    }
    unordered_set& operator=(unordered_set&& rhs)
    {
+      if (this == &rhs)
+         return *this;
+
+      // the small elements live inside rhs, so they are moved one by one
+      destroySmall();
+      for (size_t i = 0; i < rhs.numSmall(); i++)
+         new (small.data() + i) T(std::move(rhs.small.data()[i]));
+      isSmall = rhs.isSmall;
+      rhs.destroySmall();
+      rhs.isSmall = SmallN > 0;
+
       numElements = 0;
       std::swap(numElements, rhs.numElements); // now rhs.numElements = 0 
+      hasher = rhs.hasher;
 
       // move assign each element from rhs 
-      for (size_t i = 0; i < 10; i++)
+      for (size_t i = 0; i < bucket_count(); i++)
          buckets[i] = std::move(rhs.buckets[i]);
 
       return *this;
@@ -100,10 +177,12 @@ public:
    }
    void swap(unordered_set& rhs)
    {
+      swapSmall(rhs);
       std::swap(numElements, rhs.numElements);
+      std::swap(hasher, rhs.hasher);
 
       // swap buckets 
-      for (size_t i = 0; i < 10; i++)
+      for (size_t i = 0; i < bucket_count(); i++)
          std::swap(buckets[i], rhs.buckets[i]);
    }
 
@@ -116,15 +195,19 @@ public:
    class local_iterator;
    iterator begin()
    {
+      // a small set starts at its first small element
+      if (isSmall)
+         return numElements ? iterator(small.data(), small.data() + numElements, &buckets[bucket_count()]) : end();
+
       // look for first non empty
-      for (size_t i = 0; i < 10; i++)
+      for (size_t i = 0; i < bucket_count(); i++)
       {
          if (!buckets[i].empty())
          {
             // return begin()
             return iterator(
                &buckets[i],       // list<T>* pBucket
-               &buckets[10],       // list<T>* pBucketEnd
+               &buckets[bucket_count()], // list<T>* pBucketEnd
                buckets[i].begin() // list<T>::iterator itList
             );
          }
@@ -134,7 +217,7 @@ public:
    }
    iterator end()
    {
-      return iterator(&buckets[10], &buckets[10], buckets[0].end());
+      return iterator(&buckets[bucket_count()], &buckets[bucket_count()], buckets[0].end());
    }
    local_iterator begin(size_t iBucket)
    {
@@ -151,8 +234,8 @@ public:
    size_t bucket(const T& t)
    {
        // calculate the index of the bucket for the element t 
-       // hash t then % the number of buckets 
-      return std::hash<T>{}(t) % bucket_count();
+       // hash t then let the policy pick the bucket 
+      return Buckets::index(hasher(t));
    }
 
    iterator find(const T& t);
@@ -169,6 +252,10 @@ public:
    //
    void clear() noexcept
    {
+      // a cleared set is small again
+      destroySmall();
+      isSmall = SmallN > 0;
+
        // clear each bucket 
       for (size_t i = 0; i < bucket_count(); ++i)
          buckets[i].clear();
@@ -192,18 +279,77 @@ public:
    }
    size_t bucket_count() const 
    { 
-      return 10; // see below, there are 10 buckets 
+      return Buckets::count; // see below, fixed by the policy 
+   }
+   bool is_small() const
+   {
+      // the elements are in the flat array, not the buckets
+      return isSmall;
    }
    size_t bucket_size(size_t i) const
    {
        // size of the specified bucket 
       return buckets[i].size();
    }
+   Hash hash_function() const
+   {
+      return hasher;
+   }
+   A get_allocator() const
+   {
+      return buckets[0].get_allocator();
+   }
 
 private:
+   typedef custom::list<T, A> Bucket;
 
-   custom::list<T> buckets [10];   // exactly 10 buckets
+   // room for the buckets, built and destroyed one at a time in a loop
+   // so the compiler never sees a list of Buckets::count initializers
+   class BucketArray
+   {
+   public:
+      operator       Bucket * ()       { return reinterpret_cast<      Bucket *>(storage); }
+      operator const Bucket * () const { return reinterpret_cast<const Bucket *>(storage); }
+   private:
+      alignas(Bucket) unsigned char storage[sizeof(Bucket) * Buckets::count];
+   };
+
+   // give each bucket its own copy of a
+   void constructBuckets(const A & a)
+   {
+      size_t i = 0;
+      try
+      {
+         for (; i < bucket_count(); i++)
+            new (buckets + i) Bucket(a);
+      }
+      catch (...)
+      {
+         destroyBuckets(i);
+         throw;
+      }
+   }
+   void destroyBuckets(size_t num)
+   {
+      for (size_t i = 0; i < num; i++)
+         buckets[i].~Bucket();
+   }
+
+   // the elements in the small array: all of them, or none once spilled
+   size_t numSmall() const { return isSmall ? numElements : 0; }
+   void destroySmall()
+   {
+      for (size_t i = 0; i < numSmall(); i++)
+         small.data()[i].~T();
+   }
+   void swapSmall(unordered_set & rhs);
+   void spill();
+
+   BucketArray buckets;            // exactly Buckets::count buckets
    int numElements;                // number of elements in the Hash
+   Hash hasher;                    // may carry state, such as a seed
+   small_storage<T, SmallN> small; // the first SmallN elements
+   bool isSmall = SmallN > 0;      // are they still in small?
 };
 
 
@@ -211,25 +357,31 @@ private:
  * UNORDERED SET ITERATOR
  * Iterator for an unordered set
  ************************************************/
-template <typename T>
-class unordered_set <T> ::iterator
+template <typename T, typename Hash, typename A, typename Buckets, std::size_t SmallN>
+class unordered_set <T, Hash, A, Buckets, SmallN> ::iterator
 {
    friend class ::TestHash;   // give unit tests access to the privates
-   template <class TT>
+   template <class TT, class HH, class AA, class BB, std::size_t NN>
    friend class custom::unordered_set;
 public:
    // 
    // Construct
    //
-   iterator() : pBucket(nullptr), pBucketEnd(nullptr), itList()
+   iterator() : pBucket(nullptr), pBucketEnd(nullptr), itList(), pSmall(nullptr), pSmallEnd(nullptr)
    {  
    }
-   iterator(typename custom::list<T>* pBucket,
-            typename custom::list<T>* pBucketEnd,
-            typename custom::list<T>::iterator itList) : pBucket(pBucket), pBucketEnd(pBucketEnd), itList(itList)
+   iterator(typename custom::list<T, A>* pBucket,
+            typename custom::list<T, A>* pBucketEnd,
+            typename custom::list<T, A>::iterator itList) : pBucket(pBucket), pBucketEnd(pBucketEnd), itList(itList),
+      pSmall(nullptr), pSmallEnd(nullptr)
    {
    }
-   iterator(const iterator& rhs) : pBucket(rhs.pBucket), pBucketEnd(rhs.pBucketEnd), itList(rhs.itList)
+   iterator(T* pSmall, T* pSmallEnd, typename custom::list<T, A>* pBucketEnd) :
+      pBucket(pBucketEnd), pBucketEnd(pBucketEnd), itList(), pSmall(pSmall), pSmallEnd(pSmallEnd)
+   {
+   }
+   iterator(const iterator& rhs) : pBucket(rhs.pBucket), pBucketEnd(rhs.pBucketEnd), itList(rhs.itList),
+      pSmall(rhs.pSmall), pSmallEnd(rhs.pSmallEnd)
    { 
    }
 
@@ -243,6 +395,8 @@ public:
          pBucket = rhs.pBucket;
          pBucketEnd = rhs.pBucketEnd;
          itList = rhs.itList;
+         pSmall = rhs.pSmall;
+         pSmallEnd = rhs.pSmallEnd;
       }
       return *this;
    }
@@ -253,12 +407,12 @@ public:
    bool operator != (const iterator& rhs) const 
    { 
        // not equals (returns true if anything is different) 
-      return pBucket != rhs.pBucket || itList != rhs.itList; 
+      return pBucket != rhs.pBucket || itList != rhs.itList || pSmall != rhs.pSmall; 
    }
    bool operator == (const iterator& rhs) const 
    { 
        // equals (returns true only if everything is same) 
-      return pBucket == rhs.pBucket && itList == rhs.itList; 
+      return pBucket == rhs.pBucket && itList == rhs.itList && pSmall == rhs.pSmall; 
    }
 
    // 
@@ -266,7 +420,7 @@ public:
    //
    T& operator * ()
    {
-      return *itList; // pointer 
+      return pSmall ? *pSmall : *itList; // pointer 
    }
 
    //
@@ -276,14 +430,19 @@ public:
    iterator operator ++ (int postfix)
    {
       auto tmp = *this;
-      itList++; // increment by 1 
+      if (pSmall)
+         ++(*this);
+      else
+         itList++; // increment by 1 
       return tmp; // return state before it was incremented 
    }
 
 private:
-   custom::list<T> *pBucket;
-   custom::list<T> *pBucketEnd;
-   typename list<T>::iterator itList;
+   custom::list<T, A> *pBucket;
+   custom::list<T, A> *pBucketEnd;
+   typename list<T, A>::iterator itList;
+   T *pSmall;                  // in a small set, the element; else nullptr
+   T *pSmallEnd;               // one past the last small element
 };
 
 
@@ -291,12 +450,12 @@ private:
  * UNORDERED SET LOCAL ITERATOR
  * Iterator for a single bucket in an unordered set
  ************************************************/
-template <typename T>
-class unordered_set <T> ::local_iterator
+template <typename T, typename Hash, typename A, typename Buckets, std::size_t SmallN>
+class unordered_set <T, Hash, A, Buckets, SmallN> ::local_iterator
 {
    friend class ::TestHash;   // give unit tests access to the privates
 
-   template <class TT>
+   template <class TT, class HH, class AA, class BB, std::size_t NN>
    friend class custom::unordered_set;
 public:
    // 
@@ -305,7 +464,7 @@ public:
    local_iterator() : itList()
    {
    }
-   local_iterator(const typename custom::list<T>::iterator& itList) : itList(itList)
+   local_iterator(const typename custom::list<T, A>::iterator& itList) : itList(itList)
    {
    }
    local_iterator(const local_iterator& rhs) : itList(rhs.itList)
@@ -363,7 +522,7 @@ public:
    }
 
 private:
-   typename custom::list<T>::iterator itList;
+   typename custom::list<T, A>::iterator itList;
 };
 
 
@@ -371,9 +530,25 @@ private:
  * UNORDERED SET :: ERASE
  * Remove one element from the unordered set
  ****************************************/
-template <typename T>
-typename unordered_set <T> ::iterator unordered_set<T>::erase(const T& t)
+template <typename T, typename Hash, typename A, typename Buckets, std::size_t SmallN>
+typename unordered_set <T, Hash, A, Buckets, SmallN> ::iterator unordered_set<T, Hash, A, Buckets, SmallN>::erase(const T& t)
 {
+    // a small set fills the hole with its last element
+    if (isSmall)
+    {
+        T * pSmall = small.data();
+        size_t i = simd::find(static_cast<const T *>(pSmall), size_t(numElements), t);
+        if (i == size_t(numElements))
+            return end();
+        numElements--;
+        if (i != size_t(numElements))
+            pSmall[i] = std::move(pSmall[numElements]);
+        pSmall[numElements].~T();
+        if (i == size_t(numElements))
+            return end();
+        return iterator(pSmall + i, pSmall + numElements, &buckets[bucket_count()]);
+    }
+
     size_t bucketIndex = bucket(t); // calculate bucket index for the element 
 
     // go thru every element in the bucket 
@@ -408,9 +583,27 @@ typename unordered_set <T> ::iterator unordered_set<T>::erase(const T& t)
  * UNORDERED SET :: INSERT
  * Insert one element into the hash
  ****************************************/
-template <typename T>
-custom::pair<typename custom::unordered_set<T>::iterator, bool> unordered_set<T>::insert(const T& t)
+template <typename T, typename Hash, typename A, typename Buckets, std::size_t SmallN>
+custom::pair<typename custom::unordered_set<T, Hash, A, Buckets, SmallN>::iterator, bool> unordered_set<T, Hash, A, Buckets, SmallN>::insert(const T& t)
 {
+    // a small set only needs its buckets once the array is full
+    if (isSmall)
+    {
+        T * pSmall = small.data();
+        size_t i = simd::find(static_cast<const T *>(pSmall), size_t(numElements), t);
+        if (i != size_t(numElements))
+            return custom::pair<iterator, bool>(
+                iterator(pSmall + i, pSmall + numElements, &buckets[bucket_count()]), false);
+        if (size_t(numElements) < SmallN)
+        {
+            new (pSmall + numElements) T(t);
+            numElements++;
+            return custom::pair<iterator, bool>(
+                iterator(pSmall + i, pSmall + numElements, &buckets[bucket_count()]), true);
+        }
+        spill();
+    }
+
 size_t bucketIndex = bucket(t); // Calculate bucket using the hash function
 
     for (const T& value : buckets[bucketIndex])
@@ -430,8 +623,8 @@ size_t bucketIndex = bucket(t); // Calculate bucket using the hash function
     return custom::pair<iterator, bool>(
         iterator(&buckets[bucketIndex], &buckets[bucket_count()], buckets[bucketIndex].begin()), true);
 }
-template <typename T>
-void unordered_set<T>::insert(const std::initializer_list<T> & il)
+template <typename T, typename Hash, typename A, typename Buckets, std::size_t SmallN>
+void unordered_set<T, Hash, A, Buckets, SmallN>::insert(const std::initializer_list<T> & il)
 {
 }
 
@@ -439,9 +632,19 @@ void unordered_set<T>::insert(const std::initializer_list<T> & il)
  * UNORDERED SET :: FIND
  * Find an element in an unordered set
  ****************************************/
-template <typename T>
-typename unordered_set<T>::iterator unordered_set<T>::find(const T& t)
+template <typename T, typename Hash, typename A, typename Buckets, std::size_t SmallN>
+typename unordered_set<T, Hash, A, Buckets, SmallN>::iterator unordered_set<T, Hash, A, Buckets, SmallN>::find(const T& t)
 {
+    // a small set is searched front to back, several at a time for integers
+    if (isSmall)
+    {
+        T * pSmall = small.data();
+        size_t i = simd::find(static_cast<const T *>(pSmall), size_t(numElements), t);
+        if (i == size_t(numElements))
+            return end();
+        return iterator(pSmall + i, pSmall + numElements, &buckets[bucket_count()]);
+    }
+
     size_t bucketIndex = bucket(t); // calculate bucket index for the element 
 
     // go thru every element in the bucket 
@@ -457,13 +660,67 @@ typename unordered_set<T>::iterator unordered_set<T>::find(const T& t)
 }
 
 
+/*****************************************
+ * UNORDERED SET :: SPILL
+ * The small array is full: move its elements into
+ * the buckets, where the set keeps them from now on
+ ****************************************/
+template <typename T, typename Hash, typename A, typename Buckets, std::size_t SmallN>
+void unordered_set<T, Hash, A, Buckets, SmallN>::spill()
+{
+    T * pSmall = small.data();
+    for (size_t i = 0; i < size_t(numElements); i++)
+        buckets[bucket(pSmall[i])].push_back(std::move(pSmall[i]));
+    destroySmall();
+    isSmall = false;
+}
+
+/*****************************************
+ * UNORDERED SET :: SWAP SMALL
+ * The small elements cannot trade places by pointer,
+ * so they are swapped one by one and the longer side
+ * moves its extra elements across
+ ****************************************/
+template <typename T, typename Hash, typename A, typename Buckets, std::size_t SmallN>
+void unordered_set<T, Hash, A, Buckets, SmallN>::swapSmall(unordered_set& rhs)
+{
+    size_t numLHS = numSmall();
+    size_t numRHS = rhs.numSmall();
+    T * pLHS = small.data();
+    T * pRHS = rhs.small.data();
+    size_t numBoth = numLHS < numRHS ? numLHS : numRHS;
+
+    using std::swap;
+    for (size_t i = 0; i < numBoth; i++)
+        swap(pLHS[i], pRHS[i]);
+    for (size_t i = numBoth; i < numLHS; i++)
+    {
+        new (pRHS + i) T(std::move(pLHS[i]));
+        pLHS[i].~T();
+    }
+    for (size_t i = numBoth; i < numRHS; i++)
+    {
+        new (pLHS + i) T(std::move(pRHS[i]));
+        pRHS[i].~T();
+    }
+    std::swap(isSmall, rhs.isSmall);
+}
+
 /*****************************************
  * UNORDERED SET :: ITERATOR :: INCREMENT
  * Advance by one element in an unordered set
  ****************************************/
-template <typename T>
-typename unordered_set<T>::iterator& unordered_set<T>::iterator::operator++()
+template <typename T, typename Hash, typename A, typename Buckets, std::size_t SmallN>
+typename unordered_set<T, Hash, A, Buckets, SmallN>::iterator& unordered_set<T, Hash, A, Buckets, SmallN>::iterator::operator++()
 {
+    // in a small set, past the last element is end()
+    if (pSmall)
+    {
+        if (++pSmall == pSmallEnd)
+            pSmall = nullptr;
+        return *this;
+    }
+
     if (itList != pBucket->end())
     {
         ++itList; // Advance within the current bucket
@@ -486,10 +743,24 @@ typename unordered_set<T>::iterator& unordered_set<T>::iterator::operator++()
  * SWAP
  * Stand-alone unordered set swap
  ****************************************/
-template <typename T>
-void swap(unordered_set<T>& lhs, unordered_set<T>& rhs)
+template <typename T, typename Hash, typename A, typename Buckets, std::size_t SmallN>
+void swap(unordered_set<T, Hash, A, Buckets, SmallN>& lhs, unordered_set<T, Hash, A, Buckets, SmallN>& rhs)
 {
    lhs.swap(rhs); // swappy swap 
 }
 
+#ifdef __cpp_lib_memory_resource
+namespace pmr
+{
+/************************************************
+ * PMR UNORDERED SET
+ * A set whose buckets draw from a std::pmr::memory_resource:
+ *    custom::pmr::unordered_set<int> us(&resource);
+ ************************************************/
+template <typename T, typename Hash = std::hash<T>, typename Buckets = bucket_modulo<10>,
+          std::size_t SmallN = 0>
+using unordered_set = custom::unordered_set<T, Hash, std::pmr::polymorphic_allocator<T>, Buckets, SmallN>;
+} // namespace pmr
+#endif // __cpp_lib_memory_resource
+
 }
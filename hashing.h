@@ -0,0 +1,248 @@
+/***********************************************************************
+ * Header:
+ *    HASHING
+ * Summary:
+ *    The pieces the containers use to hash themselves, so a pair,
+ *    vector or list can be a key in an unordered_set.
+ *
+ *    This will contain:
+ *        hash_mum     : The full 128-bit product of two 64-bit values
+ *        hash_mix     : Fold two 64-bit values into one, well mixed
+ *        hash_combine : Add the hash of one more value to a seed
+ *        hash_bytes   : Hash a run of bytes in one go (wyhash)
+ *        seeded_hash  : A std::hash replacement with a random key
+ *
+ *    std::hash of an int is the int itself, so combining hashes with
+ *    xor and shifts leaves most of the bits alone and fills a few
+ *    buckets. hash_mix multiplies the two values out to 128 bits and
+ *    folds the halves together, so every bit of the input moves every
+ *    bit of the output. hash_bytes reads eight bytes at a time and is
+ *    what a vector of plain numbers uses.
+ *
+ *    std::hash is the same in every run, so whoever picks the keys
+ *    can pick ones that all land in one bucket and make every find a
+ *    walk of the whole set. seeded_hash draws a new seed for each
+ *    object and hashes with it, so the keys that collide differ from
+ *    one set to the next and cannot be chosen ahead of time.
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>     // for std::size_t
+#include <cstdint>     // for std::uint64_t
+#include <cstring>     // for std::memcpy
+#include <atomic>      // for std::atomic
+#include <functional>  // for std::hash
+#include <random>      // for std::random_device
+#include <type_traits> // for std::has_unique_object_representations
+
+namespace custom
+{
+
+/**************************************************
+ * HASH MUM
+ * Replace a and b with the low and high halves of
+ * their 128-bit product
+ **************************************************/
+inline void hash_mum(std::uint64_t & a, std::uint64_t & b)
+{
+#ifdef __SIZEOF_INT128__
+   unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+   a = static_cast<std::uint64_t>(r);
+   b = static_cast<std::uint64_t>(r >> 64);
+#else
+   // four 32 by 32 products, for compilers without a 128-bit integer
+   std::uint64_t aHi = a >> 32, aLo = a & 0xFFFFFFFFu;
+   std::uint64_t bHi = b >> 32, bLo = b & 0xFFFFFFFFu;
+   std::uint64_t hh = aHi * bHi, hl = aHi * bLo, lh = aLo * bHi, ll = aLo * bLo;
+   std::uint64_t mid = (ll >> 32) + (hl & 0xFFFFFFFFu) + (lh & 0xFFFFFFFFu);
+   a = (mid << 32) | (ll & 0xFFFFFFFFu);
+   b = hh + (hl >> 32) + (lh >> 32) + (mid >> 32);
+#endif
+}
+
+/**************************************************
+ * HASH MIX
+ * The 128-bit product of a and b with its high half
+ * folded onto its low half
+ **************************************************/
+inline std::uint64_t hash_mix(std::uint64_t a, std::uint64_t b)
+{
+   hash_mum(a, b);
+   return a ^ b;
+}
+
+namespace wyhash
+{
+   // the wyhash constants: odd, with half their bits set
+   const std::uint64_t P0 = 0xa0761d6478bd642full;
+   const std::uint64_t P1 = 0xe7037ed1a0b428dbull;
+   const std::uint64_t P2 = 0x8ebc6af09c88c6e3ull;
+   const std::uint64_t P3 = 0x589965cc75374cc3ull;
+
+   inline std::uint64_t read8(const unsigned char * p)
+   {
+      std::uint64_t v;
+      std::memcpy(&v, p, 8);
+      return v;
+   }
+   inline std::uint64_t read4(const unsigned char * p)
+   {
+      std::uint32_t v;
+      std::memcpy(&v, p, 4);
+      return v;
+   }
+   // one to three bytes: the first, the middle and the last
+   inline std::uint64_t read3(const unsigned char * p, std::size_t k)
+   {
+      return (std::uint64_t(p[0]) << 16) | (std::uint64_t(p[k >> 1]) << 8) | p[k - 1];
+   }
+} // namespace wyhash
+
+/**************************************************
+ * HASH BYTES
+ * wyhash: 48 bytes a round in three independent lanes,
+ * then 16 at a time, then the last 16 however long
+ * the input was. Short inputs are read with
+ * overlapping loads rather than byte by byte.
+ **************************************************/
+inline std::uint64_t hash_bytes(const void * pData, std::size_t len, std::uint64_t seed = 0)
+{
+   using namespace wyhash;
+   const unsigned char * p = static_cast<const unsigned char *>(pData);
+   seed ^= hash_mix(seed ^ P0, P1);
+   std::uint64_t a;
+   std::uint64_t b;
+   if (len <= 16)
+   {
+      if (len >= 4)
+      {
+         std::size_t shift = (len >> 3) << 2;
+         a = (read4(p) << 32) | read4(p + shift);
+         b = (read4(p + len - 4) << 32) | read4(p + len - 4 - shift);
+      }
+      else if (len > 0)
+      {
+         a = read3(p, len);
+         b = 0;
+      }
+      else
+         a = b = 0;
+   }
+   else
+   {
+      std::size_t i = len;
+      if (i > 48)
+      {
+         std::uint64_t see1 = seed;
+         std::uint64_t see2 = seed;
+         do
+         {
+            seed = hash_mix(read8(p     ) ^ P1, read8(p +  8) ^ seed);
+            see1 = hash_mix(read8(p + 16) ^ P2, read8(p + 24) ^ see1);
+            see2 = hash_mix(read8(p + 32) ^ P3, read8(p + 40) ^ see2);
+            p += 48;
+            i -= 48;
+         }
+         while (i > 48);
+         seed ^= see1 ^ see2;
+      }
+      while (i > 16)
+      {
+         seed = hash_mix(read8(p) ^ P1, read8(p + 8) ^ seed);
+         i -= 16;
+         p += 16;
+      }
+      a = read8(p + i - 16);
+      b = read8(p + i - 8);
+   }
+   a ^= P1;
+   b ^= seed;
+   hash_mum(a, b);
+   return hash_mix(a ^ P0 ^ len, b ^ P1);
+}
+
+/**************************************************
+ * HASH COMBINE
+ * Mix the hash of t into seed. The order matters:
+ * combining 1 then 2 is not combining 2 then 1.
+ **************************************************/
+template <class T>
+inline void hash_combine(std::size_t & seed, const T & t)
+{
+   seed = static_cast<std::size_t>(
+      hash_mix(static_cast<std::uint64_t>(seed) ^ wyhash::P0,
+               static_cast<std::uint64_t>(std::hash<T>()(t)) ^ wyhash::P1));
+}
+
+/**************************************************
+ * RANDOM SEED
+ * A different 64-bit seed every call. The random
+ * device is read once; after that each seed is the
+ * next count, scrambled with that secret.
+ **************************************************/
+inline std::uint64_t random_seed()
+{
+   static const std::uint64_t secret =
+      (static_cast<std::uint64_t>(std::random_device()()) << 32) ^ std::random_device()();
+   static std::atomic<std::uint64_t> count(0);
+   return hash_mix(secret ^ wyhash::P0, count.fetch_add(1, std::memory_order_relaxed) ^ wyhash::P1);
+}
+
+/**************************************************
+ * SEEDED HASH
+ * Hash a T with a seed of its own. Integers and other
+ * T whose bytes are their value, and strings of them,
+ * go through hash_bytes with the seed, so no two
+ * seeds agree on which keys collide. Anything else
+ * is std::hash mixed with the seed: keys std::hash
+ * already maps to one value still collide, but keys
+ * that only shared a bucket no longer do.
+ **************************************************/
+template <class T>
+class seeded_hash
+{
+public:
+   seeded_hash() : seed(random_seed()) {}
+   explicit seeded_hash(std::uint64_t seed) : seed(seed) {}
+
+   std::size_t operator () (const T & t) const
+   {
+      return static_cast<std::size_t>(hash(t, Kind<T>()));
+   }
+
+   std::uint64_t get_seed() const { return seed; }
+
+private:
+   // a string of bytes, like std::string
+   template <class U, class = void>
+   struct is_byte_string : std::false_type {};
+   template <class U>
+   struct is_byte_string<U, decltype(void(std::declval<const U &>().data()),
+                                     void(std::declval<const U &>().size()))> :
+      std::has_unique_object_representations<typename U::value_type> {};
+
+   template <class U>
+   using Kind = std::integral_constant<int,
+      std::has_unique_object_representations<U>::value ? 0 :
+      is_byte_string<U>::value                          ? 1 : 2>;
+
+   std::uint64_t hash(const T & t, std::integral_constant<int, 0>) const
+   {
+      return hash_bytes(&t, sizeof(T), seed);
+   }
+   std::uint64_t hash(const T & t, std::integral_constant<int, 1>) const
+   {
+      return hash_bytes(t.data(), t.size() * sizeof(typename T::value_type), seed);
+   }
+   std::uint64_t hash(const T & t, std::integral_constant<int, 2>) const
+   {
+      return hash_mix(static_cast<std::uint64_t>(std::hash<T>()(t)) ^ seed, wyhash::P1);
+   }
+
+   std::uint64_t seed;     // chosen when this hash is made
+};
+
+} // namespace custom
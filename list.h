@@ -23,6 +23,14 @@
 #include <iostream>    // for nullptr
 #include <new>         // std::bad_alloc
 #include <memory>      // for std::allocator
+#include <type_traits> // for std::is_trivially_destructible
+#include "hashing.h"   // for hash_combine
+
+#ifdef __has_include
+#if __has_include(<memory_resource>)
+#include <memory_resource> // for std::pmr::polymorphic_allocator
+#endif
+#endif
  
 class TestList;        // forward declaration for unit tests
 class TestHash;        // to be used later
@@ -30,24 +38,40 @@ class TestHash;        // to be used later
 namespace custom
 {
 
+/**************************************************
+ * IS MONOTONIC ALLOCATOR
+ * An allocator that frees everything at once, as the arena
+ * does, says so with a nested is_monotonic type
+ **************************************************/
+template <class A, class = void>
+struct is_monotonic_allocator : std::false_type {};
+template <class A>
+struct is_monotonic_allocator<A, decltype(void(typename A::is_monotonic()))> :
+   A::is_monotonic {};
+
 /**************************************************
  * LIST
- * Just like std::list
+ * Just like std::list. The nodes come from the allocator A,
+ * rebound to the node type.
  **************************************************/
-template <typename T>
+template <typename T, typename A = std::allocator<T>>
 class list
 {
    friend class ::TestList; // give unit tests access to the privates
    friend class ::TestHash;
    friend void swap(list& lhs, list& rhs);
+   friend struct std::hash<list>;
+   template <typename TT, typename AA>
+   friend bool operator == (const list <TT, AA> & lhs, const list <TT, AA> & rhs);
 public:  
    // 
    // Construct
    //
 
    list();
-   list(list <T> & rhs);
-   list(list <T>&& rhs);
+   explicit list(const A & a);
+   list(const list <T, A> & rhs);
+   list(list <T, A>&& rhs);
    list(size_t num, const T & t);
    list(size_t num);
    list(const std::initializer_list<T>& il);
@@ -55,16 +79,17 @@ public:
    list(Iterator first, Iterator last);
   ~list() 
    {
+      clear();
    }
 
    // 
    // Assign
    //
 
-   list <T> & operator = (list &  rhs);
-   list <T> & operator = (list && rhs);
-   list <T> & operator = (const std::initializer_list<T>& il);
-   void swap(list <T>& rhs);
+   list <T, A> & operator = (const list & rhs);
+   list <T, A> & operator = (list && rhs);
+   list <T, A> & operator = (const std::initializer_list<T>& il);
+   void swap(list <T, A>& rhs);
 
    //
    // Iterator
@@ -92,6 +117,12 @@ public:
    void push_back (      T&& data);
    iterator insert(iterator it, const T& data);
    iterator insert(iterator it, T&& data);
+   template <class... Args>
+   T & emplace_front(Args&&... args);
+   template <class... Args>
+   T & emplace_back(Args&&... args);
+   template <class... Args>
+   iterator emplace(iterator it, Args&&... args);
 
    //
    // Remove
@@ -101,6 +132,23 @@ public:
    void pop_front();
    void clear();
    iterator erase(const iterator& it);
+   template <class Predicate>
+   size_t remove_if(Predicate pred);
+   size_t unique();
+
+   //
+   // Operations
+   //
+
+   void splice(iterator pos, list <T, A> & rhs);
+   void splice(iterator pos, list <T, A> & rhs, iterator it);
+   void splice(iterator pos, list <T, A> & rhs, iterator first, iterator last);
+   void merge(list <T, A> & rhs) { merge(rhs, [](const T & lhs, const T & rhs) { return lhs < rhs; }); }
+   template <class Compare>
+   void merge(list <T, A> & rhs, Compare less);
+   void sort() { sort([](const T & lhs, const T & rhs) { return lhs < rhs; }); }
+   template <class Compare>
+   void sort(Compare less);
 
    // 
    // Status
@@ -108,15 +156,79 @@ public:
 
    bool empty()  const { return numElements == 0; }
    size_t size() const { return numElements; }
+   A get_allocator() const { return A(nodeAlloc); }
 
 private:
     // nested linked list class
     class Node;
 
+    // the allocator handing out nodes rather than T
+    typedef typename std::allocator_traits<A>::template rebind_alloc<Node> NodeAlloc;
+    typedef std::allocator_traits<NodeAlloc> NodeTraits;
+
+    // get a node from the allocator and build the data in it
+    template <class... Args>
+    Node * allocateNode(Args&&... args)
+    {
+       Node * p = NodeTraits::allocate(nodeAlloc, 1);
+       try
+       {
+          NodeTraits::construct(nodeAlloc, p, std::forward<Args>(args)...);
+       }
+       catch (...)
+       {
+          NodeTraits::deallocate(nodeAlloc, p, 1);
+          throw;
+       }
+       return p;
+    }
+
+    // destroy a node and give it back to the allocator
+    void freeNode(Node * p)
+    {
+       NodeTraits::destroy(nodeAlloc, p);
+       NodeTraits::deallocate(nodeAlloc, p, 1);
+    }
+
+    // take the nodes pFirst through pLast out of the chain without freeing them
+    void unlinkNodes(Node * pFirst, Node * pLast)
+    {
+       if (pFirst->pPrev)
+          pFirst->pPrev->pNext = pLast->pNext;
+       else
+          pHead = pLast->pNext;
+       if (pLast->pNext)
+          pLast->pNext->pPrev = pFirst->pPrev;
+       else
+          pTail = pFirst->pPrev;
+    }
+
+    // put the chain pFirst through pLast in front of pPos, or at the back if nullptr
+    void linkNodes(Node * pPos, Node * pFirst, Node * pLast)
+    {
+       pLast->pNext = pPos;
+       pFirst->pPrev = pPos ? pPos->pPrev : pTail;
+       if (pFirst->pPrev)
+          pFirst->pPrev->pNext = pFirst;
+       else
+          pHead = pFirst;
+       if (pPos)
+          pPos->pPrev = pLast;
+       else
+          pTail = pLast;
+    }
+
+    // the allocator follows the nodes only when it says it should
+    void moveAllocator(NodeAlloc & rhs, std::true_type) { nodeAlloc = std::move(rhs); }
+    void moveAllocator(NodeAlloc &,     std::false_type) { }
+    void copyAllocator(const NodeAlloc & rhs, std::true_type) { nodeAlloc = rhs; }
+    void copyAllocator(const NodeAlloc &,     std::false_type) { }
+
     // member variables
     size_t numElements; // though we could count, it is faster to keep a variable
     Node* pHead;    // pointer to the beginning of the list
     Node* pTail;    // pointer to the ending of the list
+    NodeAlloc nodeAlloc; // where the nodes come from
 };
 
 
@@ -127,26 +239,21 @@ private:
  * private.  This is the case because only the
  * List class can make validation decisions
  *************************************************/
-template <typename T>
-class list <T> :: Node
+template <typename T, typename A>
+class list <T, A> :: Node
 {
 public:
    //
    // Construct
    //
-   Node()  
+   Node() : data(), pNext(nullptr), pPrev(nullptr)
    {
-      pNext = pPrev = nullptr;
    }
-   Node(const T &  data)  
-   {
-      pNext = pPrev = nullptr;
-      this->data = data; //
-   }
-   Node(      T && data)  
+
+   // build the data in place from whatever T's constructor takes
+   template <class... Args>
+   Node(Args&&... args) : data(std::forward<Args>(args)...), pNext(nullptr), pPrev(nullptr)
    {
-      pNext = pPrev = nullptr;
-      this->data = std::move(data); 
    }
 
    //
@@ -162,12 +269,12 @@ public:
  * LIST ITERATOR
  * Iterate through a List, non-constant version
  ************************************************/
-template <typename T>
-class list <T> :: iterator
+template <typename T, typename A>
+class list <T, A> :: iterator
 {
    friend class ::TestList; // give unit tests access to the privates
    friend class ::TestHash;
-   template <typename TT>
+   template <typename TT, typename AA>
    friend class custom::list;
 public:
    // constructors, destructors, and assignment operator
@@ -239,21 +346,21 @@ public:
    } 
 
    // two friends who need to access p directly
-   friend iterator list <T> :: insert(iterator it, const T &  data);
-   friend iterator list <T> :: insert(iterator it,       T && data);
-   friend iterator list <T> :: erase(const iterator & it);
+   friend iterator list <T, A> :: insert(iterator it, const T &  data);
+   friend iterator list <T, A> :: insert(iterator it,       T && data);
+   friend iterator list <T, A> :: erase(const iterator & it);
 
 private:
 
-   typename list <T> :: Node * p;
+   typename list <T, A> :: Node * p;
 };
 
 /*****************************************
  * LIST :: NON-DEFAULT constructors
  * Create a list initialized to a value
  ****************************************/
-template <typename T>
-list <T> ::list(size_t num, const T & t) : numElements(0), pHead(nullptr), pTail(nullptr) // : numElements(0), pHead(nullptr), pTail(nullptr)
+template <typename T, typename A>
+list <T, A> ::list(size_t num, const T & t) : numElements(0), pHead(nullptr), pTail(nullptr) // : numElements(0), pHead(nullptr), pTail(nullptr)
 {
    //numElements = 99;
    //pHead = pTail = new list <T> ::Node();
@@ -265,9 +372,9 @@ list <T> ::list(size_t num, const T & t) : numElements(0), pHead(nullptr), pTail
  * LIST :: ITERATOR constructors
  * Create a list initialized to a set of values
  ****************************************/
-template <typename T>
+template <typename T, typename A>
 template <class Iterator>
-list <T> ::list(Iterator first, Iterator last) : numElements(0), pHead(nullptr), pTail(nullptr) // : numElements(0), pHead(nullptr), pTail(nullptr)
+list <T, A> ::list(Iterator first, Iterator last) : numElements(0), pHead(nullptr), pTail(nullptr) // : numElements(0), pHead(nullptr), pTail(nullptr)
 {
    /*numElements = 99;
    pHead = pTail = new list <T> ::Node();*/
@@ -279,8 +386,8 @@ list <T> ::list(Iterator first, Iterator last) : numElements(0), pHead(nullptr),
  * LIST :: INITIALIZER constructors
  * Create a list initialized to a set of values
  ****************************************/
-template <typename T>
-list <T> ::list(const std::initializer_list<T>& il) : numElements(0), pHead(nullptr), pTail(nullptr) // : numElements(0), pHead(nullptr), pTail(nullptr)
+template <typename T, typename A>
+list <T, A> ::list(const std::initializer_list<T>& il) : numElements(0), pHead(nullptr), pTail(nullptr) // : numElements(0), pHead(nullptr), pTail(nullptr)
 {
    /*numElements = 99;
    pHead = pTail = new list <T> ::Node();*/
@@ -292,8 +399,8 @@ list <T> ::list(const std::initializer_list<T>& il) : numElements(0), pHead(null
  * LIST :: NON-DEFAULT constructors
  * Create a list initialized to a value
  ****************************************/
-template <typename T>
-list <T> ::list(size_t num) : numElements(0), pHead(nullptr), pTail(nullptr) // : numElements(0), pHead(nullptr), pTail(nullptr)
+template <typename T, typename A>
+list <T, A> ::list(size_t num) : numElements(0), pHead(nullptr), pTail(nullptr) // : numElements(0), pHead(nullptr), pTail(nullptr)
 {
    /*numElements = 99;
    pHead = pTail = new list <T> ::Node();*/
@@ -304,39 +411,44 @@ list <T> ::list(size_t num) : numElements(0), pHead(nullptr), pTail(nullptr) //
 /*****************************************
  * LIST :: DEFAULT constructors
  ****************************************/
-template <typename T>
-list <T> ::list() : numElements(0), pHead(nullptr), pTail(nullptr) // : numElements(0), pHead(nullptr), pTail(nullptr)
+template <typename T, typename A>
+list <T, A> ::list() : numElements(0), pHead(nullptr), pTail(nullptr) // : numElements(0), pHead(nullptr), pTail(nullptr)
 {
    /*numElements = 99;
    pHead = pTail = new list <T> ::Node();*/
 }
 
+/*****************************************
+ * LIST :: ALLOCATOR constructors
+ * An empty list drawing its nodes from a
+ ****************************************/
+template <typename T, typename A>
+list <T, A> ::list(const A & a) : numElements(0), pHead(nullptr), pTail(nullptr), nodeAlloc(a)
+{
+}
+
 /*****************************************
  * LIST :: COPY constructors
  ****************************************/
-template <typename T>
-list <T> ::list(list& rhs) : numElements(0), pHead(nullptr), pTail(nullptr) // : numElements(0), pHead(nullptr), pTail(nullptr)
+template <typename T, typename A>
+list <T, A> ::list(const list& rhs) : numElements(0), pHead(nullptr), pTail(nullptr), // : numElements(0), pHead(nullptr), pTail(nullptr)
+   nodeAlloc(NodeTraits::select_on_container_copy_construction(rhs.nodeAlloc))
 {
    /*numElements = 99;
    pHead = pTail = new list <T> ::Node();*/
-    for (auto it = rhs.begin(); it != rhs.end(); ++it)
-        push_back(*it);
+    for (const Node * p = rhs.pHead; p; p = p->pNext)
+        push_back(p->data);
 }
 
 /*****************************************
  * LIST :: MOVE constructors
  * Steal the values from the RHS
  ****************************************/
-template <typename T>
-list <T> ::list(list <T>&& rhs) : numElements(0), pHead(nullptr), pTail(nullptr) // : numElements(0), pHead(nullptr), pTail(nullptr)
+template <typename T, typename A>
+list <T, A> ::list(list <T, A>&& rhs) : numElements(rhs.numElements), pHead(rhs.pHead), pTail(rhs.pTail),
+   nodeAlloc(std::move(rhs.nodeAlloc))
 {
-    // Same as copy constructor 
-    for (auto it = rhs.begin(); it != rhs.end(); ++it)
-        push_back(*it);
-
-    // Make sure all variables are set 
-    pHead = rhs.pHead;
-    pTail = rhs.pTail;
+    // the nodes now belong to us
     rhs.numElements = 0;
     rhs.pHead = nullptr;
     rhs.pTail = nullptr;
@@ -349,10 +461,22 @@ list <T> ::list(list <T>&& rhs) : numElements(0), pHead(nullptr), pTail(nullptr)
  *     OUTPUT :
  *     COST   : O(n) with respect to the size of the LHS 
  *********************************************/
-template <typename T>
-list <T>& list <T> :: operator = (list <T> && rhs)
+template <typename T, typename A>
+list <T, A>& list <T, A> :: operator = (list <T, A> && rhs)
 {
     clear();                            //
+
+    // nodes from another allocator cannot be stolen, only their data
+    if (!NodeTraits::propagate_on_container_move_assignment::value &&
+        !(nodeAlloc == rhs.nodeAlloc))
+    {
+        for (auto it = rhs.begin(); it != rhs.end(); ++it)
+            push_back(std::move(*it));
+        rhs.clear();
+        return *this;
+    }
+    moveAllocator(rhs.nodeAlloc, typename NodeTraits::propagate_on_container_move_assignment());
+
     numElements = rhs.numElements;      //
     pHead = rhs.pHead;                  //
 	pTail = rhs.pTail;  		        //
@@ -364,19 +488,39 @@ list <T>& list <T> :: operator = (list <T> && rhs)
 
 /**********************************************
  * LIST :: assignment operator
- * Copy one list onto another
+ * Copy one list onto another. The nodes we already
+ * have are reused: only the surplus is allocated or
+ * freed.
  *     INPUT  : a list to be copied
  *     OUTPUT :
  *     COST   : O(n) with respect to the number of nodes
  *********************************************/
-template <typename T>
-list <T> & list <T> :: operator = (list <T> & rhs)
+template <typename T, typename A>
+list <T, A> & list <T, A> :: operator = (const list <T, A> & rhs)
 {
     if (this != &rhs) //
     {
-		clear();      //
-		for (auto it = rhs.begin(); it != rhs.end(); ++it)  //
-			push_back(*it);  //
+        // nodes from the old allocator cannot go back to the new one
+        if (NodeTraits::propagate_on_container_copy_assignment::value &&
+            !(nodeAlloc == rhs.nodeAlloc))
+            clear();
+        copyAllocator(rhs.nodeAlloc, typename NodeTraits::propagate_on_container_copy_assignment());
+
+        // assign into the nodes we have
+        Node * pDest = pHead;
+        Node * pSrc = rhs.pHead;
+        for (; pDest && pSrc; pDest = pDest->pNext, pSrc = pSrc->pNext)
+            pDest->data = pSrc->data;
+
+        // then add what is missing or drop what is left over
+        for (; pSrc; pSrc = pSrc->pNext)
+            push_back(pSrc->data);
+        if (pDest)
+        {
+            Node * pKeep = pDest->pPrev;
+            while (pTail != pKeep)
+                pop_back();
+        }
     }
    return *this;
 }
@@ -388,8 +532,8 @@ list <T> & list <T> :: operator = (list <T> & rhs)
  *     OUTPUT :
  *     COST   : O(n) with respect to the number of nodes
  *********************************************/
-template <typename T>
-list <T>& list <T> :: operator = (const std::initializer_list<T>& rhs)
+template <typename T, typename A>
+list <T, A>& list <T, A> :: operator = (const std::initializer_list<T>& rhs)
 {
     clear();        //
     for (const auto& item : rhs)  //
@@ -402,11 +546,21 @@ list <T>& list <T> :: operator = (const std::initializer_list<T>& rhs)
  * Remove all the items currently in the linked list
  *     INPUT  :
  *     OUTPUT :
- *     COST   : O(n) with respect to the number of nodes
+ *     COST   : O(n) with respect to the number of nodes,
+ *              O(1) from an arena when T needs no destructor
  *********************************************/
-template <typename T>
-void list <T> :: clear()
+template <typename T, typename A>
+void list <T, A> :: clear()
 {
+    // nothing to destroy and nothing to free: just forget the nodes
+    if (is_monotonic_allocator<NodeAlloc>::value &&
+        std::is_trivially_destructible<T>::value)
+    {
+        numElements = 0;
+        pHead = pTail = nullptr;
+        return;
+    }
+
 	while (!empty()) //
 		pop_front();  //
 }
@@ -418,10 +572,10 @@ void list <T> :: clear()
  *    OUTPUT :
  *    COST   : O(1)
  *********************************************/
-template <typename T>
-void list <T> ::push_back(const T& data)
+template <typename T, typename A>
+void list <T, A> ::push_back(const T& data)
 {
-    Node* newNode = new Node(data);
+    Node* newNode = allocateNode(data);
     if (pTail == nullptr)
         pHead = pTail = newNode;
     else
@@ -433,10 +587,10 @@ void list <T> ::push_back(const T& data)
     ++numElements;
 }
 
-template <typename T>
-void list <T> ::push_back(T&& data)
+template <typename T, typename A>
+void list <T, A> ::push_back(T&& data)
 {
-    Node* newNode = new Node(std::move(data));
+    Node* newNode = allocateNode(std::move(data));
     if (pTail == nullptr)
         pHead = pTail = newNode;
     else
@@ -448,6 +602,47 @@ void list <T> ::push_back(T&& data)
     ++numElements;
 }
 
+/*********************************************
+ * LIST :: EMPLACE
+ * build an item in a new node from the arguments
+ * to one of T's constructors. Nothing is copied
+ * or moved.
+ *    INPUT  : where the item goes: the front, the
+ *             back, or in front of it
+ *             the arguments for T's constructor
+ *    OUTPUT : the new item
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+template <class... Args>
+T & list <T, A> ::emplace_front(Args&&... args)
+{
+    Node* newNode = allocateNode(std::forward<Args>(args)...);
+    linkNodes(pHead, newNode, newNode);
+    ++numElements;
+    return newNode->data;
+}
+
+template <typename T, typename A>
+template <class... Args>
+T & list <T, A> ::emplace_back(Args&&... args)
+{
+    Node* newNode = allocateNode(std::forward<Args>(args)...);
+    linkNodes(nullptr, newNode, newNode);
+    ++numElements;
+    return newNode->data;
+}
+
+template <typename T, typename A>
+template <class... Args>
+typename list <T, A> ::iterator list <T, A> ::emplace(iterator it, Args&&... args)
+{
+    Node* newNode = allocateNode(std::forward<Args>(args)...);
+    linkNodes(it.p, newNode, newNode);
+    ++numElements;
+    return iterator(newNode);
+}
+
 /*********************************************
  * LIST :: PUSH FRONT
  * add an item to the head of the list
@@ -455,10 +650,10 @@ void list <T> ::push_back(T&& data)
  *     OUTPUT :
  *     COST   : O(1)
  *********************************************/
-template <typename T>
-void list <T> ::push_front(const T& data)
+template <typename T, typename A>
+void list <T, A> ::push_front(const T& data)
 {
-    Node* newNode = new Node(data);
+    Node* newNode = allocateNode(data);
     if (pHead == nullptr)
         pHead = pTail = newNode;
     else
@@ -470,10 +665,10 @@ void list <T> ::push_front(const T& data)
     ++numElements;
 }
 
-template <typename T>
-void list <T> ::push_front(T&& data)
+template <typename T, typename A>
+void list <T, A> ::push_front(T&& data)
 {
-    Node* newNode = new Node(std::move(data));
+    Node* newNode = allocateNode(std::move(data));
     if (pHead == nullptr)
         pHead = pTail = newNode;
     else
@@ -493,8 +688,8 @@ void list <T> ::push_front(T&& data)
  *    OUTPUT :
  *    COST   : O(1)
  *********************************************/
-template <typename T>
-void list <T> ::pop_back()
+template <typename T, typename A>
+void list <T, A> ::pop_back()
 {
     if (pTail == nullptr)
         return;
@@ -507,7 +702,7 @@ void list <T> ::pop_back()
         pTail = pTail->pPrev;
         pTail->pNext = nullptr;
     }
-    delete toDelete;
+    freeNode(toDelete);
     --numElements;
 }
 
@@ -518,8 +713,8 @@ void list <T> ::pop_back()
  *    OUTPUT :
  *    COST   : O(1)
  *********************************************/
-template <typename T>
-void list <T> ::pop_front()
+template <typename T, typename A>
+void list <T, A> ::pop_front()
 {
     if (pHead == nullptr)
         return;
@@ -532,7 +727,7 @@ void list <T> ::pop_front()
         pHead = pHead->pNext;
         pHead->pPrev = nullptr;
     }
-    delete toDelete;
+    freeNode(toDelete);
     --numElements;
 }
 
@@ -543,8 +738,8 @@ void list <T> ::pop_front()
  *     OUTPUT : data to be displayed
  *     COST   : O(1)
  *********************************************/
-template <typename T>
-T & list <T> :: front()
+template <typename T, typename A>
+T & list <T, A> :: front()
 {
 	if (pHead == nullptr)
 		throw "ERROR: unable to access data from an empty list"; //to match test case
@@ -558,8 +753,8 @@ T & list <T> :: front()
  *     OUTPUT : data to be displayed
  *     COST   : O(1)
  *********************************************/
-template <typename T>
-T & list <T> :: back()
+template <typename T, typename A>
+T & list <T, A> :: back()
 {
     if (pTail == nullptr)
         throw "ERROR: unable to access data from an empty list"; //to match test case
@@ -573,8 +768,8 @@ T & list <T> :: back()
  *     OUTPUT : iterator to the new location 
  *     COST   : O(1)
  ******************************************/
-template <typename T>
-typename list <T> :: iterator  list <T> :: erase(const list <T> :: iterator & it)
+template <typename T, typename A>
+typename list <T, A> :: iterator  list <T, A> :: erase(const list <T, A> :: iterator & it)
 {
     if (it.p == nullptr)
         return end();
@@ -596,7 +791,7 @@ typename list <T> :: iterator  list <T> :: erase(const list <T> :: iterator & it
         toDelete->pPrev->pNext = toDelete->pNext;
         toDelete->pNext->pPrev = toDelete->pPrev;
         Node* nextNode = toDelete->pNext;
-		delete toDelete; // dont forget to delete the node
+		freeNode(toDelete); // dont forget to delete the node
 		--numElements; // just deleted a node so decrement the count
         return iterator(nextNode); 
     }
@@ -610,8 +805,8 @@ typename list <T> :: iterator  list <T> :: erase(const list <T> :: iterator & it
  *     OUTPUT : iterator to the new item
  *     COST   : O(1)
  ******************************************/
-template <typename T>
-typename list <T> :: iterator list <T> :: insert(list <T> :: iterator it,
+template <typename T, typename A>
+typename list <T, A> :: iterator list <T, A> :: insert(list <T, A> :: iterator it,
                                                  const T & data) 
 {
     if (it.p == nullptr)
@@ -625,7 +820,7 @@ typename list <T> :: iterator list <T> :: insert(list <T> :: iterator it,
         return iterator(pHead);
     }
 
-    Node* newNode = new Node(data);
+    Node* newNode = allocateNode(data);
     newNode->pPrev = it.p->pPrev;
     newNode->pNext = it.p;
     it.p->pPrev->pNext = newNode;
@@ -635,8 +830,8 @@ typename list <T> :: iterator list <T> :: insert(list <T> :: iterator it,
     return iterator(newNode);
 }
 
-template <typename T>
-typename list <T> :: iterator list <T> :: insert(list <T> :: iterator it,
+template <typename T, typename A>
+typename list <T, A> :: iterator list <T, A> :: insert(list <T, A> :: iterator it,
    T && data)
 {
     if (it.p == nullptr)
@@ -650,7 +845,7 @@ typename list <T> :: iterator list <T> :: insert(list <T> :: iterator it,
         return iterator(pHead);
     }
 
-    Node* newNode = new Node(std::move(data));
+    Node* newNode = allocateNode(std::move(data));
     newNode->pPrev = it.p->pPrev;
     newNode->pNext = it.p;
     it.p->pPrev->pNext = newNode;
@@ -660,6 +855,232 @@ typename list <T> :: iterator list <T> :: insert(list <T> :: iterator it,
     return iterator(newNode);
 }
 
+/******************************************
+ * LIST :: REMOVE IF
+ * remove every item pred says to
+ *     INPUT  : pred(data) is true for the items to go
+ *     OUTPUT : the number removed
+ *     COST   : O(n)
+ ******************************************/
+template <typename T, typename A>
+template <class Predicate>
+size_t list <T, A> :: remove_if(Predicate pred)
+{
+    size_t num = 0;
+    for (auto it = begin(); it != end(); )
+        if (pred(*it))
+        {
+            it = erase(it);
+            num++;
+        }
+        else
+            ++it;
+    return num;
+}
+
+/******************************************
+ * LIST :: UNIQUE
+ * remove every item equal to the one in front of it
+ *     INPUT  :
+ *     OUTPUT : the number removed
+ *     COST   : O(n)
+ ******************************************/
+template <typename T, typename A>
+size_t list <T, A> :: unique()
+{
+    size_t num = 0;
+    if (pHead == nullptr)
+        return num;
+    for (Node * p = pHead; p->pNext; )
+        if (p->pNext->data == p->data)
+        {
+            erase(iterator(p->pNext));
+            num++;
+        }
+        else
+            p = p->pNext;
+    return num;
+}
+
+/******************************************
+ * LIST :: SPLICE
+ * move nodes from rhs to in front of pos. Nothing is
+ * allocated, freed, copied or moved: the nodes are relinked.
+ * Both lists must share an allocator.
+ *     INPUT  : pos, where the nodes go
+ *              rhs, where they come from
+ *              it, or first and last, which nodes (default all)
+ *     OUTPUT :
+ *     COST   : O(1), or O(n) to count a range from another list
+ ******************************************/
+template <typename T, typename A>
+void list <T, A> :: splice(iterator pos, list <T, A> & rhs)
+{
+    if (this == &rhs || rhs.pHead == nullptr)
+        return;
+    assert(nodeAlloc == rhs.nodeAlloc);
+
+    Node * pFirst = rhs.pHead;
+    Node * pLast = rhs.pTail;
+    rhs.pHead = rhs.pTail = nullptr;
+    linkNodes(pos.p, pFirst, pLast);
+
+    numElements += rhs.numElements;
+    rhs.numElements = 0;
+}
+
+template <typename T, typename A>
+void list <T, A> :: splice(iterator pos, list <T, A> & rhs, iterator it)
+{
+    // already where it belongs: only possible within one list, since
+    // the last node of another list also has a null pNext like end()
+    if (it.p == nullptr || (this == &rhs && (it.p == pos.p || it.p->pNext == pos.p)))
+        return;
+    assert(nodeAlloc == rhs.nodeAlloc);
+
+    rhs.unlinkNodes(it.p, it.p);
+    linkNodes(pos.p, it.p, it.p);
+    rhs.numElements--;
+    numElements++;
+}
+
+template <typename T, typename A>
+void list <T, A> :: splice(iterator pos, list <T, A> & rhs, iterator first, iterator last)
+{
+    if (first == last)
+        return;
+    assert(nodeAlloc == rhs.nodeAlloc);
+
+    // the last node of the range, and how many there are if they change lists
+    Node * pLast = last.p ? last.p->pPrev : rhs.pTail;
+    if (this != &rhs)
+    {
+        size_t num = 1;
+        for (Node * p = first.p; p != pLast; p = p->pNext)
+            num++;
+        rhs.numElements -= num;
+        numElements += num;
+    }
+
+    rhs.unlinkNodes(first.p, pLast);
+    linkNodes(pos.p, first.p, pLast);
+}
+
+/******************************************
+ * LIST :: MERGE
+ * move every node of the sorted rhs into this sorted
+ * list, keeping it sorted. Equal items from rhs go
+ * after ours. Both lists must share an allocator.
+ *     INPUT  : rhs, sorted by less, empty afterwards
+ *              less, the ordering
+ *     OUTPUT :
+ *     COST   : O(n + m)
+ ******************************************/
+template <typename T, typename A>
+template <class Compare>
+void list <T, A> :: merge(list <T, A> & rhs, Compare less)
+{
+    if (this == &rhs)
+        return;
+    assert(nodeAlloc == rhs.nodeAlloc);
+
+    Node * p = pHead;
+    while (rhs.pHead)
+    {
+        // nothing left of ours: the rest of rhs goes on the back
+        if (p == nullptr)
+        {
+            splice(end(), rhs);
+            return;
+        }
+        if (less(rhs.pHead->data, p->data))
+            splice(iterator(p), rhs, iterator(rhs.pHead));
+        else
+            p = p->pNext;
+    }
+}
+
+/******************************************
+ * LIST :: SORT
+ * a bottom-up merge sort. Runs of 1, 2, 4, ... nodes are
+ * merged pairwise by relinking pNext only; pPrev is fixed
+ * in one pass at the end. Stable, and no T is copied or moved.
+ *     INPUT  : less, the ordering
+ *     OUTPUT :
+ *     COST   : O(n log n) time, O(1) space
+ ******************************************/
+template <typename T, typename A>
+template <class Compare>
+void list <T, A> :: sort(Compare less)
+{
+    if (numElements < 2)
+        return;
+
+    Node * pList = pHead;
+    for (size_t width = 1; ; width *= 2)
+    {
+        Node * pLeft = pList;
+        Node ** ppBack = &pList;   // where the next merged node goes
+        size_t numMerges = 0;
+
+        while (pLeft)
+        {
+            numMerges++;
+
+            // the right run starts width nodes after the left
+            Node * pRight = pLeft;
+            size_t numLeft = 0;
+            while (numLeft < width && pRight)
+            {
+                numLeft++;
+                pRight = pRight->pNext;
+            }
+            size_t numRight = width;
+
+            // take the smaller front until both runs are used up
+            while (numLeft > 0 || (numRight > 0 && pRight))
+            {
+                Node * p;
+                if (numLeft == 0)
+                {
+                    p = pRight;
+                    pRight = pRight->pNext;
+                    numRight--;
+                }
+                else if (numRight == 0 || !pRight || !less(pRight->data, pLeft->data))
+                {
+                    p = pLeft;
+                    pLeft = pLeft->pNext;
+                    numLeft--;
+                }
+                else
+                {
+                    p = pRight;
+                    pRight = pRight->pNext;
+                    numRight--;
+                }
+                *ppBack = p;
+                ppBack = &p->pNext;
+            }
+            pLeft = pRight;
+        }
+        *ppBack = nullptr;
+
+        if (numMerges <= 1)
+            break;
+    }
+
+    // put the back links and the ends back
+    pHead = pList;
+    Node * pPrev = nullptr;
+    for (Node * p = pHead; p; p = p->pNext)
+    {
+        p->pPrev = pPrev;
+        pPrev = p;
+    }
+    pTail = pPrev;
+}
+
 /**********************************************
  * LIST :: assignment operator - MOVE
  * Copy one list onto another
@@ -667,21 +1088,76 @@ typename list <T> :: iterator list <T> :: insert(list <T> :: iterator it,
  *     OUTPUT :
  *     COST   : O(n) with respect to the size of the LHS
  *********************************************/
-template <typename T>
-void swap(list <T> & lhs, list <T> & rhs)
+template <typename T, typename A>
+void swap(list <T, A> & lhs, list <T, A> & rhs)
 {
-	list <T> temp(std::move(lhs));
+	list <T, A> temp(std::move(lhs));
 	lhs = std::move(rhs);
 	rhs = std::move(temp);
 }
 
-template <typename T>
-void list<T>::swap(list <T>& rhs)
+template <typename T, typename A>
+void list <T, A>::swap(list <T, A>& rhs)
 {
-    list <T> temp(std::move(*this));
+    list <T, A> temp(std::move(*this));
     *this = std::move(rhs);
     rhs = std::move(temp);
 }
 
+/**********************************************
+ * LIST EQUIVALENCE
+ * The same size, and equal node by node
+ **********************************************/
+template <typename T, typename A>
+bool operator == (const list <T, A> & lhs, const list <T, A> & rhs)
+{
+   if (lhs.numElements != rhs.numElements)
+      return false;
+   auto pRHS = rhs.pHead;
+   for (auto pLHS = lhs.pHead; pLHS; pLHS = pLHS->pNext, pRHS = pRHS->pNext)
+      if (!(pLHS->data == pRHS->data))
+         return false;
+   return true;
+}
+
+template <typename T, typename A>
+bool operator != (const list <T, A> & lhs, const list <T, A> & rhs)
+{
+   return !(lhs == rhs);
+}
+
+#ifdef __cpp_lib_memory_resource
+namespace pmr
+{
+/**************************************************
+ * PMR LIST
+ * A list drawing its nodes from a std::pmr::memory_resource:
+ *    custom::pmr::list<int> l(&resource);
+ **************************************************/
+template <typename T>
+using list = custom::list<T, std::pmr::polymorphic_allocator<T>>;
+} // namespace pmr
+#endif // __cpp_lib_memory_resource
+
 //#endif
 }; // namespace custom
+
+namespace std
+{
+/**********************************************
+ * HASH LIST
+ * The nodes are scattered, so there is no buffer to
+ * hash in one go: each element is hashed and combined
+ **********************************************/
+template <typename T, typename A>
+struct hash <custom::list <T, A>>
+{
+   size_t operator () (const custom::list <T, A> & l) const
+   {
+      size_t seed = l.numElements;
+      for (auto p = l.pHead; p; p = p->pNext)
+         custom::hash_combine(seed, p->data);
+      return seed;
+   }
+};
+} // namespace std
@@ -9,11 +9,40 @@
 
 #pragma once
 
-#include <iostream>  // for ISTREAM and OSTREAM
+#include <iostream>     // for ISTREAM and OSTREAM
+#include <functional>   // for std::less
+#include <type_traits>  // for std::is_empty
+#include <utility>      // for std::move
+#include "hashing.h"    // for hash_combine
 
 namespace custom
 {
 
+/**********************************************
+ * PAIR COMPARE
+ * Holds the comparison operator of a pair. A comparator with no
+ * state, like std::less, is a base class rather than a member so
+ * the empty base optimization gives it no space at all: a
+ * pair <int, int> is then just the two ints.
+ ***********************************************/
+template <typename C, bool = std::is_empty<C>::value && !std::is_final<C>::value>
+class pair_compare : private C
+{
+public:
+   pair_compare(const C & c) : C(c) {}
+   const C & key_comp() const { return *this; }
+};
+
+template <typename C>
+class pair_compare <C, false>
+{
+public:
+   pair_compare(const C & c) : compare(c) {}
+   const C & key_comp() const { return compare; }
+private:
+   C compare;              // comparision operator
+};
+
 /**********************************************
  * PAIR
  * This class couples together a pair of values, which may be of
@@ -24,8 +53,9 @@ namespace custom
  * is a key in a name-value pair.
  ***********************************************/
 template <class T1, class T2, typename C = std::less<T1>>
-class pair
+class pair : private pair_compare <C>
 {
+   typedef pair_compare <C> Compare;
 public:
    //
    // Constructors
@@ -33,23 +63,23 @@ public:
    
    // Default Constructor: call the T1, T2 default constructors
    pair(const C& c = C())
-       : first(     ), second(      ), compare(c) {}
+       : Compare(c), first(     ), second(      ) {}
    // Non-Default Constructor: call the T1, T2 copy constructors
    pair(const T1 & first, const T2 & second, const C& c = C())
-       : first(first), second(second), compare(c) {}
+       : Compare(c), first(first), second(second) {}
    pair(const T1& first, T2 && second, const C& c = C())
-      : first(first), second(std::move(second)), compare(c) {}
+      : Compare(c), first(first), second(std::move(second)) {}
    pair(const T1& first, const C& c = C())
-      : first(first), second(), compare(c) {}
+      : Compare(c), first(first), second() {}
    // Copy Constructor: call the T1, T2 copy constructors
    pair(const pair <T1, T2> & rhs, const C& c = C())
-       : first(rhs.first), second(rhs.second), compare(c) {}
+       : Compare(c), first(rhs.first), second(rhs.second) {}
    // Non-Default Move Constructor: call the T1, T2 move constructors
    pair(T1 && first, T2 && second, const C& c = C())
-       : first(std::move(first)), second(std::move(second)), compare(c) {}
+       : Compare(c), first(std::move(first)), second(std::move(second)) {}
    // Move Constructor: call the T1, T2 move constructors
    pair(pair <T1, T2> && rhs, const C& c = C())
-       : first(std::move(rhs.first)), second(std::move(rhs.second)), compare(c) {}
+       : Compare(c), first(std::move(rhs.first)), second(std::move(rhs.second)) {}
 
    //
    // Assignment Operators
@@ -81,10 +111,10 @@ public:
    // Relative: only the first will be compared
    //
 
-   bool operator <  (const pair & rhs) const { return compare(first, rhs.first); }
-   bool operator >  (const pair & rhs) const { return compare(rhs.first, first);        }
-   bool operator >= (const pair & rhs) const { return !(compare(first, rhs.first));     }
-   bool operator <= (const pair & rhs) const { return !(compare(rhs.first, first));     }
+   bool operator <  (const pair & rhs) const { return key_comp()(first, rhs.first);     }
+   bool operator >  (const pair & rhs) const { return key_comp()(rhs.first, first);     }
+   bool operator >= (const pair & rhs) const { return !(key_comp()(first, rhs.first));  }
+   bool operator <= (const pair & rhs) const { return !(key_comp()(rhs.first, first));  }
    
    //
    // Swap: swap the places
@@ -98,16 +128,15 @@ public:
    }
    
    //
-   // Member Variables: direct access to the two member variables
+   // Get: retrieve the comparison operator
    //
-   
+
+   using Compare::key_comp;
+
    //
-   // Get: retrieve a value
+   // Member Variables: direct access to the two member variables
    //
    
-   C    compare;              // comparision operator
-
-   
    // these are public. We cannot validate because we know nothing about T
    T1 first;
    T2 second;
@@ -159,4 +188,24 @@ inline std::istream & operator >> (std::istream & in,
    return in;
 }
 
-}
+} // namespace custom
+
+/*****************************************************
+ * HASH PAIR
+ * Two pairs are equal when their firsts are, so only
+ * the first is hashed: pairs that compare equal must
+ * land in the same bucket.
+ ****************************************************/
+namespace std
+{
+template <class T1, class T2, typename C>
+struct hash <custom::pair <T1, T2, C>>
+{
+   size_t operator () (const custom::pair <T1, T2, C> & p) const
+   {
+      size_t seed = 0;
+      custom::hash_combine(seed, p.first);
+      return seed;
+   }
+};
+} // namespace std
@@ -0,0 +1,487 @@
+/***********************************************************************
+ * Header:
+ *    PARALLEL
+ * Summary:
+ *    Algorithms over a custom::vector that use every core: sort,
+ *    transform, reduce, inclusive_scan and for_each. They run on
+ *    our own work-stealing thread pool, so the data never has to be
+ *    copied into a std container first.
+ *
+ *    This will contain the class definitions of:
+ *        parallel::thread_pool : Worker threads, each with its own deque
+ *        parallel::task_group  : Tasks started together and waited on
+ *    and the algorithms in custom::parallel.
+ *
+ *    Each worker pops its newest task first and, when it runs dry,
+ *    steals the oldest task of another. A thread waiting on a group
+ *    runs tasks too, so nested parallelism cannot deadlock. Below
+ *    a cutoff, a range is simply done on the calling thread.
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#include <algorithm>           // for std::sort, std::partition
+#include <atomic>              // for std::atomic
+#include <condition_variable>  // for std::condition_variable
+#include <cstddef>             // for std::size_t
+#include <deque>               // for the task deques
+#include <exception>           // for std::exception_ptr
+#include <functional>          // for std::function, std::less
+#include <memory>              // for std::unique_ptr
+#include <mutex>               // for std::mutex
+#include <thread>              // for std::thread
+#include <utility>             // for std::move
+#include <vector>              // for the workers
+#include "vector.h"            // for custom::vector
+
+namespace custom
+{
+namespace parallel
+{
+
+// ranges at or below this many elements are not split
+const std::size_t SEQUENTIAL_CUTOFF = 1 << 13;
+
+/**************************************************
+ * THREAD POOL
+ * One deque of tasks per worker plus one for threads
+ * outside the pool. A task is pushed to the deque of
+ * the thread that makes it.
+ **************************************************/
+class thread_pool
+{
+public:
+   // all but one core: the caller works while it waits
+   explicit thread_pool(std::size_t numThreads = defaultThreads()) :
+      numQueued(0), done(false)
+   {
+      for (std::size_t i = 0; i <= numThreads; i++)
+         queues.emplace_back(new Queue);
+      for (std::size_t i = 0; i < numThreads; i++)
+         threads.emplace_back([this, i] { work(i); });
+   }
+   thread_pool(const thread_pool &) = delete;
+   thread_pool & operator = (const thread_pool &) = delete;
+  ~thread_pool()
+   {
+      {
+         std::lock_guard<std::mutex> lock(mWake);
+         done = true;
+      }
+      cvWake.notify_all();
+      for (auto & t : threads)
+         t.join();
+   }
+
+   // the pool the algorithms use
+   static thread_pool & instance()
+   {
+      static thread_pool pool;
+      return pool;
+   }
+
+   // the threads that can run tasks, counting the one waiting
+   std::size_t size() const { return threads.size() + 1; }
+
+   // queue a task on the calling thread's deque
+   void submit(std::function<void()> task)
+   {
+      Queue & q = *queues[self()];
+      {
+         std::lock_guard<std::mutex> lock(q.m);
+         q.tasks.push_back(std::move(task));
+      }
+      {
+         std::lock_guard<std::mutex> lock(mWake);
+         numQueued++;
+      }
+      cvWake.notify_one();
+   }
+
+   // run one task if there is one anywhere: ours newest first, then steal
+   bool runOne()
+   {
+      std::function<void()> task;
+      std::size_t iSelf = self();
+      for (std::size_t k = 0; k < queues.size() && !task; k++)
+      {
+         Queue & q = *queues[(iSelf + k) % queues.size()];
+         std::lock_guard<std::mutex> lock(q.m);
+         if (q.tasks.empty())
+            continue;
+         if (k == 0)
+         {
+            task = std::move(q.tasks.back());
+            q.tasks.pop_back();
+         }
+         else
+         {
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+         }
+      }
+      if (!task)
+         return false;
+      numQueued--;
+      task();
+      return true;
+   }
+
+private:
+   struct Queue
+   {
+      std::mutex m;
+      std::deque<std::function<void()>> tasks;
+   };
+
+   static std::size_t defaultThreads()
+   {
+      std::size_t n = std::thread::hardware_concurrency();
+      return n > 1 ? n - 1 : 1;
+   }
+
+   // which pool and worker this thread is, if any
+   struct Worker
+   {
+      const thread_pool * pPool;
+      std::size_t index;
+   };
+   static Worker & worker()
+   {
+      static thread_local Worker w = { nullptr, 0 };
+      return w;
+   }
+
+   // a worker's own deque, or the last one for outsiders
+   std::size_t self() const
+   {
+      return worker().pPool == this ? worker().index : queues.size() - 1;
+   }
+
+   void work(std::size_t index)
+   {
+      worker().pPool = this;
+      worker().index = index;
+      for (;;)
+      {
+         if (runOne())
+            continue;
+         std::unique_lock<std::mutex> lock(mWake);
+         cvWake.wait(lock, [this] { return done || numQueued > 0; });
+         if (done && numQueued == 0)
+            return;
+      }
+   }
+
+   std::vector<std::unique_ptr<Queue>> queues;   // one per worker, then the outsiders'
+   std::vector<std::thread> threads;             // the workers
+   std::atomic<std::size_t> numQueued;           // tasks in any deque
+   std::mutex mWake;                             // guards sleeping and done
+   std::condition_variable cvWake;               // wakes a worker for a new task
+   bool done;                                    // the pool is shutting down
+};
+
+/**************************************************
+ * TASK GROUP
+ * Run tasks on the pool and wait for all of them. The
+ * first exception a task throws comes out of wait().
+ **************************************************/
+class task_group
+{
+public:
+   explicit task_group(thread_pool & pool = thread_pool::instance()) :
+      pool(pool), numLeft(0) {}
+   task_group(const task_group &) = delete;
+   task_group & operator = (const task_group &) = delete;
+  ~task_group()
+   {
+      help();
+   }
+
+   template <class F>
+   void run(F f)
+   {
+      numLeft++;
+      pool.submit([this, f]() mutable
+      {
+         try
+         {
+            f();
+         }
+         catch (...)
+         {
+            std::lock_guard<std::mutex> lock(mError);
+            if (!error)
+               error = std::current_exception();
+         }
+         numLeft--;
+      });
+   }
+
+   // run tasks until all of ours are done
+   void wait()
+   {
+      help();
+      if (error)
+      {
+         std::exception_ptr e = error;
+         error = nullptr;
+         std::rethrow_exception(e);
+      }
+   }
+
+   thread_pool & getPool() { return pool; }
+
+private:
+   void help()
+   {
+      while (numLeft > 0)
+         if (!pool.runOne())
+            std::this_thread::yield();
+   }
+
+   thread_pool & pool;
+   std::atomic<std::size_t> numLeft;   // tasks started and not yet finished
+   std::mutex mError;
+   std::exception_ptr error;           // the first one thrown
+};
+
+/**************************************************
+ * FOR CHUNKS
+ * Split [0, n) into a few pieces per thread, none
+ * smaller than grain, and call f(iBegin, iEnd) on each
+ **************************************************/
+template <class F>
+void forChunks(std::size_t n, std::size_t grain, F f)
+{
+   thread_pool & pool = thread_pool::instance();
+   if (grain == 0)
+      grain = 1;
+   std::size_t numChunks = (n + grain - 1) / grain;
+   if (numChunks > pool.size() * 4)
+      numChunks = pool.size() * 4;
+   if (numChunks <= 1)
+   {
+      f(std::size_t(0), n);
+      return;
+   }
+
+   task_group group(pool);
+   std::size_t size = n / numChunks;
+   std::size_t extra = n % numChunks;
+   std::size_t iBegin = 0;
+   for (std::size_t i = 0; i < numChunks; i++)
+   {
+      std::size_t iEnd = iBegin + size + (i < extra ? 1 : 0);
+      group.run([f, iBegin, iEnd] { f(iBegin, iEnd); });
+      iBegin = iEnd;
+   }
+   group.wait();
+}
+
+/**************************************************
+ * FOR EACH
+ * Call f on every element
+ **************************************************/
+template <typename T, typename A, class F>
+void for_each(vector <T, A> & v, F f, std::size_t grain = SEQUENTIAL_CUTOFF)
+{
+   if (v.empty())
+      return;
+   T * p = &v.front();
+   forChunks(v.size(), grain, [p, &f](std::size_t iBegin, std::size_t iEnd)
+   {
+      for (std::size_t i = iBegin; i < iEnd; i++)
+         f(p[i]);
+   });
+}
+
+/**************************************************
+ * TRANSFORM
+ * dest[i] = f(src[i]). dest is resized to fit, and
+ * may be src itself.
+ **************************************************/
+template <typename T, typename A, typename U, typename B, class F>
+void transform(const vector <T, A> & src, vector <U, B> & dest, F f,
+               std::size_t grain = SEQUENTIAL_CUTOFF)
+{
+   if (static_cast<const void *>(&src) != static_cast<const void *>(&dest))
+      dest.resize(src.size());
+   if (src.empty())
+      return;
+   const T * pSrc = &src.front();
+   U * pDest = &dest.front();
+   forChunks(src.size(), grain, [pSrc, pDest, &f](std::size_t iBegin, std::size_t iEnd)
+   {
+      for (std::size_t i = iBegin; i < iEnd; i++)
+         pDest[i] = f(pSrc[i]);
+   });
+}
+
+/**************************************************
+ * REDUCE
+ * init op v[0] op v[1] ... The chunks are combined
+ * in order, so op must be associative but need not
+ * be commutative.
+ **************************************************/
+template <typename T, typename A, typename R, class Op>
+R reduce(const vector <T, A> & v, R init, Op op, std::size_t grain = SEQUENTIAL_CUTOFF)
+{
+   if (v.empty())
+      return init;
+   const T * p = &v.front();
+   thread_pool & pool = thread_pool::instance();
+   std::size_t numChunks = pool.size() * 4;
+   std::vector<R> partial(numChunks);
+   std::size_t chunk = (v.size() + numChunks - 1) / numChunks;
+   if (chunk < grain)
+      chunk = grain;
+
+   forChunks((v.size() + chunk - 1) / chunk, 1, [&](std::size_t iBegin, std::size_t iEnd)
+   {
+      for (std::size_t c = iBegin; c < iEnd; c++)
+      {
+         std::size_t i = c * chunk;
+         std::size_t iLast = i + chunk < v.size() ? i + chunk : v.size();
+         R sum = p[i];
+         for (i++; i < iLast; i++)
+            sum = op(sum, p[i]);
+         partial[c] = sum;
+      }
+   });
+
+   R result = init;
+   for (std::size_t c = 0; c * chunk < v.size(); c++)
+      result = op(result, partial[c]);
+   return result;
+}
+
+template <typename T, typename A>
+T reduce(const vector <T, A> & v)
+{
+   return parallel::reduce(v, T(), [](const T & a, const T & b) { return a + b; });
+}
+
+/**************************************************
+ * INCLUSIVE SCAN
+ * dest[i] = v[0] op v[1] op ... v[i]. Each chunk is
+ * totalled, the totals are scanned, then each chunk
+ * is scanned again starting from the total before it.
+ * dest may be v itself.
+ **************************************************/
+template <typename T, typename A, typename B, class Op>
+void inclusive_scan(const vector <T, A> & src, vector <T, B> & dest, Op op,
+                    std::size_t grain = SEQUENTIAL_CUTOFF)
+{
+   if (static_cast<const void *>(&src) != static_cast<const void *>(&dest))
+      dest.resize(src.size());
+   if (src.empty())
+      return;
+   const T * pSrc = &src.front();
+   T * pDest = &dest.front();
+   std::size_t n = src.size();
+
+   // one chunk is just a scan
+   thread_pool & pool = thread_pool::instance();
+   std::size_t chunk = (n + pool.size() - 1) / pool.size();
+   if (chunk < grain)
+      chunk = grain;
+   std::size_t numChunks = (n + chunk - 1) / chunk;
+   auto scan = [pSrc, pDest, &op](std::size_t iBegin, std::size_t iEnd, const T * pCarry)
+   {
+      T sum = pCarry ? op(*pCarry, pSrc[iBegin]) : pSrc[iBegin];
+      pDest[iBegin] = sum;
+      for (std::size_t i = iBegin + 1; i < iEnd; i++)
+         pDest[i] = sum = op(sum, pSrc[i]);
+   };
+   if (numChunks == 1)
+   {
+      scan(0, n, nullptr);
+      return;
+   }
+
+   // total each chunk but the last
+   std::vector<T> carry(numChunks);
+   forChunks(numChunks - 1, 1, [&](std::size_t iBegin, std::size_t iEnd)
+   {
+      for (std::size_t c = iBegin; c < iEnd; c++)
+      {
+         std::size_t i = c * chunk;
+         T sum = pSrc[i];
+         for (i++; i < (c + 1) * chunk; i++)
+            sum = op(sum, pSrc[i]);
+         carry[c + 1] = sum;
+      }
+   });
+
+   // what comes before each chunk
+   for (std::size_t c = 2; c < numChunks; c++)
+      carry[c] = op(carry[c - 1], carry[c]);
+
+   // scan each chunk from there
+   forChunks(numChunks, 1, [&](std::size_t iBegin, std::size_t iEnd)
+   {
+      for (std::size_t c = iBegin; c < iEnd; c++)
+         scan(c * chunk, (c + 1) * chunk < n ? (c + 1) * chunk : n, c ? &carry[c] : nullptr);
+   });
+}
+
+template <typename T, typename A, typename B>
+void inclusive_scan(const vector <T, A> & src, vector <T, B> & dest)
+{
+   parallel::inclusive_scan(src, dest, [](const T & a, const T & b) { return a + b; });
+}
+
+/**************************************************
+ * SORT
+ * Quicksort, each left part a task of its own. The
+ * pivot is the median of three and everything equal
+ * to it is set aside, so repeated keys cost nothing.
+ **************************************************/
+template <typename T, class Less>
+void sortRange(T * p, std::size_t n, Less less, task_group & group, std::size_t grain)
+{
+   while (n > grain)
+   {
+      // the median of the first, middle and last
+      const T & a = p[0];
+      const T & b = p[n / 2];
+      const T & c = p[n - 1];
+      T pivot = less(a, b) ? (less(b, c) ? b : (less(a, c) ? c : a))
+                           : (less(a, c) ? a : (less(b, c) ? c : b));
+
+      // less than, equal to, and greater than the pivot
+      T * pEqual = std::partition(p, p + n, [&](const T & t) { return less(t, pivot); });
+      T * pGreater = std::partition(pEqual, p + n, [&](const T & t) { return !less(pivot, t); });
+
+      std::size_t numLess = pEqual - p;
+      if (numLess > 1)
+         group.run([p, numLess, less, &group, grain] { sortRange(p, numLess, less, group, grain); });
+      n -= pGreater - p;
+      p = pGreater;
+   }
+   std::sort(p, p + n, less);
+}
+
+template <typename T, typename A, class Less>
+void sort(vector <T, A> & v, Less less, std::size_t grain = SEQUENTIAL_CUTOFF)
+{
+   if (v.size() < 2)
+      return;
+   if (grain < 2)
+      grain = 2;
+   task_group group;
+   sortRange(&v.front(), v.size(), less, group, grain);
+   group.wait();
+}
+
+template <typename T, typename A>
+void sort(vector <T, A> & v)
+{
+   parallel::sort(v, std::less<T>());
+}
+
+} // namespace parallel
+} // namespace custom
@@ -0,0 +1,192 @@
+/***********************************************************************
+ * Header:
+ *    PERF COUNTERS
+ * Summary:
+ *    Read the hardware performance counters of the CPU around a piece
+ *    of code: cycles, instructions, cache misses, branch misses, and
+ *    TLB misses. Wall-clock time says that one layout is faster than
+ *    another; these say why.
+ *
+ *    This will contain the class definition of:
+ *        perf_counters : The counters of this thread, opened and closed
+ *                        with the object
+ *
+ *    On Linux this uses perf_event_open(2). Elsewhere, or when the
+ *    kernel will not give us a counter (perf_event_paranoid, a virtual
+ *    machine without a PMU), that counter is simply not available
+ *    and reads as zero.
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#include <cstdint>     // for std::uint64_t
+#include <cstring>     // for std::memset
+
+#ifdef __linux__
+#include <linux/perf_event.h>  // for perf_event_attr
+#include <sys/syscall.h>       // for SYS_perf_event_open
+#include <sys/ioctl.h>         // for ioctl
+#include <unistd.h>            // for syscall, read, close
+#endif // __linux__
+
+namespace custom
+{
+
+/**************************************************
+ * PERF COUNTERS
+ * The hardware counters for the calling thread, counting
+ * user-space work only. Each counter is opened on its own
+ * so one the CPU lacks does not take the others with it.
+ **************************************************/
+class perf_counters
+{
+public:
+   enum event { CYCLES,        // CPU cycles
+                INSTRUCTIONS,  // instructions retired
+                L1D_MISSES,    // level 1 data cache read misses
+                LLC_MISSES,    // last level cache misses
+                BRANCH_MISSES, // mispredicted branches
+                DTLB_MISSES,   // data TLB read misses
+                NUM_EVENTS };
+
+   //
+   // Construct
+   //
+
+   perf_counters()
+   {
+      for (int i = 0; i < NUM_EVENTS; i++)
+         fds[i] = open(event(i));
+   }
+   perf_counters(const perf_counters & rhs) = delete;
+   perf_counters & operator = (const perf_counters & rhs) = delete;
+  ~perf_counters()
+   {
+#ifdef __linux__
+      for (int i = 0; i < NUM_EVENTS; i++)
+         if (fds[i] >= 0)
+            ::close(fds[i]);
+#endif // __linux__
+   }
+
+   //
+   // Control
+   //
+
+   // zero the counters and start counting
+   void start()
+   {
+#ifdef __linux__
+      for (int i = 0; i < NUM_EVENTS; i++)
+         if (fds[i] >= 0)
+         {
+            ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+         }
+#endif // __linux__
+   }
+
+   // stop counting, keeping the counts for get()
+   void stop()
+   {
+#ifdef __linux__
+      for (int i = 0; i < NUM_EVENTS; i++)
+         if (fds[i] >= 0)
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+#endif // __linux__
+   }
+
+   //
+   // Access
+   //
+
+   // the count since the last start(), or zero if not available
+   std::uint64_t get(event e) const
+   {
+      std::uint64_t count = 0;
+#ifdef __linux__
+      if (fds[e] >= 0 && ::read(fds[e], &count, sizeof(count)) != sizeof(count))
+         count = 0;
+#endif // __linux__
+      return count;
+   }
+
+   // can this counter be read?
+   bool available(event e) const { return fds[e] >= 0; }
+
+   // can any counter be read?
+   bool available() const
+   {
+      for (int i = 0; i < NUM_EVENTS; i++)
+         if (fds[i] >= 0)
+            return true;
+      return false;
+   }
+
+   // a short name for reports
+   static const char * name(event e)
+   {
+      static const char * names[NUM_EVENTS] =
+      { "cycles", "instructions", "L1d-misses", "LLC-misses",
+        "branch-misses", "dTLB-misses" };
+      return names[e];
+   }
+
+private:
+   int fds[NUM_EVENTS];   // one file descriptor per counter, -1 if none
+
+   // open one counter, disabled, or return -1
+   static int open(event e)
+   {
+#ifdef __linux__
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+
+      const std::uint64_t cacheRead = (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+      switch (e)
+      {
+         case CYCLES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+         case INSTRUCTIONS:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+         case L1D_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D | cacheRead;
+            break;
+         case LLC_MISSES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+         case BRANCH_MISSES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+         case DTLB_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_DTLB | cacheRead;
+            break;
+         default:
+            return -1;
+      }
+
+      // this thread, any CPU, no group
+      long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+      return fd < 0 ? -1 : (int)fd;
+#else
+      return -1;
+#endif // __linux__
+   }
+};
+
+} // namespace custom
@@ -0,0 +1,206 @@
+/***********************************************************************
+ * Header:
+ *    POOL
+ * Summary:
+ *    A slab allocator for small fixed-size blocks such as list nodes.
+ *    Every list node used to be its own trip through malloc(); with
+ *    this, a node is popped off a free list and pushed back on when
+ *    it is erased.
+ *
+ *    This will contain the class definition of:
+ *        slab_pool          : The free lists and the slabs behind them
+ *        pool_allocator<T>  : An allocator drawing from slab_pool
+ *
+ *    Blocks are grouped into size classes, a multiple of 16 bytes up
+ *    to 256 bytes. Each thread has its own free list per size class so
+ *    no locks are taken on the common path. When a free list runs dry
+ *    a 64 KiB slab is carved into blocks. When a thread ends its free
+ *    blocks go to a shared depot for the next thread to pick up. The
+ *    slabs themselves are kept for the life of the program.
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>     // for std::size_t
+#include <new>         // for ::operator new
+#include <mutex>       // for std::mutex
+
+namespace custom
+{
+
+/**************************************************
+ * SLAB POOL
+ * Size-class free lists, one set per thread
+ **************************************************/
+class slab_pool
+{
+public:
+   enum { ALIGN       = 16,                // every block is this aligned
+          MAX_SIZE    = 256,               // bigger goes to operator new
+          NUM_CLASSES = MAX_SIZE / ALIGN,
+          SLAB_SIZE   = 64 * 1024 };       // bytes carved at a time
+
+   // a block of at least size bytes
+   static void * allocate(std::size_t size)
+   {
+      if (size == 0 || size > MAX_SIZE)
+         return ::operator new(size);
+
+      int iClass = sizeClass(size);
+      Block *& pFree = cache().free[iClass];
+      if (nullptr == pFree)
+         refill(iClass);
+
+      Block * p = pFree;
+      pFree = p->pNext;
+      return p;
+   }
+
+   // give back a block from allocate(size)
+   static void deallocate(void * p, std::size_t size) noexcept
+   {
+      if (nullptr == p)
+         return;
+      if (size == 0 || size > MAX_SIZE)
+      {
+         ::operator delete(p);
+         return;
+      }
+
+      Block *& pFree = cache().free[sizeClass(size)];
+      Block * pBlock = static_cast<Block *>(p);
+      pBlock->pNext = pFree;
+      pFree = pBlock;
+   }
+
+   // the size class holding blocks of size bytes
+   static int sizeClass(std::size_t size) noexcept
+   {
+      return int((size + ALIGN - 1) / ALIGN) - 1;
+   }
+
+private:
+   // a free block is linked through its own storage
+   struct Block
+   {
+      Block * pNext;
+   };
+
+   // the blocks nobody is using, shared between threads
+   struct Depot
+   {
+      std::mutex mutex;
+      Block * free[NUM_CLASSES] = {};
+   };
+
+   // this thread's free lists
+   struct Cache
+   {
+      Block * free[NUM_CLASSES] = {};
+
+      // hand our free blocks to the depot so they are not lost
+     ~Cache()
+      {
+         Depot & d = depot();
+         std::lock_guard<std::mutex> lock(d.mutex);
+         for (int i = 0; i < NUM_CLASSES; i++)
+            while (free[i])
+            {
+               Block * p = free[i];
+               free[i] = p->pNext;
+               p->pNext = d.free[i];
+               d.free[i] = p;
+            }
+      }
+   };
+
+   static Depot & depot()
+   {
+      static Depot d;
+      return d;
+   }
+
+   static Cache & cache()
+   {
+      static thread_local Cache c;
+      return c;
+   }
+
+   // this thread is out of blocks: take the depot's, or carve a new slab
+   static void refill(int iClass)
+   {
+      Cache & c = cache();
+      {
+         Depot & d = depot();
+         std::lock_guard<std::mutex> lock(d.mutex);
+         if (d.free[iClass])
+         {
+            c.free[iClass] = d.free[iClass];
+            d.free[iClass] = nullptr;
+            return;
+         }
+      }
+
+      std::size_t size = (iClass + 1) * ALIGN;
+      char * pSlab = static_cast<char *>(::operator new(SLAB_SIZE));
+      for (std::size_t offset = 0; offset + size <= SLAB_SIZE; offset += size)
+      {
+         Block * p = reinterpret_cast<Block *>(pSlab + offset);
+         p->pNext = c.free[iClass];
+         c.free[iClass] = p;
+      }
+   }
+};
+
+/**************************************************
+ * POOL ALLOCATOR
+ * Single objects come from the slab pool; arrays and
+ * over-aligned types go to operator new as usual. A
+ * type aligned past what operator new gives asks for
+ * its alignment with std::align_val_t.
+ **************************************************/
+template <typename T>
+class pool_allocator
+{
+public:
+   typedef T value_type;
+
+   pool_allocator() noexcept {}
+   template <class U>
+   pool_allocator(const pool_allocator<U> &) noexcept {}
+
+   T * allocate(std::size_t n)
+   {
+      if (n == 1 && alignof(T) <= slab_pool::ALIGN)
+         return static_cast<T *>(slab_pool::allocate(sizeof(T)));
+      if (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+         return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+      return static_cast<T *>(::operator new(n * sizeof(T)));
+   }
+
+   void deallocate(T * p, std::size_t n) noexcept
+   {
+      if (n == 1 && alignof(T) <= slab_pool::ALIGN)
+         slab_pool::deallocate(p, sizeof(T));
+      else if (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+         ::operator delete(p, std::align_val_t(alignof(T)));
+      else
+         ::operator delete(p);
+   }
+};
+
+// every pool allocator draws from the same pool
+template <class T, class U>
+bool operator == (const pool_allocator<T> &, const pool_allocator<U> &) noexcept
+{
+   return true;
+}
+template <class T, class U>
+bool operator != (const pool_allocator<T> &, const pool_allocator<U> &) noexcept
+{
+   return false;
+}
+
+} // namespace custom
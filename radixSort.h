@@ -0,0 +1,186 @@
+/***********************************************************************
+ * Header:
+ *    RADIX SORT
+ * Summary:
+ *    Sort a custom::vector of numbers, or of pairs keyed on a number,
+ *    one byte of the key at a time instead of by comparing elements.
+ *    Each byte is a counting pass over the data, so sorting n keys of
+ *    k bytes costs k passes no matter how big n gets. For millions of
+ *    64-bit keys that beats a comparison sort several times over.
+ *
+ *    This will contain:
+ *        radix_key<T> : How a T becomes an unsigned key in sort order
+ *        radix_sort   : The least significant digit radix sort
+ *
+ *    Integers sort as themselves with the sign bit flipped. A float
+ *    or double has its sign bit flipped, and every other bit as well
+ *    when it is negative. A custom::pair sorts on its first. The sort
+ *    is stable.
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>     // for std::size_t
+#include <cstdint>     // for std::uint32_t
+#include <cstring>     // for std::memcpy
+#include <functional>  // for std::less
+#include <type_traits> // for std::make_unsigned
+#include <utility>     // for std::move
+#include "vector.h"    // for custom::vector
+#include "pair.h"      // for custom::pair
+
+namespace custom
+{
+
+/**************************************************
+ * RADIX KEY
+ * An unsigned integer for each T that sorts the same
+ * way T does. Only the types below have one.
+ **************************************************/
+template <class T, class Enable = void>
+struct radix_key;
+
+// integers: flip the sign bit so negatives come first
+template <class T>
+struct radix_key<T, typename std::enable_if<std::is_integral<T>::value &&
+                                            !std::is_same<T, bool>::value>::type>
+{
+   typedef typename std::make_unsigned<T>::type type;
+   static type get(const T & t)
+   {
+      type bits = static_cast<type>(t);
+      if (std::is_signed<T>::value)
+         bits ^= type(1) << (sizeof(T) * 8 - 1);
+      return bits;
+   }
+};
+
+// floating point: negatives are stored backwards, so flip all of them
+template <class T>
+struct radix_key<T, typename std::enable_if<std::is_floating_point<T>::value &&
+                                            sizeof(T) == 4>::type>
+{
+   typedef std::uint32_t type;
+   static type get(const T & t)
+   {
+      type bits;
+      std::memcpy(&bits, &t, sizeof(bits));
+      return (bits & 0x80000000u) ? ~bits : bits ^ 0x80000000u;
+   }
+};
+
+template <class T>
+struct radix_key<T, typename std::enable_if<std::is_floating_point<T>::value &&
+                                            sizeof(T) == 8>::type>
+{
+   typedef std::uint64_t type;
+   static type get(const T & t)
+   {
+      type bits;
+      std::memcpy(&bits, &t, sizeof(bits));
+      const type sign = type(1) << 63;
+      return (bits & sign) ? ~bits : bits ^ sign;
+   }
+};
+
+// a pair compared with std::less sorts on its first
+template <class T1, class T2>
+struct radix_key<pair<T1, T2, std::less<T1>>>
+{
+   typedef typename radix_key<T1>::type type;
+   static type get(const pair<T1, T2, std::less<T1>> & p)
+   {
+      return radix_key<T1>::get(p.first);
+   }
+};
+
+/**************************************************
+ * RADIX SORT
+ * One counting pass per byte of the key, least
+ * significant first, moving the elements back and
+ * forth between v and a second buffer. The counts
+ * for every byte come from a single read of the
+ * keys, and a byte that is the same in every key
+ * is skipped. Returns the number of passes made.
+ **************************************************/
+template <typename T, typename A>
+std::size_t radix_sort(vector <T, A> & v)
+{
+   typedef radix_key<T> Key;
+   typedef typename Key::type K;
+   const std::size_t NUM_DIGITS = sizeof(K);
+   std::size_t n = v.size();
+   if (n < 2)
+      return 0;
+
+   // a short vector is quicker by insertion, which is stable too
+   if (n <= 32)
+   {
+      for (std::size_t i = 1; i < n; i++)
+      {
+         T t(std::move(v[i]));
+         K key = Key::get(t);
+         std::size_t j = i;
+         for (; j > 0 && key < Key::get(v[j - 1]); j--)
+            v[j] = std::move(v[j - 1]);
+         v[j] = std::move(t);
+      }
+      return 0;
+   }
+
+   // how many keys have each value of each byte
+   std::size_t counts[NUM_DIGITS][256] = {};
+   const T * pData = &v.front();
+   for (std::size_t i = 0; i < n; i++)
+   {
+      K key = Key::get(pData[i]);
+      for (std::size_t d = 0; d < NUM_DIGITS; d++)
+         counts[d][(key >> (d * 8)) & 0xFF]++;
+   }
+
+   // the second buffer, from the same allocator
+   vector <T, A> buffer(v.get_allocator());
+   T * pFrom = &v.front();
+   T * pTo = nullptr;
+   std::size_t numPasses = 0;
+
+   for (std::size_t d = 0; d < NUM_DIGITS; d++)
+   {
+      // every key has the same byte here: nothing would move
+      std::size_t * count = counts[d];
+      if (count[(Key::get(pFrom[0]) >> (d * 8)) & 0xFF] == n)
+         continue;
+
+      if (nullptr == pTo)
+      {
+         buffer.resize(n);
+         pTo = &buffer.front();
+      }
+
+      // where the first key with each byte value goes
+      std::size_t offset[256];
+      std::size_t sum = 0;
+      for (int b = 0; b < 256; b++)
+      {
+         offset[b] = sum;
+         sum += count[b];
+      }
+
+      for (std::size_t i = 0; i < n; i++)
+         pTo[offset[(Key::get(pFrom[i]) >> (d * 8)) & 0xFF]++] = std::move(pFrom[i]);
+
+      T * pTemp = pFrom;
+      pFrom = pTo;
+      pTo = pTemp;
+      numPasses++;
+   }
+
+   // an odd number of passes leaves the answer in the buffer
+   if (numPasses % 2)
+      v.swap(buffer);
+   return numPasses;
+}
+
+} // namespace custom
@@ -0,0 +1,708 @@
+/***********************************************************************
+ * Header:
+ *    SIMD
+ * Summary:
+ *    Linear scans over a custom::vector of numbers, several elements
+ *    per instruction. A plain loop over vector::iterator compares one
+ *    element at a time; a 256-bit compare checks eight ints at once.
+ *
+ *    This will contain:
+ *        find, contains, count : look for a value
+ *        min, max              : the smallest and largest element
+ *        fill                  : set every element to a value
+ *
+ *    Integers of 4 or 8 bytes, float and double have vector paths.
+ *    Which one runs is decided once, at run time: AVX2 when the CPU
+ *    has it, SSE2 otherwise, and a plain loop on other CPUs or for
+ *    any other T. The answers are the same on every path, except
+ *    that min and max of floating point data with a NaN in it are
+ *    unspecified.
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>     // for std::size_t
+#include <cstdint>     // for std::int32_t
+#include <type_traits> // for std::is_integral
+#include "vector.h"    // for custom::vector
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define CUSTOM_SIMD_X86
+#define CUSTOM_SIMD_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>         // for the SSE2 and AVX2 intrinsics
+#elif defined(_M_X64) && defined(_MSC_VER)
+#define CUSTOM_SIMD_X86
+#define CUSTOM_SIMD_AVX2
+#include <immintrin.h>         // for the SSE2 and AVX2 intrinsics
+#include <intrin.h>            // for __cpuidex
+#endif
+
+namespace custom
+{
+namespace simd
+{
+
+/**************************************************
+ * LEVEL
+ * The widest instructions the kernels may use. The CPU
+ * is asked once; setLevel() can lower the level to
+ * compare paths. Each thread has its own level, so one
+ * thread lowering it does not change another's.
+ **************************************************/
+enum Level { SCALAR, SSE2, AVX2 };
+
+inline Level detect()
+{
+#if defined(CUSTOM_SIMD_X86) && defined(_MSC_VER)
+   int info[4];
+   __cpuidex(info, 1, 0);
+   bool osxsave = (info[2] & (1 << 27)) != 0;
+   __cpuidex(info, 7, 0);
+   bool avx2 = (info[1] & (1 << 5)) != 0;
+   return (osxsave && avx2 && (_xgetbv(0) & 6) == 6) ? AVX2 : SSE2;
+#elif defined(CUSTOM_SIMD_X86)
+   return __builtin_cpu_supports("avx2") ? AVX2 : SSE2;
+#else
+   return SCALAR;
+#endif
+}
+
+inline Level detected()
+{
+   static const Level most = detect();
+   return most;
+}
+
+inline Level & activeLevel()
+{
+   static thread_local Level level = detected();
+   return level;
+}
+
+inline Level level() { return activeLevel(); }
+
+// never above what the CPU has
+inline void setLevel(Level l)
+{
+   Level most = detected();
+   activeLevel() = l < most ? l : most;
+}
+
+/**************************************************
+ * LANES
+ * The type each T is processed as. Equality only
+ * needs the bits, so any integer of 4 or 8 bytes is
+ * compared as a signed one; ordering needs the sign.
+ * Everything else is its own lane: the plain loop.
+ **************************************************/
+template <class T, bool = std::is_integral<T>::value, std::size_t = sizeof(T)>
+struct lane                  { typedef T            type; };
+template <class T>
+struct lane<T, true, 4>      { typedef std::int32_t type; };
+template <class T>
+struct lane<T, true, 8>      { typedef std::int64_t type; };
+
+template <class T, bool = std::is_integral<T>::value, std::size_t = sizeof(T)>
+struct orderLane             { typedef T type; };
+template <class T>
+struct orderLane<T, true, 4>
+{
+   typedef typename std::conditional<std::is_signed<T>::value,
+                                     std::int32_t, std::uint32_t>::type type;
+};
+
+/**************************************************
+ * SCALAR KERNELS
+ * One element at a time. The vector kernels finish
+ * their last partial block with these.
+ **************************************************/
+template <class T>
+std::size_t findScalar(const T * p, std::size_t n, const T & t)
+{
+   std::size_t i = 0;
+   while (i < n && !(p[i] == t))
+      i++;
+   return i;
+}
+
+template <class T>
+std::size_t countScalar(const T * p, std::size_t n, const T & t)
+{
+   std::size_t c = 0;
+   for (std::size_t i = 0; i < n; i++)
+      if (p[i] == t)
+         c++;
+   return c;
+}
+
+template <class T>
+T minScalar(const T * p, std::size_t n)
+{
+   T m = p[0];
+   for (std::size_t i = 1; i < n; i++)
+      if (p[i] < m)
+         m = p[i];
+   return m;
+}
+
+template <class T>
+T maxScalar(const T * p, std::size_t n)
+{
+   T m = p[0];
+   for (std::size_t i = 1; i < n; i++)
+      if (m < p[i])
+         m = p[i];
+   return m;
+}
+
+template <class T>
+void fillScalar(T * p, std::size_t n, const T & t)
+{
+   for (std::size_t i = 0; i < n; i++)
+      p[i] = t;
+}
+
+#ifdef CUSTOM_SIMD_X86
+
+// the bits of a compare mask
+inline int lowestBit(unsigned mask)
+{
+   int i = 0;
+   for (; !(mask & 1u); mask >>= 1)
+      i++;
+   return i;
+}
+inline int numBits(unsigned mask)
+{
+   int c = 0;
+   for (; mask; mask &= mask - 1)
+      c++;
+   return c;
+}
+
+/**************************************************
+ * SSE2 OPERATIONS
+ * One 128-bit register of each lane type
+ **************************************************/
+struct Sse2Int32
+{
+   typedef std::int32_t T;
+   typedef __m128i V;
+   enum { W = 4 };
+   static V set1(T t)               { return _mm_set1_epi32(t); }
+   static V load(const T * p)       { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+   static void store(T * p, V v)    { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+   static unsigned eq(V a, V b)     { return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))); }
+   static V min(V a, V b)
+   {
+      V gt = _mm_cmpgt_epi32(a, b);
+      return _mm_or_si128(_mm_and_si128(gt, b), _mm_andnot_si128(gt, a));
+   }
+   static V max(V a, V b)
+   {
+      V gt = _mm_cmpgt_epi32(a, b);
+      return _mm_or_si128(_mm_and_si128(gt, a), _mm_andnot_si128(gt, b));
+   }
+};
+
+struct Sse2Int64
+{
+   typedef std::int64_t T;
+   typedef __m128i V;
+   enum { W = 2 };
+   static V set1(T t)               { return _mm_set1_epi64x(t); }
+   static void store(T * p, V v)    { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+};
+
+struct Sse2Float
+{
+   typedef float T;
+   typedef __m128 V;
+   enum { W = 4 };
+   static V set1(T t)               { return _mm_set1_ps(t); }
+   static V load(const T * p)       { return _mm_loadu_ps(p); }
+   static void store(T * p, V v)    { _mm_storeu_ps(p, v); }
+   static unsigned eq(V a, V b)     { return _mm_movemask_ps(_mm_cmpeq_ps(a, b)); }
+   static V min(V a, V b)           { return _mm_min_ps(a, b); }
+   static V max(V a, V b)           { return _mm_max_ps(a, b); }
+};
+
+struct Sse2Double
+{
+   typedef double T;
+   typedef __m128d V;
+   enum { W = 2 };
+   static V set1(T t)               { return _mm_set1_pd(t); }
+   static V load(const T * p)       { return _mm_loadu_pd(p); }
+   static void store(T * p, V v)    { _mm_storeu_pd(p, v); }
+   static unsigned eq(V a, V b)     { return _mm_movemask_pd(_mm_cmpeq_pd(a, b)); }
+   static V min(V a, V b)           { return _mm_min_pd(a, b); }
+   static V max(V a, V b)           { return _mm_max_pd(a, b); }
+};
+
+/**************************************************
+ * SSE2 KERNELS
+ * Whole registers first, then the plain loop for
+ * the few elements left over
+ **************************************************/
+template <class Ops>
+std::size_t findSse2(const typename Ops::T * p, std::size_t n, typename Ops::T t)
+{
+   typename Ops::V key = Ops::set1(t);
+   std::size_t i = 0;
+   for (; i + Ops::W <= n; i += Ops::W)
+   {
+      unsigned mask = Ops::eq(Ops::load(p + i), key);
+      if (mask)
+         return i + lowestBit(mask);
+   }
+   return i + findScalar(p + i, n - i, t);
+}
+
+template <class Ops>
+std::size_t countSse2(const typename Ops::T * p, std::size_t n, typename Ops::T t)
+{
+   typename Ops::V key = Ops::set1(t);
+   std::size_t c = 0;
+   std::size_t i = 0;
+   for (; i + Ops::W <= n; i += Ops::W)
+      c += numBits(Ops::eq(Ops::load(p + i), key));
+   return c + countScalar(p + i, n - i, t);
+}
+
+template <class Ops>
+typename Ops::T minSse2(const typename Ops::T * p, std::size_t n)
+{
+   if (n < Ops::W)
+      return minScalar(p, n);
+   typename Ops::V m = Ops::load(p);
+   std::size_t i = Ops::W;
+   for (; i + Ops::W <= n; i += Ops::W)
+      m = Ops::min(m, Ops::load(p + i));
+   typename Ops::T lanes[Ops::W];
+   Ops::store(lanes, m);
+   typename Ops::T result = minScalar(lanes, Ops::W);
+   for (; i < n; i++)
+      if (p[i] < result)
+         result = p[i];
+   return result;
+}
+
+template <class Ops>
+typename Ops::T maxSse2(const typename Ops::T * p, std::size_t n)
+{
+   if (n < Ops::W)
+      return maxScalar(p, n);
+   typename Ops::V m = Ops::load(p);
+   std::size_t i = Ops::W;
+   for (; i + Ops::W <= n; i += Ops::W)
+      m = Ops::max(m, Ops::load(p + i));
+   typename Ops::T lanes[Ops::W];
+   Ops::store(lanes, m);
+   typename Ops::T result = maxScalar(lanes, Ops::W);
+   for (; i < n; i++)
+      if (result < p[i])
+         result = p[i];
+   return result;
+}
+
+template <class Ops>
+void fillSse2(typename Ops::T * p, std::size_t n, typename Ops::T t)
+{
+   typename Ops::V v = Ops::set1(t);
+   std::size_t i = 0;
+   for (; i + Ops::W <= n; i += Ops::W)
+      Ops::store(p + i, v);
+   fillScalar(p + i, n - i, t);
+}
+
+/**************************************************
+ * AVX2 OPERATIONS
+ * One 256-bit register of each lane type
+ **************************************************/
+struct Avx2Int32
+{
+   typedef std::int32_t T;
+   typedef __m256i V;
+   enum { W = 8 };
+   CUSTOM_SIMD_AVX2 static V set1(T t)            { return _mm256_set1_epi32(t); }
+   CUSTOM_SIMD_AVX2 static V load(const T * p)    { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+   CUSTOM_SIMD_AVX2 static void store(T * p, V v) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+   CUSTOM_SIMD_AVX2 static unsigned eq(V a, V b)  { return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))); }
+   CUSTOM_SIMD_AVX2 static V min(V a, V b)        { return _mm256_min_epi32(a, b); }
+   CUSTOM_SIMD_AVX2 static V max(V a, V b)        { return _mm256_max_epi32(a, b); }
+};
+
+struct Avx2UInt32
+{
+   typedef std::uint32_t T;
+   typedef __m256i V;
+   enum { W = 8 };
+   CUSTOM_SIMD_AVX2 static V load(const T * p)    { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+   CUSTOM_SIMD_AVX2 static void store(T * p, V v) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+   CUSTOM_SIMD_AVX2 static V min(V a, V b)        { return _mm256_min_epu32(a, b); }
+   CUSTOM_SIMD_AVX2 static V max(V a, V b)        { return _mm256_max_epu32(a, b); }
+};
+
+struct Avx2Int64
+{
+   typedef std::int64_t T;
+   typedef __m256i V;
+   enum { W = 4 };
+   CUSTOM_SIMD_AVX2 static V set1(T t)            { return _mm256_set1_epi64x(t); }
+   CUSTOM_SIMD_AVX2 static V load(const T * p)    { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+   CUSTOM_SIMD_AVX2 static void store(T * p, V v) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+   CUSTOM_SIMD_AVX2 static unsigned eq(V a, V b)  { return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b))); }
+};
+
+struct Avx2Float
+{
+   typedef float T;
+   typedef __m256 V;
+   enum { W = 8 };
+   CUSTOM_SIMD_AVX2 static V set1(T t)            { return _mm256_set1_ps(t); }
+   CUSTOM_SIMD_AVX2 static V load(const T * p)    { return _mm256_loadu_ps(p); }
+   CUSTOM_SIMD_AVX2 static void store(T * p, V v) { _mm256_storeu_ps(p, v); }
+   CUSTOM_SIMD_AVX2 static unsigned eq(V a, V b)  { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+   CUSTOM_SIMD_AVX2 static V min(V a, V b)        { return _mm256_min_ps(a, b); }
+   CUSTOM_SIMD_AVX2 static V max(V a, V b)        { return _mm256_max_ps(a, b); }
+};
+
+struct Avx2Double
+{
+   typedef double T;
+   typedef __m256d V;
+   enum { W = 4 };
+   CUSTOM_SIMD_AVX2 static V set1(T t)            { return _mm256_set1_pd(t); }
+   CUSTOM_SIMD_AVX2 static V load(const T * p)    { return _mm256_loadu_pd(p); }
+   CUSTOM_SIMD_AVX2 static void store(T * p, V v) { _mm256_storeu_pd(p, v); }
+   CUSTOM_SIMD_AVX2 static unsigned eq(V a, V b)  { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+   CUSTOM_SIMD_AVX2 static V min(V a, V b)        { return _mm256_min_pd(a, b); }
+   CUSTOM_SIMD_AVX2 static V max(V a, V b)        { return _mm256_max_pd(a, b); }
+};
+
+/**************************************************
+ * AVX2 KERNELS
+ * The SSE2 kernels again, compiled for AVX2. They
+ * only run after detect() has seen it on this CPU.
+ **************************************************/
+template <class Ops>
+CUSTOM_SIMD_AVX2 std::size_t findAvx2(const typename Ops::T * p, std::size_t n, typename Ops::T t)
+{
+   typename Ops::V key = Ops::set1(t);
+   std::size_t i = 0;
+   for (; i + Ops::W <= n; i += Ops::W)
+   {
+      unsigned mask = Ops::eq(Ops::load(p + i), key);
+      if (mask)
+         return i + lowestBit(mask);
+   }
+   return i + findScalar(p + i, n - i, t);
+}
+
+template <class Ops>
+CUSTOM_SIMD_AVX2 std::size_t countAvx2(const typename Ops::T * p, std::size_t n, typename Ops::T t)
+{
+   typename Ops::V key = Ops::set1(t);
+   std::size_t c = 0;
+   std::size_t i = 0;
+   for (; i + Ops::W <= n; i += Ops::W)
+      c += numBits(Ops::eq(Ops::load(p + i), key));
+   return c + countScalar(p + i, n - i, t);
+}
+
+template <class Ops>
+CUSTOM_SIMD_AVX2 typename Ops::T minAvx2(const typename Ops::T * p, std::size_t n)
+{
+   if (n < Ops::W)
+      return minScalar(p, n);
+   typename Ops::V m = Ops::load(p);
+   std::size_t i = Ops::W;
+   for (; i + Ops::W <= n; i += Ops::W)
+      m = Ops::min(m, Ops::load(p + i));
+   typename Ops::T lanes[Ops::W];
+   Ops::store(lanes, m);
+   typename Ops::T result = minScalar(lanes, Ops::W);
+   for (; i < n; i++)
+      if (p[i] < result)
+         result = p[i];
+   return result;
+}
+
+template <class Ops>
+CUSTOM_SIMD_AVX2 typename Ops::T maxAvx2(const typename Ops::T * p, std::size_t n)
+{
+   if (n < Ops::W)
+      return maxScalar(p, n);
+   typename Ops::V m = Ops::load(p);
+   std::size_t i = Ops::W;
+   for (; i + Ops::W <= n; i += Ops::W)
+      m = Ops::max(m, Ops::load(p + i));
+   typename Ops::T lanes[Ops::W];
+   Ops::store(lanes, m);
+   typename Ops::T result = maxScalar(lanes, Ops::W);
+   for (; i < n; i++)
+      if (result < p[i])
+         result = p[i];
+   return result;
+}
+
+template <class Ops>
+CUSTOM_SIMD_AVX2 void fillAvx2(typename Ops::T * p, std::size_t n, typename Ops::T t)
+{
+   typename Ops::V v = Ops::set1(t);
+   std::size_t i = 0;
+   for (; i + Ops::W <= n; i += Ops::W)
+      Ops::store(p + i, v);
+   fillScalar(p + i, n - i, t);
+}
+
+#endif // CUSTOM_SIMD_X86
+
+/**************************************************
+ * DISPATCH
+ * One overload per lane with a vector path picks the
+ * kernel for level(). Any other lane takes the template:
+ * the plain loop.
+ **************************************************/
+template <class T>
+std::size_t findLane(const T * p, std::size_t n, const T & t) { return findScalar(p, n, t); }
+template <class T>
+std::size_t countLane(const T * p, std::size_t n, const T & t) { return countScalar(p, n, t); }
+template <class T>
+T minLane(const T * p, std::size_t n) { return minScalar(p, n); }
+template <class T>
+T maxLane(const T * p, std::size_t n) { return maxScalar(p, n); }
+template <class T>
+void fillLane(T * p, std::size_t n, const T & t) { fillScalar(p, n, t); }
+
+#ifdef CUSTOM_SIMD_X86
+inline std::size_t findLane(const std::int32_t * p, std::size_t n, const std::int32_t & t)
+{
+   return level() == AVX2 ? findAvx2<Avx2Int32>(p, n, t) : findSse2<Sse2Int32>(p, n, t);
+}
+inline std::size_t findLane(const std::int64_t * p, std::size_t n, const std::int64_t & t)
+{
+   return level() == AVX2 ? findAvx2<Avx2Int64>(p, n, t) : findScalar(p, n, t);
+}
+inline std::size_t findLane(const float * p, std::size_t n, const float & t)
+{
+   return level() == AVX2 ? findAvx2<Avx2Float>(p, n, t) : findSse2<Sse2Float>(p, n, t);
+}
+inline std::size_t findLane(const double * p, std::size_t n, const double & t)
+{
+   return level() == AVX2 ? findAvx2<Avx2Double>(p, n, t) : findSse2<Sse2Double>(p, n, t);
+}
+
+inline std::size_t countLane(const std::int32_t * p, std::size_t n, const std::int32_t & t)
+{
+   return level() == AVX2 ? countAvx2<Avx2Int32>(p, n, t) : countSse2<Sse2Int32>(p, n, t);
+}
+inline std::size_t countLane(const std::int64_t * p, std::size_t n, const std::int64_t & t)
+{
+   return level() == AVX2 ? countAvx2<Avx2Int64>(p, n, t) : countScalar(p, n, t);
+}
+inline std::size_t countLane(const float * p, std::size_t n, const float & t)
+{
+   return level() == AVX2 ? countAvx2<Avx2Float>(p, n, t) : countSse2<Sse2Float>(p, n, t);
+}
+inline std::size_t countLane(const double * p, std::size_t n, const double & t)
+{
+   return level() == AVX2 ? countAvx2<Avx2Double>(p, n, t) : countSse2<Sse2Double>(p, n, t);
+}
+
+inline std::int32_t minLane(const std::int32_t * p, std::size_t n)
+{
+   return level() == AVX2 ? minAvx2<Avx2Int32>(p, n) : minSse2<Sse2Int32>(p, n);
+}
+inline std::uint32_t minLane(const std::uint32_t * p, std::size_t n)
+{
+   return level() == AVX2 ? minAvx2<Avx2UInt32>(p, n) : minScalar(p, n);
+}
+inline float minLane(const float * p, std::size_t n)
+{
+   return level() == AVX2 ? minAvx2<Avx2Float>(p, n) : minSse2<Sse2Float>(p, n);
+}
+inline double minLane(const double * p, std::size_t n)
+{
+   return level() == AVX2 ? minAvx2<Avx2Double>(p, n) : minSse2<Sse2Double>(p, n);
+}
+
+inline std::int32_t maxLane(const std::int32_t * p, std::size_t n)
+{
+   return level() == AVX2 ? maxAvx2<Avx2Int32>(p, n) : maxSse2<Sse2Int32>(p, n);
+}
+inline std::uint32_t maxLane(const std::uint32_t * p, std::size_t n)
+{
+   return level() == AVX2 ? maxAvx2<Avx2UInt32>(p, n) : maxScalar(p, n);
+}
+inline float maxLane(const float * p, std::size_t n)
+{
+   return level() == AVX2 ? maxAvx2<Avx2Float>(p, n) : maxSse2<Sse2Float>(p, n);
+}
+inline double maxLane(const double * p, std::size_t n)
+{
+   return level() == AVX2 ? maxAvx2<Avx2Double>(p, n) : maxSse2<Sse2Double>(p, n);
+}
+
+inline void fillLane(std::int32_t * p, std::size_t n, const std::int32_t & t)
+{
+   level() == AVX2 ? fillAvx2<Avx2Int32>(p, n, t) : fillSse2<Sse2Int32>(p, n, t);
+}
+inline void fillLane(std::int64_t * p, std::size_t n, const std::int64_t & t)
+{
+   level() == AVX2 ? fillAvx2<Avx2Int64>(p, n, t) : fillSse2<Sse2Int64>(p, n, t);
+}
+inline void fillLane(float * p, std::size_t n, const float & t)
+{
+   level() == AVX2 ? fillAvx2<Avx2Float>(p, n, t) : fillSse2<Sse2Float>(p, n, t);
+}
+inline void fillLane(double * p, std::size_t n, const double & t)
+{
+   level() == AVX2 ? fillAvx2<Avx2Double>(p, n, t) : fillSse2<Sse2Double>(p, n, t);
+}
+#endif // CUSTOM_SIMD_X86
+
+/**************************************************
+ * SIMD :: FIND, COUNT, MIN, MAX, FILL
+ * Over n elements at p, whatever T is. A SCALAR level
+ * always takes the plain loop, and so does a T with no
+ * lane of numbers: the key is compared where it is,
+ * never copied.
+ **************************************************/
+template <class T>
+std::size_t find(const T * p, std::size_t n, const T & t, std::false_type)
+{
+   return findScalar(p, n, t);
+}
+
+template <class T>
+std::size_t find(const T * p, std::size_t n, const T & t, std::true_type)
+{
+   typedef typename lane<T>::type L;
+   if (level() == SCALAR)
+      return findScalar(p, n, t);
+   return findLane(reinterpret_cast<const L *>(p), n, static_cast<L>(t));
+}
+
+template <class T>
+std::size_t find(const T * p, std::size_t n, const T & t)
+{
+   return find(p, n, t, typename std::is_arithmetic<typename lane<T>::type>::type());
+}
+
+template <class T>
+std::size_t count(const T * p, std::size_t n, const T & t, std::false_type)
+{
+   return countScalar(p, n, t);
+}
+
+template <class T>
+std::size_t count(const T * p, std::size_t n, const T & t, std::true_type)
+{
+   typedef typename lane<T>::type L;
+   if (level() == SCALAR)
+      return countScalar(p, n, t);
+   return countLane(reinterpret_cast<const L *>(p), n, static_cast<L>(t));
+}
+
+template <class T>
+std::size_t count(const T * p, std::size_t n, const T & t)
+{
+   return count(p, n, t, typename std::is_arithmetic<typename lane<T>::type>::type());
+}
+
+template <class T>
+T min(const T * p, std::size_t n)
+{
+   typedef typename orderLane<T>::type L;
+   if (level() == SCALAR)
+      return minScalar(p, n);
+   return static_cast<T>(minLane(reinterpret_cast<const L *>(p), n));
+}
+
+template <class T>
+T max(const T * p, std::size_t n)
+{
+   typedef typename orderLane<T>::type L;
+   if (level() == SCALAR)
+      return maxScalar(p, n);
+   return static_cast<T>(maxLane(reinterpret_cast<const L *>(p), n));
+}
+
+template <class T>
+void fill(T * p, std::size_t n, const T & t)
+{
+   typedef typename lane<T>::type L;
+   if (level() == SCALAR)
+      return fillScalar(p, n, t);
+   fillLane(reinterpret_cast<L *>(p), n, static_cast<L>(t));
+}
+
+} // namespace simd
+
+/**************************************************
+ * FIND
+ * The first element equal to t, or end()
+ **************************************************/
+template <typename T, typename A>
+typename vector <T, A> ::iterator find(vector <T, A> & v, const T & t)
+{
+   if (v.empty())
+      return v.end();
+   return typename vector <T, A> ::iterator(&v.front() + simd::find(&v.front(), v.size(), t));
+}
+
+/**************************************************
+ * CONTAINS
+ * Is there an element equal to t?
+ **************************************************/
+template <typename T, typename A>
+bool contains(const vector <T, A> & v, const T & t)
+{
+   return !v.empty() && simd::find(&v.front(), v.size(), t) != v.size();
+}
+
+/**************************************************
+ * COUNT
+ * The number of elements equal to t
+ **************************************************/
+template <typename T, typename A>
+std::size_t count(const vector <T, A> & v, const T & t)
+{
+   return v.empty() ? 0 : simd::count(&v.front(), v.size(), t);
+}
+
+/**************************************************
+ * MIN and MAX
+ * The smallest and largest element. The vector must
+ * not be empty.
+ **************************************************/
+template <typename T, typename A>
+T min(const vector <T, A> & v)
+{
+   assert(!v.empty());
+   return simd::min(&v.front(), v.size());
+}
+
+template <typename T, typename A>
+T max(const vector <T, A> & v)
+{
+   assert(!v.empty());
+   return simd::max(&v.front(), v.size());
+}
+
+/**************************************************
+ * FILL
+ * Set every element to t
+ **************************************************/
+template <typename T, typename A>
+void fill(vector <T, A> & v, const T & t)
+{
+   if (!v.empty())
+      simd::fill(&v.front(), v.size(), t);
+}
+
+} // namespace custom
@@ -0,0 +1,467 @@
+/***********************************************************************
+ * Header:
+ *    SMALL VECTOR
+ * Summary:
+ *    A vector that keeps its first N elements inside the object itself.
+ *    Most of our vectors never hold more than a handful of elements,
+ *    yet custom::vector allocates on the very first push_back. This
+ *    one only goes to the allocator when the N+1st element arrives.
+ *
+ *    This will contain the class definition of:
+ *        small_vector           : A vector with room for N inline
+ *        small_vector::iterator : An iterator through it
+ *
+ *    The interface is that of custom::vector. Moving a small_vector
+ *    whose elements are inline moves them one at a time, so the
+ *    elements do not keep their addresses.
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>     // for assert
+#include <cstddef>     // for std::size_t
+#include <cstring>     // for std::memcpy
+#include <memory>      // for std::allocator
+#include <utility>     // for std::move
+#include "vector.h"    // for is_trivially_relocatable
+
+class TestSmallVector;   // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * SMALL VECTOR
+ * Just like custom::vector but with room for N
+ * elements before the allocator A is asked for any.
+ **************************************************/
+template <typename T, std::size_t N = 8, typename A = std::allocator<T>>
+class small_vector
+{
+   friend class ::TestSmallVector; // give unit tests access to the privates
+   static_assert(N >= 1, "there must be room for one element inline");
+public:
+   //
+   // Construct
+   //
+
+   small_vector() : data(inlineBuffer()), numCapacity(N), numElements(0) {}
+   explicit small_vector(const A & a) :
+      data(inlineBuffer()), numCapacity(N), numElements(0), alloc(a) {}
+   small_vector(std::size_t num) : small_vector()
+   {
+      resize(num);
+   }
+   small_vector(std::size_t num, const T & t) : small_vector()
+   {
+      resize(num, t);
+   }
+   small_vector(const std::initializer_list<T> & l) : small_vector()
+   {
+      reserve(l.size());
+      for (auto & t : l)
+         push_back(t);
+   }
+   small_vector(const small_vector & rhs) :
+      data(inlineBuffer()), numCapacity(N), numElements(0),
+      alloc(Traits::select_on_container_copy_construction(rhs.alloc))
+   {
+      *this = rhs;
+   }
+   small_vector(small_vector && rhs) :
+      data(inlineBuffer()), numCapacity(N), numElements(0), alloc(std::move(rhs.alloc))
+   {
+      if (rhs.isInline())
+      {
+         for (std::size_t i = 0; i < rhs.numElements; i++)
+            Traits::construct(alloc, data + i, std::move(rhs.data[i]));
+         numElements = rhs.numElements;
+         rhs.clear();
+      }
+      else
+         steal(rhs);
+   }
+  ~small_vector()
+   {
+      clear();
+      freeBuffer();
+   }
+
+   //
+   // Assign
+   //
+
+   small_vector & operator = (const small_vector & rhs);
+   small_vector & operator = (small_vector && rhs);
+   void swap(small_vector & rhs)
+   {
+      small_vector tmp(std::move(rhs));
+      rhs = std::move(*this);
+      *this = std::move(tmp);
+   }
+
+   //
+   // Iterator
+   //
+
+   class iterator;
+   iterator begin() { return iterator(data);               }
+   iterator end()   { return iterator(data + numElements); }
+
+   //
+   // Access
+   //
+
+         T & operator [] (std::size_t index)       { assert(index < numElements); return data[index]; }
+   const T & operator [] (std::size_t index) const { assert(index < numElements); return data[index]; }
+         T & front()       { assert(numElements > 0); return data[0];               }
+   const T & front() const { assert(numElements > 0); return data[0];               }
+         T & back()        { assert(numElements > 0); return data[numElements - 1]; }
+   const T & back()  const { assert(numElements > 0); return data[numElements - 1]; }
+
+   //
+   // Insert
+   //
+
+   void push_back(const T & t) { emplace_back(t);            }
+   void push_back(T && t)      { emplace_back(std::move(t)); }
+   template <class... Args>
+   T & emplace_back(Args&&... args);
+   template <class... Args>
+   iterator emplace(iterator it, Args&&... args);
+   void reserve(std::size_t newCapacity)
+   {
+      if (newCapacity > numCapacity)
+         reallocate(newCapacity);
+   }
+   void resize(std::size_t newElements);
+   void resize(std::size_t newElements, const T & t);
+
+   //
+   // Remove
+   //
+
+   void clear()
+   {
+      destroy(0, numElements);
+      numElements = 0;
+   }
+   void pop_back()
+   {
+      if (numElements)
+         Traits::destroy(alloc, data + --numElements);
+   }
+   void shrink_to_fit();
+
+   //
+   // Status
+   //
+
+   std::size_t size()     const { return numElements; }
+   std::size_t capacity() const { return numCapacity; }
+   bool empty()           const { return numElements == 0; }
+   A get_allocator()      const { return alloc; }
+
+private:
+   typedef std::allocator_traits<A> Traits;
+
+   // the elements live here until there are more than N
+   T * inlineBuffer()             { return reinterpret_cast<T *>(storage); }
+   bool isInline() const          { return data == reinterpret_cast<const T *>(storage); }
+
+   // give back the heap buffer, if there is one; the elements must already be gone
+   void freeBuffer()
+   {
+      if (!isInline())
+         Traits::deallocate(alloc, data, numCapacity);
+      data = inlineBuffer();
+      numCapacity = N;
+   }
+
+   // take rhs's heap buffer, leaving it inline and empty
+   void steal(small_vector & rhs)
+   {
+      assert(!rhs.isInline());
+      data = rhs.data;
+      numCapacity = rhs.numCapacity;
+      numElements = rhs.numElements;
+      rhs.data = rhs.inlineBuffer();
+      rhs.numCapacity = N;
+      rhs.numElements = 0;
+   }
+
+   // destroy the elements in [iBegin, iEnd)
+   void destroy(std::size_t iBegin, std::size_t iEnd)
+   {
+      for (std::size_t i = iBegin; i < iEnd; i++)
+         Traits::destroy(alloc, data + i);
+   }
+
+   // move the elements into pNew and end their lives here
+   void relocate(T * pNew, std::true_type)
+   {
+      if (numElements)
+         std::memcpy(static_cast<void *>(pNew), static_cast<const void *>(data),
+                     numElements * sizeof(T));
+   }
+   void relocate(T * pNew, std::false_type);
+
+   // move everything to a buffer of newCapacity, inline if it fits
+   void reallocate(std::size_t newCapacity);
+
+   // the allocator follows the buffer only when it says it should
+   void moveAllocator(A & rhs, std::true_type) { alloc = std::move(rhs); }
+   void moveAllocator(A &,     std::false_type) { }
+
+   T * data;                  // the inline storage or a buffer from the allocator
+   std::size_t numCapacity;   // N while inline
+   std::size_t numElements;   // the number of items currently used
+   A alloc;                   // where a buffer comes from
+   alignas(T) unsigned char storage[N * sizeof(T)];   // the first N elements
+};
+
+/**************************************************
+ * SMALL VECTOR ITERATOR
+ * A pointer into the elements, wherever they are
+ **************************************************/
+template <typename T, std::size_t N, typename A>
+class small_vector <T, N, A> ::iterator
+{
+   friend class ::TestSmallVector;
+   friend class small_vector;
+public:
+   iterator() : p(nullptr) {}
+   iterator(T * p) : p(p) {}
+
+   bool operator != (const iterator & rhs) const { return p != rhs.p; }
+   bool operator == (const iterator & rhs) const { return p == rhs.p; }
+
+   T & operator * () { return *p; }
+
+   iterator & operator ++ ()    { p++; return *this; }
+   iterator   operator ++ (int) { iterator tmp(*this); p++; return tmp; }
+   iterator & operator -- ()    { p--; return *this; }
+   iterator   operator -- (int) { iterator tmp(*this); p--; return tmp; }
+
+private:
+   T * p;
+};
+
+/***************************************
+ * SMALL VECTOR :: ASSIGNMENT
+ * Copy the elements of rhs, assigning onto
+ * the ones we have and building or destroying
+ * the rest
+ *     INPUT  : rhs the vector to copy from
+ *     OUTPUT : *this
+ **************************************/
+template <typename T, std::size_t N, typename A>
+small_vector <T, N, A> & small_vector <T, N, A> :: operator = (const small_vector & rhs)
+{
+   if (this == &rhs)
+      return *this;
+
+   if (rhs.numElements > numCapacity)
+   {
+      clear();
+      reserve(rhs.numElements);
+   }
+
+   std::size_t numAssign = rhs.numElements < numElements ? rhs.numElements : numElements;
+   for (std::size_t i = 0; i < numAssign; i++)
+      data[i] = rhs.data[i];
+   for (std::size_t i = numElements; i < rhs.numElements; i++)
+   {
+      Traits::construct(alloc, data + i, rhs.data[i]);
+      numElements++;
+   }
+   destroy(rhs.numElements, numElements);
+   numElements = rhs.numElements;
+   return *this;
+}
+
+/***************************************
+ * SMALL VECTOR :: MOVE ASSIGNMENT
+ * Take rhs's heap buffer if it has one we may
+ * keep. Otherwise move its elements one at a time.
+ *     INPUT  : rhs the vector to move from
+ *     OUTPUT : *this
+ **************************************/
+template <typename T, std::size_t N, typename A>
+small_vector <T, N, A> & small_vector <T, N, A> :: operator = (small_vector && rhs)
+{
+   if (this == &rhs)
+      return *this;
+   clear();
+
+   if (!rhs.isInline() &&
+       (Traits::propagate_on_container_move_assignment::value || alloc == rhs.alloc))
+   {
+      freeBuffer();
+      moveAllocator(rhs.alloc, typename Traits::propagate_on_container_move_assignment());
+      steal(rhs);
+      return *this;
+   }
+
+   reserve(rhs.numElements);
+   for (std::size_t i = 0; i < rhs.numElements; i++)
+   {
+      Traits::construct(alloc, data + i, std::move(rhs.data[i]));
+      numElements++;
+   }
+   rhs.clear();
+   return *this;
+}
+
+/***************************************
+ * SMALL VECTOR :: RELOCATE
+ * Move the elements to pNew, copying instead if
+ * T's move could throw
+ *     INPUT  : pNew room for numElements
+ *     OUTPUT :
+ **************************************/
+template <typename T, std::size_t N, typename A>
+void small_vector <T, N, A> :: relocate(T * pNew, std::false_type)
+{
+   std::size_t i = 0;
+   try
+   {
+      for (; i < numElements; i++)
+         Traits::construct(alloc, pNew + i, std::move_if_noexcept(data[i]));
+   }
+   catch (...)
+   {
+      while (i--)
+         Traits::destroy(alloc, pNew + i);
+      throw;
+   }
+   destroy(0, numElements);
+}
+
+/***************************************
+ * SMALL VECTOR :: REALLOCATE
+ * Move the elements to a buffer of newCapacity.
+ * A capacity of N or less goes back inline.
+ *     INPUT  : newCapacity at least numElements
+ *     OUTPUT :
+ **************************************/
+template <typename T, std::size_t N, typename A>
+void small_vector <T, N, A> :: reallocate(std::size_t newCapacity)
+{
+   assert(newCapacity >= numElements);
+   bool toInline = newCapacity <= N;
+   if (toInline && isInline())
+      return;
+
+   T * pNew = toInline ? inlineBuffer() : Traits::allocate(alloc, newCapacity);
+   try
+   {
+      relocate(pNew, typename is_trivially_relocatable<T>::type());
+   }
+   catch (...)
+   {
+      if (!toInline)
+         Traits::deallocate(alloc, pNew, newCapacity);
+      throw;
+   }
+
+   if (!isInline())
+      Traits::deallocate(alloc, data, numCapacity);
+   data = pNew;
+   numCapacity = toInline ? N : newCapacity;
+}
+
+/***************************************
+ * SMALL VECTOR :: EMPLACE
+ * Build a new element in place from the arguments
+ * to one of T's constructors
+ *     INPUT  : where the element goes: the back,
+ *              or in front of it
+ *              the arguments for T's constructor
+ *     OUTPUT : the new element
+ **************************************/
+template <typename T, std::size_t N, typename A>
+template <class... Args>
+T & small_vector <T, N, A> :: emplace_back(Args&&... args)
+{
+   assert(numElements <= numCapacity);
+
+   // the arguments may refer to an element, so build it before the move
+   if (numElements == numCapacity)
+   {
+      T t(std::forward<Args>(args)...);
+      reallocate(numCapacity * 2);
+      Traits::construct(alloc, data + numElements, std::move(t));
+   }
+   else
+      Traits::construct(alloc, data + numElements, std::forward<Args>(args)...);
+   return data[numElements++];
+}
+
+template <typename T, std::size_t N, typename A>
+template <class... Args>
+typename small_vector <T, N, A> ::iterator small_vector <T, N, A> ::emplace(iterator it, Args&&... args)
+{
+   std::size_t index = it.p ? it.p - data : 0;
+   assert(index <= numElements);
+   if (index == numElements)
+   {
+      emplace_back(std::forward<Args>(args)...);
+      return iterator(data + index);
+   }
+
+   // build it first: the arguments may refer to an element we are about to slide
+   T t(std::forward<Args>(args)...);
+   emplace_back(std::move(data[numElements - 1]));
+   for (std::size_t i = numElements - 2; i > index; i--)
+      data[i] = std::move(data[i - 1]);
+   data[index] = std::move(t);
+   return iterator(data + index);
+}
+
+/***************************************
+ * SMALL VECTOR :: RESIZE
+ * Grow with default or copied elements, or
+ * shrink by destroying the ones at the back
+ *     INPUT  : newElements the new size
+ *              t the value for new elements
+ *     OUTPUT :
+ **************************************/
+template <typename T, std::size_t N, typename A>
+void small_vector <T, N, A> :: resize(std::size_t newElements)
+{
+   reserve(newElements);
+   while (numElements < newElements)
+      emplace_back();
+   destroy(newElements, numElements);
+   numElements = newElements;
+}
+
+template <typename T, std::size_t N, typename A>
+void small_vector <T, N, A> :: resize(std::size_t newElements, const T & t)
+{
+   reserve(newElements);
+   while (numElements < newElements)
+      emplace_back(t);
+   destroy(newElements, numElements);
+   numElements = newElements;
+}
+
+/***************************************
+ * SMALL VECTOR :: SHRINK TO FIT
+ * Give back any spare heap capacity, moving the
+ * elements back inline if they fit
+ *     INPUT  :
+ *     OUTPUT :
+ **************************************/
+template <typename T, std::size_t N, typename A>
+void small_vector <T, N, A> :: shrink_to_fit()
+{
+   if (isInline() || numCapacity == numElements)
+      return;
+   reallocate(numElements);
+}
+
+} // namespace custom
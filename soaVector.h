@@ -0,0 +1,271 @@
+/***********************************************************************
+ * Header:
+ *    SOA VECTOR
+ * Summary:
+ *    A vector of custom::pair records stored as a struct of arrays:
+ *    every first in one array, every second in another. A scan that
+ *    only looks at first reads only the firsts, packed together, and
+ *    none of the seconds.
+ *
+ *    This will contain the class definitions of:
+ *        span<T>                 : A pointer and a count
+ *        soa_vector<pair<T1,T2>> : The two arrays, kept the same size
+ *        soa_vector::reference   : A pair of references standing in
+ *                                  for a pair
+ *        soa_vector::iterator    : An iterator through the records
+ *
+ *    A record is not a pair in memory, so *it and v[i] are references
+ *    to its first and second rather than a pair&. Assigning a pair to
+ *    one writes both; converting one to a pair copies both.
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>     // for assert
+#include <cstddef>     // for std::size_t
+#include <memory>      // for std::allocator_traits
+#include <utility>     // for std::move
+#include "vector.h"    // for the two arrays
+#include "pair.h"      // for custom::pair
+
+class TestSoaVector;   // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * SPAN
+ * A view of n contiguous T, owned by someone else
+ **************************************************/
+template <typename T>
+class span
+{
+public:
+   span() : p(nullptr), n(0) {}
+   span(T * p, std::size_t n) : p(p), n(n) {}
+
+   T * data()                               const { return p;     }
+   std::size_t size()                       const { return n;     }
+   bool empty()                             const { return n == 0; }
+   T & operator [] (std::size_t index)      const { assert(index < n); return p[index]; }
+   T * begin()                              const { return p;     }
+   T * end()                                const { return p + n; }
+
+private:
+   T * p;
+   std::size_t n;
+};
+
+/**************************************************
+ * SOA VECTOR
+ * Only a vector of custom::pair can be split in two
+ **************************************************/
+template <typename P, typename A = std::allocator<P>>
+class soa_vector;
+
+template <typename T1, typename T2, typename C, typename A>
+class soa_vector <pair<T1, T2, C>, A>
+{
+   friend class ::TestSoaVector; // give unit tests access to the privates
+public:
+   typedef pair<T1, T2, C> value_type;
+   class reference;
+   class const_reference;
+   class iterator;
+
+   //
+   // Construct
+   //
+
+   soa_vector() {}
+   explicit soa_vector(const A & a) : firstsVec(A1(a)), secondsVec(A2(a)) {}
+   soa_vector(const std::initializer_list<value_type> & l)
+   {
+      reserve(l.size());
+      for (auto & p : l)
+         push_back(p);
+   }
+
+   //
+   // Assign
+   //
+
+   void swap(soa_vector & rhs)
+   {
+      firstsVec.swap(rhs.firstsVec);
+      secondsVec.swap(rhs.secondsVec);
+   }
+
+   //
+   // Iterator
+   //
+
+   iterator begin() { return iterator(this, 0);      }
+   iterator end()   { return iterator(this, size()); }
+
+   //
+   // Access
+   //
+
+   reference       operator [] (std::size_t i)       { return reference(firstsVec[i], secondsVec[i]);       }
+   const_reference operator [] (std::size_t i) const { return const_reference(firstsVec[i], secondsVec[i]); }
+   reference       front()       { return (*this)[0];          }
+   const_reference front() const { return (*this)[0];          }
+   reference       back()        { return (*this)[size() - 1]; }
+   const_reference back()  const { return (*this)[size() - 1]; }
+
+   // each half on its own, packed
+   span<T1>       firsts()        { return makeSpan(firstsVec);  }
+   span<const T1> firsts()  const { return makeSpan(firstsVec);  }
+   span<T2>       seconds()       { return makeSpan(secondsVec); }
+   span<const T2> seconds() const { return makeSpan(secondsVec); }
+
+   //
+   // Insert
+   //
+
+   void push_back(const value_type & p) { emplace_back(p.first, p.second); }
+   void push_back(value_type && p)      { emplace_back(std::move(p.first), std::move(p.second)); }
+   template <class U1, class U2>
+   reference emplace_back(U1 && first, U2 && second)
+   {
+      firstsVec.emplace_back(std::forward<U1>(first));
+      try
+      {
+         secondsVec.emplace_back(std::forward<U2>(second));
+      }
+      catch (...)
+      {
+         firstsVec.pop_back();   // keep the two the same size
+         throw;
+      }
+      return back();
+   }
+   void reserve(std::size_t newCapacity)
+   {
+      firstsVec.reserve(newCapacity);
+      secondsVec.reserve(newCapacity);
+   }
+   void resize(std::size_t newElements)
+   {
+      firstsVec.resize(newElements);
+      secondsVec.resize(newElements);
+   }
+
+   //
+   // Remove
+   //
+
+   void clear()
+   {
+      firstsVec.clear();
+      secondsVec.clear();
+   }
+   void pop_back()
+   {
+      firstsVec.pop_back();
+      secondsVec.pop_back();
+   }
+   void shrink_to_fit()
+   {
+      firstsVec.shrink_to_fit();
+      secondsVec.shrink_to_fit();
+   }
+
+   //
+   // Status
+   //
+
+   std::size_t size()     const { return firstsVec.size();     }
+   std::size_t capacity() const { return firstsVec.capacity(); }
+   bool empty()           const { return firstsVec.empty();    }
+
+private:
+   typedef typename std::allocator_traits<A>::template rebind_alloc<T1> A1;
+   typedef typename std::allocator_traits<A>::template rebind_alloc<T2> A2;
+
+   template <class V>
+   static auto makeSpan(V & v) -> span<typename std::remove_reference<decltype(v[0])>::type>
+   {
+      typedef typename std::remove_reference<decltype(v[0])>::type T;
+      return v.empty() ? span<T>() : span<T>(&v[0], v.size());
+   }
+
+   vector<T1, A1> firstsVec;    // every first
+   vector<T2, A2> secondsVec;   // every second, in the same order
+};
+
+/**************************************************
+ * SOA VECTOR REFERENCE
+ * Stands in for pair& : its first and second are
+ * references into the two arrays
+ **************************************************/
+template <typename T1, typename T2, typename C, typename A>
+class soa_vector <pair<T1, T2, C>, A> ::reference
+{
+public:
+   reference(T1 & first, T2 & second) : first(first), second(second) {}
+
+   // write both halves
+   reference & operator = (const value_type & rhs)
+   {
+      first = rhs.first;
+      second = rhs.second;
+      return *this;
+   }
+   reference & operator = (const reference & rhs)
+   {
+      first = rhs.first;
+      second = rhs.second;
+      return *this;
+   }
+
+   // copy both halves out
+   operator value_type () const { return value_type(first, second); }
+
+   T1 & first;
+   T2 & second;
+};
+
+template <typename T1, typename T2, typename C, typename A>
+class soa_vector <pair<T1, T2, C>, A> ::const_reference
+{
+public:
+   const_reference(const T1 & first, const T2 & second) : first(first), second(second) {}
+
+   operator value_type () const { return value_type(first, second); }
+
+   const T1 & first;
+   const T2 & second;
+};
+
+/**************************************************
+ * SOA VECTOR ITERATOR
+ * An index into both arrays
+ **************************************************/
+template <typename T1, typename T2, typename C, typename A>
+class soa_vector <pair<T1, T2, C>, A> ::iterator
+{
+   friend class ::TestSoaVector;
+public:
+   iterator() : pVector(nullptr), index(0) {}
+   iterator(soa_vector * pVector, std::size_t index) : pVector(pVector), index(index) {}
+
+   bool operator != (const iterator & rhs) const { return index != rhs.index || pVector != rhs.pVector; }
+   bool operator == (const iterator & rhs) const { return !(*this != rhs); }
+
+   reference operator * () const { return (*pVector)[index]; }
+
+   iterator & operator ++ ()    { index++; return *this; }
+   iterator   operator ++ (int) { iterator tmp(*this); index++; return tmp; }
+   iterator & operator -- ()    { index--; return *this; }
+   iterator   operator -- (int) { iterator tmp(*this); index--; return tmp; }
+
+private:
+   soa_vector * pVector;
+   std::size_t index;
+};
+
+} // namespace custom
@@ -10,6 +10,11 @@
 #pragma once
 
 #include <cassert>
+#include <cstdint>     // for std::uint64_t
+#include <atomic>      // for std::atomic
+#include <mutex>       // for std::mutex
+#include <set>         // for std::set
+#include <functional>  // for std::hash
 
 enum { ALLOC,      // 0  allocations, number of times NEW is called
        DELETE,     // 1  deletions, number of times DELETE is called
@@ -23,8 +28,84 @@ enum { ALLOC,      // 0  allocations, number of times NEW is called
        EQUALS,     // 9  Spy::operator==(const Spy &)
        LESSTHAN,   // 10 Spy::operator<(const Spy &)
        SWAP,       // 11 Spy::swap()
+       HASH,       // 12 std::hash<Spy>()
        NUM_MARKERS};
 
+/*************************************************************
+ * SPY COUNTERS
+ * One thread's counters. Only the owning thread writes them, but
+ * Spy::total() reads them from other threads so each is atomic.
+ * When the thread ends, its counts are folded into the retired
+ * totals so they are not lost.
+ *************************************************************/
+class SpyCounters
+{
+public:
+   SpyCounters()
+   {
+      for (int i = 0; i < NUM_MARKERS; i++)
+         values[i].store(0, std::memory_order_relaxed);
+      std::lock_guard<std::mutex> lock(registry().mutex);
+      registry().live.insert(this);
+   }
+  ~SpyCounters()
+   {
+      std::lock_guard<std::mutex> lock(registry().mutex);
+      for (int i = 0; i < NUM_MARKERS; i++)
+         registry().retired[i] += get(i);
+      registry().live.erase(this);
+   }
+
+   // only the owning thread increments, so no read-modify-write is needed
+   void increment(int marker) noexcept
+   {
+      values[marker].store(get(marker) + 1, std::memory_order_relaxed);
+   }
+   std::uint64_t get(int marker) const noexcept
+   {
+      return values[marker].load(std::memory_order_relaxed);
+   }
+   void reset() noexcept
+   {
+      for (int i = 0; i < NUM_MARKERS; i++)
+         values[i].store(0, std::memory_order_relaxed);
+   }
+
+   // the sum of the counters of every thread, living or finished
+   static std::uint64_t total(int marker)
+   {
+      std::lock_guard<std::mutex> lock(registry().mutex);
+      std::uint64_t sum = registry().retired[marker];
+      for (auto pCounters : registry().live)
+         sum += pCounters->get(marker);
+      return sum;
+   }
+   static void resetTotal()
+   {
+      std::lock_guard<std::mutex> lock(registry().mutex);
+      for (int i = 0; i < NUM_MARKERS; i++)
+         registry().retired[i] = 0;
+      for (auto pCounters : registry().live)
+         pCounters->reset();
+   }
+
+private:
+   std::atomic<std::uint64_t> values[NUM_MARKERS];
+
+   // every thread's counters, so they can be added together
+   struct Registry
+   {
+      std::mutex mutex;
+      std::set<SpyCounters *> live;
+      std::uint64_t retired[NUM_MARKERS] = {};
+   };
+   static Registry & registry()
+   {
+      static Registry registry;
+      return registry;
+   }
+};
+
 /*************************************************************
  * SPY
  * A mock class that records how it was used
@@ -36,14 +117,14 @@ public:
    int * p;
    
    // default constructor: allocate a spot and assign to zero
-   Spy() : p(nullptr) { counters[DEFAULT]++; }
+   Spy() : p(nullptr) { counters.increment(DEFAULT); }
    
    // non-default constructor: allocate a spot and assign to the value
    Spy(int value) : p(nullptr)
    {
       allocate();
       *p = value;
-      counters[NONDEFAULT]++;
+      counters.increment(NONDEFAULT);
    }
    
    // copy constructor: make a new copy
@@ -54,7 +135,7 @@ public:
          allocate();
          *p = rhs.get();
       }
-      counters[COPY]++;
+      counters.increment(COPY);
    }
    
    // move constructor: steal the data from the RHS
@@ -67,7 +148,7 @@ public:
       }
       else
          p = nullptr;
-      counters[COPY_MOVE]++;
+      counters.increment(COPY_MOVE);
    }
    
    // delete - remove the instance
@@ -75,7 +156,7 @@ public:
    {
       if (!empty())
          unallocate();
-      counters[DESTRUCTOR]++;
+      counters.increment(DESTRUCTOR);
    }
 
    // copy assignment operator
@@ -89,7 +170,7 @@ public:
       }
       else if (!empty())
          unallocate();
-      counters[ASSIGN]++;
+      counters.increment(ASSIGN);
       return *this;
    }
    
@@ -100,7 +181,7 @@ public:
          unallocate();
       p = rhs.p;
       rhs.p = nullptr;
-      counters[ASSIGN_MOVE]++;
+      counters.increment(ASSIGN_MOVE);
       return *this;
    }
    
@@ -110,7 +191,7 @@ public:
       int * pTemp = rhs.p;
       rhs.p = p;
       p = pTemp;
-      counters[SWAP]++;
+      counters.increment(SWAP);
    }
    
    // is this pointer empty?
@@ -136,7 +217,7 @@ public:
    // compare the values
    bool operator==(const Spy & rhs) const noexcept
    {
-      counters[EQUALS]++;
+      counters.increment(EQUALS);
       if (rhs.empty() && empty())
          return true;
       if (!rhs.empty() && !empty())
@@ -147,7 +228,7 @@ public:
    // a null value is assumed to be the smallest value
    bool operator<(const Spy & rhs) const noexcept
    {
-      counters[LESSTHAN]++;
+      counters.increment(LESSTHAN);
       if (rhs.empty() && empty())
          return false;
       if (!rhs.empty() && !empty())
@@ -158,28 +239,38 @@ public:
          return false;
    }
    
-   // reset the counters for a new test
+   // reset this thread's counters for a new test
    static void reset() noexcept
    {
-      for (int i = 0; i < NUM_MARKERS; i++)
-         counters[i] = 0;
-   }
-   
-   static int numAlloc()       { return counters[ALLOC];      }
-   static int numDelete()      { return counters[DELETE];     }
-   static int numDefault()     { return counters[DEFAULT];    }
-   static int numNondefault()  { return counters[NONDEFAULT]; }
-   static int numCopy()        { return counters[COPY];       }
-   static int numCopyMove()    { return counters[COPY_MOVE];  }
-   static int numDestructor()  { return counters[DESTRUCTOR]; }
-   static int numAssign()      { return counters[ASSIGN];     }
-   static int numAssignMove()  { return counters[ASSIGN_MOVE];}
-   static int numEquals()      { return counters[EQUALS];     }
-   static int numLessthan()    { return counters[LESSTHAN];   }
-   static int numSwap()        { return counters[SWAP];       }
+      counters.reset();
+   }
 
-   // keep track of how it is used
-   static int counters[NUM_MARKERS];
+   // reset the counters of every thread for a new benchmark
+   static void resetTotal()
+   {
+      SpyCounters::resetTotal();
+   }
+   
+   // the counts made by this thread
+   static std::uint64_t numAlloc()       { return counters.get(ALLOC);      }
+   static std::uint64_t numDelete()      { return counters.get(DELETE);     }
+   static std::uint64_t numDefault()     { return counters.get(DEFAULT);    }
+   static std::uint64_t numNondefault()  { return counters.get(NONDEFAULT); }
+   static std::uint64_t numCopy()        { return counters.get(COPY);       }
+   static std::uint64_t numCopyMove()    { return counters.get(COPY_MOVE);  }
+   static std::uint64_t numDestructor()  { return counters.get(DESTRUCTOR); }
+   static std::uint64_t numAssign()      { return counters.get(ASSIGN);     }
+   static std::uint64_t numAssignMove()  { return counters.get(ASSIGN_MOVE);}
+   static std::uint64_t numEquals()      { return counters.get(EQUALS);     }
+   static std::uint64_t numLessthan()    { return counters.get(LESSTHAN);   }
+   static std::uint64_t numSwap()        { return counters.get(SWAP);       }
+   static std::uint64_t numHash()        { return counters.get(HASH);       }
+
+   // the counts made by all the threads together
+   static std::uint64_t total(int marker) { return SpyCounters::total(marker); }
+
+   // keep track of how it is used, one set of counters per thread
+   static thread_local SpyCounters counters;
 private:
    
    // allocate a new buffer
@@ -187,7 +278,7 @@ private:
    {
       assert(p == nullptr);
       p = new int;
-      counters[ALLOC]++;
+      counters.increment(ALLOC);
    }
    
    // free the buffer
@@ -196,7 +287,7 @@ private:
       assert(p != nullptr);
       delete p;
       p = nullptr;
-      counters[DELETE]++;
+      counters.increment(DELETE);
    }
    
 };
@@ -206,3 +297,20 @@ inline void swap(Spy & s1, Spy & s2)
 {
    s1.swap(s2);
 }
+
+/*************************************************************
+ * HASH
+ * Hash a Spy by its value so it can be a key in a hash. The
+ * null value hashes to zero.
+ *************************************************************/
+namespace std
+{
+   template <> struct hash<Spy>
+   {
+      std::size_t operator()(const Spy & s) const noexcept
+      {
+         Spy::counters.increment(HASH);
+         return s.empty() ? 0 : std::hash<int>()(s.get());
+      }
+   };
+}
@@ -0,0 +1,207 @@
+/***********************************************************************
+ * Header:
+ *    TEST ALLOC TRACKER
+ * Summary:
+ *    Unit tests for the allocation tracker
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+#ifdef DEBUG
+
+#include "allocTracker.h"  // class under test
+#include "unitTest.h"      // unit test baseclass
+
+/***********************************************
+ * TEST ALLOC TRACKER
+ * Unit tests for the AllocTracker class
+ ***********************************************/
+class TestAllocTracker : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Size Class
+      addTest(test_sizeClass_small);
+      addTest(test_sizeClass_powerOfTwo);
+      addTest(test_sizeClass_huge);
+
+      // New and Delete
+      addTest(test_new_single);
+      addTest(test_delete_single);
+      addTest(test_newArray_single);
+      addTest(test_peak_twoAlive);
+      addTest(test_histogram_sizes);
+      addTest(test_new_overAligned);
+
+      runTests();
+      report("AllocTracker");
+   }
+
+   /***************************************
+    * SIZE CLASS
+    *    AllocTracker::sizeClass()
+    ***************************************/
+
+   // tiny allocations are in the first buckets
+   void test_sizeClass_small()
+   {  // setup
+      // exercise
+      // verify
+      assertUnit(AllocTracker::sizeClass(0) == 0);
+      assertUnit(AllocTracker::sizeClass(1) == 0);
+      assertUnit(AllocTracker::sizeClass(2) == 1);
+      assertUnit(AllocTracker::sizeClass(3) == 2);
+   }  // teardown
+
+   // a power of two is the top of its bucket
+   void test_sizeClass_powerOfTwo()
+   {  // setup
+      // exercise
+      // verify
+      assertUnit(AllocTracker::sizeClass(16) == 4);
+      assertUnit(AllocTracker::sizeClass(17) == 5);
+      assertUnit(AllocTracker::sizeClass(24) == 5);
+      assertUnit(AllocTracker::sizeClass(32) == 5);
+   }  // teardown
+
+   // everything too big goes in the last bucket
+   void test_sizeClass_huge()
+   {  // setup
+      // exercise
+      // verify
+      assertUnit(AllocTracker::sizeClass(std::size_t(-1)) == NUM_SIZE_CLASSES - 1);
+   }  // teardown
+
+   /***************************************
+    * NEW and DELETE
+    *    ::operator new()
+    *    ::operator delete()
+    * The operators are called directly: a new
+    * expression whose block is never used may
+    * be optimized away along with its delete.
+    ***************************************/
+
+   // one allocation is counted with its size
+   void test_new_single()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      AllocTracker::reset();
+      // exercise
+      void * p = ::operator new(sizeof(double));
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 1);
+      assertUnit(stats.numFree == 0);
+      assertUnit(stats.bytesAlloc == sizeof(double));
+      assertUnit(stats.bytesLive == sizeof(double));
+      assertUnit(stats.bytesPeak == sizeof(double));
+      // teardown
+      ::operator delete(p);
+   }
+
+   // freeing returns the live bytes to zero but not the peak
+   void test_delete_single()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      AllocTracker::reset();
+      void * p = ::operator new(sizeof(double));
+      // exercise
+      ::operator delete(p);
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 1);
+      assertUnit(stats.numFree == 1);
+      assertUnit(stats.bytesFree == sizeof(double));
+      assertUnit(stats.bytesLive == 0);
+      assertUnit(stats.bytesPeak == sizeof(double));
+   }  // teardown
+
+   // arrays are counted by their whole size
+   void test_newArray_single()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      AllocTracker::reset();
+      // exercise
+      void * p = ::operator new[](10 * sizeof(int));
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 1);
+      assertUnit(stats.bytesLive == 10 * sizeof(int));
+      // teardown
+      ::operator delete[](p);
+   }
+
+   // the peak is the most that was alive at one time
+   void test_peak_twoAlive()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      AllocTracker::reset();
+      // exercise
+      void * p1 = ::operator new[](100);
+      void * p2 = ::operator new[](50);
+      ::operator delete[](p1);
+      void * p3 = ::operator new[](10);
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.bytesPeak == 150);
+      assertUnit(stats.bytesLive == 60);
+      // teardown
+      ::operator delete[](p2);
+      ::operator delete[](p3);
+   }
+
+   // each allocation lands in the bucket of its size
+   void test_histogram_sizes()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      AllocTracker::reset();
+      // exercise
+      void * p1 = ::operator new[](3);
+      void * p2 = ::operator new[](4);
+      void * p3 = ::operator new[](1000);
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.histogram[2] == 2);   // 3 and 4 bytes
+      assertUnit(stats.histogram[10] == 1);  // 1000 bytes
+      // teardown
+      ::operator delete[](p1);
+      ::operator delete[](p2);
+      ::operator delete[](p3);
+   }
+
+   // a type aligned past 16 bytes is counted and keeps its alignment
+   void test_new_overAligned()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      const std::align_val_t align = std::align_val_t(64);
+      AllocTracker::reset();
+      // exercise
+      void * p = ::operator new(64, align);
+      void * pArray = ::operator new[](3 * 64, align);
+      AllocStats statsNew = AllocTracker::thread();
+      std::uintptr_t address = (std::uintptr_t)p;
+      std::uintptr_t addressArray = (std::uintptr_t)pArray;
+      ::operator delete(p, align);
+      ::operator delete[](pArray, align);
+      AllocStats statsDelete = AllocTracker::thread();
+      // verify
+      assertUnit(statsNew.numAlloc == 2);
+      assertUnit(statsNew.bytesLive == 4 * 64);
+      assertUnit(address % 64 == 0);
+      assertUnit(addressArray % 64 == 0);
+      assertUnit(statsDelete.numFree == 2);
+      assertUnit(statsDelete.bytesLive == 0);
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,165 @@
+/***********************************************************************
+ * Header:
+ *    TEST ARENA
+ * Summary:
+ *    Unit tests for the arena and its allocator
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+#ifdef DEBUG
+
+#include "arena.h"         // class under test
+#include "allocTracker.h"  // to see what reaches operator new
+#include "unitTest.h"      // unit test baseclass
+
+/***********************************************
+ * TEST ARENA
+ * Unit tests for custom::arena and custom::arena_allocator
+ ***********************************************/
+class TestArena : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Allocate
+      addTest(test_allocate_aligned);
+      addTest(test_allocate_bump);
+      addTest(test_allocate_buffer);
+      addTest(test_allocate_grow);
+
+      // Release
+      addTest(test_release_rewind);
+      addTest(test_release_blocks);
+
+      // Allocator
+      addTest(test_allocator_equal);
+
+      runTests();
+      report("Arena");
+   }
+
+   /***************************************
+    * ALLOCATE
+    ***************************************/
+
+   // each block is aligned as asked
+   void test_allocate_aligned()
+   {  // setup
+      custom::arena a;
+      // exercise
+      char * p1 = (char *)a.allocate(1, 1);
+      double * p2 = (double *)a.allocate(sizeof(double), alignof(double));
+      void * p3 = a.allocate(1, 64);
+      // verify
+      assertUnit(p1 != nullptr);
+      assertUnit(((std::size_t)p2 % alignof(double)) == 0);
+      assertUnit(((std::size_t)p3 % 64) == 0);
+   }  // teardown
+
+   // allocations follow one another in the same block
+   void test_allocate_bump()
+   {  // setup
+      custom::arena a;
+      // exercise
+      char * p1 = (char *)a.allocate(16, 16);
+      char * p2 = (char *)a.allocate(16, 16);
+      // verify
+      assertUnit(p2 == p1 + 16);
+      assertUnit(a.used() == 32);
+   }  // teardown
+
+   // the caller's buffer is used without calling operator new
+   void test_allocate_buffer()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      alignas(16) char buffer[256];
+      custom::arena a(buffer, sizeof(buffer));
+      AllocTracker::reset();
+      // exercise
+      char * p1 = (char *)a.allocate(100, 16);
+      char * p2 = (char *)a.allocate(100, 16);
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 0);
+      assertUnit(p1 == buffer);
+      assertUnit(p2 >= buffer && p2 + 100 <= buffer + sizeof(buffer));
+   }  // teardown
+
+   // a full buffer spills into a block from operator new
+   void test_allocate_grow()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      alignas(16) char buffer[64];
+      custom::arena a(buffer, sizeof(buffer));
+      AllocTracker::reset();
+      // exercise
+      a.allocate(48, 16);
+      char * p = (char *)a.allocate(48, 16);
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 1);
+      assertUnit(p < buffer || p >= buffer + sizeof(buffer));
+   }  // teardown
+
+   /***************************************
+    * RELEASE
+    ***************************************/
+
+   // after release the caller's buffer is used from the start again
+   void test_release_rewind()
+   {  // setup
+      alignas(16) char buffer[256];
+      custom::arena a(buffer, sizeof(buffer));
+      a.allocate(100, 16);
+      // exercise
+      a.release();
+      // verify
+      assertUnit(a.used() == 0);
+      assertUnit(a.allocate(8, 8) == buffer);
+   }  // teardown
+
+   // release frees every block at once
+   void test_release_blocks()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      AllocTracker::reset();
+      custom::arena a(64);
+      for (int i = 0; i < 10; i++)
+         a.allocate(64, 16);
+      // exercise
+      a.release();
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc > 1);
+      assertUnit(stats.numAlloc == stats.numFree);
+      assertUnit(stats.bytesLive == 0);
+   }  // teardown
+
+   /***************************************
+    * ALLOCATOR
+    ***************************************/
+
+   // allocators are equal when they share an arena
+   void test_allocator_equal()
+   {  // setup
+      custom::arena a1;
+      custom::arena a2;
+      // exercise
+      custom::arena_allocator<int> alloc1(a1);
+      custom::arena_allocator<double> alloc2(alloc1);
+      custom::arena_allocator<int> alloc3(a2);
+      // verify
+      assertUnit(alloc1 == alloc2);
+      assertUnit(alloc1 != alloc3);
+      assertUnit(alloc2.pArena == &a1);
+   }  // teardown
+};
+
+#endif // DEBUG
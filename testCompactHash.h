@@ -0,0 +1,408 @@
+/***********************************************************************
+ * Header:
+ *    TEST COMPACT HASH
+ * Summary:
+ *    Unit tests for the compact hash
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "compactHash.h"   // class under test
+#include "unitTest.h"      // unit test baseclass
+#include "allocTracker.h"  // to count the bytes per element
+#include "spy.h"           // to see what happens to the elements
+
+#include <cstddef>         // for std::size_t
+
+/***********************************************
+ * TEST COMPACT HASH
+ * Unit tests for custom::compact_unordered_set
+ ***********************************************/
+class TestCompactHash : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      addTest(test_construct_default);
+      addTest(test_construct_defaultAccess);
+      addTest(test_construct_initializerList);
+      addTest(test_construct_copy);
+      addTest(test_construct_move);
+
+      // Insert
+      addTest(test_insert_empty);
+      addTest(test_insert_standard);
+      addTest(test_insert_duplicate);
+      addTest(test_insert_grow);
+
+      // Find
+      addTest(test_find_standard);
+      addTest(test_find_missing);
+
+      // Erase
+      addTest(test_erase_onlyInBucket);
+      addTest(test_erase_firstInBucket);
+      addTest(test_erase_lastInBucket);
+      addTest(test_erase_missing);
+
+      // Iterator
+      addTest(test_iterator_everyElement);
+      addTest(test_iterator_bucket);
+
+      // Memory
+      addTest(test_memory_bytesPerElement);
+      addTest(test_memory_destructor);
+
+      runTests();
+      report("CompactHash");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // an empty set has no bucket array yet
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::compact_unordered_set<std::size_t> us;
+      // verify
+      assertUnit(us.buckets == nullptr);
+      assertUnit(us.numBuckets == 0);
+      assertUnit(us.numElements == 0);
+      assertUnit(us.beforeBegin.pNext == nullptr);
+      assertUnit(us.begin() == us.end());
+   }  // teardown
+
+   // with no bucket array, the bucket accessors still answer
+   void test_construct_defaultAccess()
+   {  // setup
+      const custom::compact_unordered_set<std::size_t> us;
+      // exercise and verify
+      assertUnit(us.bucket(std::size_t(26)) == 0);
+      assertUnit(us.bucket_size(0) == 0);
+      assertUnit(us.begin(0) == us.end(0));
+      assertUnit(us.find(std::size_t(26)) == us.end());
+   }  // teardown
+
+   // every element of the list is inserted
+   void test_construct_initializerList()
+   {  // setup
+      // exercise
+      custom::compact_unordered_set<std::size_t> us{ 31, 67, 59, 49 };
+      // verify
+      assertStandardFixture(us);
+   }  // teardown
+
+   // a copy has its own nodes
+   void test_construct_copy()
+   {  // setup
+      custom::compact_unordered_set<std::size_t> usSrc;
+      setupStandardFixture(usSrc);
+      // exercise
+      custom::compact_unordered_set<std::size_t> usDest(usSrc);
+      // verify
+      assertStandardFixture(usSrc);
+      assertStandardFixture(usDest);
+      assertUnit(usDest.beforeBegin.pNext != usSrc.beforeBegin.pNext);
+   }  // teardown
+
+   // a move takes the nodes and points the first bucket at its own beforeBegin
+   void test_construct_move()
+   {  // setup
+      custom::compact_unordered_set<std::size_t> usSrc;
+      setupStandardFixture(usSrc);
+      auto * pFirst = usSrc.beforeBegin.pNext;
+      // exercise
+      custom::compact_unordered_set<std::size_t> usDest(std::move(usSrc));
+      // verify
+      assertUnit(usSrc.numElements == 0);
+      assertUnit(usSrc.buckets == nullptr);
+      assertUnit(usDest.beforeBegin.pNext == pFirst);
+      assertStandardFixture(usDest);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the first insert makes ten buckets
+   void test_insert_empty()
+   {  // setup
+      custom::compact_unordered_set<std::size_t> us;
+      // exercise
+      auto p = us.insert(std::size_t(31));
+      // verify
+      assertUnit(p.second == true);
+      assertUnit(*p.first == 31);
+      assertUnit(us.numBuckets == 10);
+      assertUnit(us.numElements == 1);
+      assertUnit(us.buckets[1] == &us.beforeBegin);
+   }  // teardown
+
+   // a new bucket goes to the front of the chain and the old front moves behind it
+   void test_insert_standard()
+   {  // setup
+      custom::compact_unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      // exercise
+      auto p = us.insert(std::size_t(23));
+      // verify
+      //    beforeBegin -> 23 -> 49 -> 59 -> 67 -> 31
+      assertUnit(p.second == true);
+      assertUnit(us.numElements == 5);
+      assertUnit(us.buckets[3] == &us.beforeBegin);
+      assertUnit(us.buckets[9] == p.first.p);
+      assertUnit(us.bucket_size(9) == 2);
+      assertUnit(us.bucket_size(3) == 1);
+   }  // teardown
+
+   // a duplicate is found and not inserted
+   void test_insert_duplicate()
+   {  // setup
+      custom::compact_unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      // exercise
+      auto p = us.insert(std::size_t(59));
+      // verify
+      assertUnit(p.second == false);
+      assertUnit(*p.first == 59);
+      assertStandardFixture(us);
+   }  // teardown
+
+   // more elements than buckets doubles the buckets and keeps every element
+   void test_insert_grow()
+   {  // setup
+      custom::compact_unordered_set<std::size_t> us;
+      // exercise
+      for (std::size_t i = 0; i < 11; i++)
+         us.insert(i);
+      // verify
+      assertUnit(us.numBuckets == 20);
+      assertUnit(us.numElements == 11);
+      for (std::size_t i = 0; i < 11; i++)
+      {
+         assertUnit(us.find(i) != us.end());
+         assertUnit(us.bucket_size(i) == 1);
+      }
+   }  // teardown
+
+   /***************************************
+    * FIND
+    ***************************************/
+
+   // find the second element of a bucket
+   void test_find_standard()
+   {  // setup
+      custom::compact_unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      // exercise
+      auto it = us.find(std::size_t(59));
+      // verify
+      assertUnit(it != us.end());
+      assertUnit(*it == 59);
+      assertStandardFixture(us);
+   }  // teardown
+
+   // a value in an occupied bucket that is not there
+   void test_find_missing()
+   {  // setup
+      custom::compact_unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      // exercise
+      auto it = us.find(std::size_t(39));
+      // verify
+      assertUnit(it == us.end());
+      assertStandardFixture(us);
+   }  // teardown
+
+   /***************************************
+    * ERASE
+    ***************************************/
+
+   // erasing the only element of a bucket empties the bucket
+   void test_erase_onlyInBucket()
+   {  // setup
+      custom::compact_unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      // exercise
+      us.erase(std::size_t(67));
+      // verify
+      assertUnit(us.numElements == 3);
+      assertUnit(us.buckets[7] == nullptr);
+      assertUnit(us.find(std::size_t(67)) == us.end());
+      assertUnit(us.find(std::size_t(31)) != us.end());
+      assertUnit(us.find(std::size_t(49)) != us.end());
+      assertUnit(us.find(std::size_t(59)) != us.end());
+   }  // teardown
+
+   // erasing the first of two leaves the bucket pointing at the same link
+   void test_erase_firstInBucket()
+   {  // setup
+      custom::compact_unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      auto * pBefore = us.buckets[9];
+      std::size_t first = *us.begin(9);
+      // exercise
+      us.erase(first);
+      // verify
+      assertUnit(us.numElements == 3);
+      assertUnit(us.buckets[9] == pBefore);
+      assertUnit(us.bucket_size(9) == 1);
+      assertUnit(us.find(first) == us.end());
+   }  // teardown
+
+   // erasing the last of a bucket hands the next bucket the link before it
+   void test_erase_lastInBucket()
+   {  // setup
+      custom::compact_unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      std::size_t first = *us.begin(9);
+      std::size_t second = (first == 59) ? 49 : 59;
+      // exercise
+      us.erase(second);
+      // verify
+      assertUnit(us.numElements == 3);
+      assertUnit(us.bucket_size(9) == 1);
+      assertUnit(us.bucket_size(7) == 1);
+      assertUnit(us.bucket_size(1) == 1);
+      assertUnit(us.find(std::size_t(67)) != us.end());
+      assertUnit(us.find(std::size_t(31)) != us.end());
+   }  // teardown
+
+   // erasing what is not there changes nothing
+   void test_erase_missing()
+   {  // setup
+      custom::compact_unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      // exercise
+      auto it = us.erase(std::size_t(39));
+      // verify
+      assertUnit(it == us.end());
+      assertStandardFixture(us);
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // the chain visits every element once
+   void test_iterator_everyElement()
+   {  // setup
+      custom::compact_unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      std::size_t sum = 0;
+      int count = 0;
+      // exercise
+      for (auto it = us.begin(); it != us.end(); ++it)
+      {
+         sum += *it;
+         count++;
+      }
+      // verify
+      assertUnit(count == 4);
+      assertUnit(sum == 31 + 67 + 59 + 49);
+   }  // teardown
+
+   // a local iterator stops at the end of its bucket
+   void test_iterator_bucket()
+   {  // setup
+      custom::compact_unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      std::size_t sum = 0;
+      int count = 0;
+      // exercise
+      for (auto it = us.begin(9); it != us.end(9); ++it)
+      {
+         sum += *it;
+         count++;
+      }
+      // verify
+      assertUnit(count == 2);
+      assertUnit(sum == 59 + 49);
+   }  // teardown
+
+   /***************************************
+    * MEMORY
+    ***************************************/
+
+   // a node is one link and the key, plus a share of the bucket array
+   void test_memory_bytesPerElement()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      custom::compact_unordered_set<std::size_t> us;
+      AllocTracker::reset();
+      // exercise
+      for (std::size_t i = 0; i < 1000; i++)
+         us.insert(i);
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      typedef custom::compact_unordered_set<std::size_t>::Node Node;
+      assertUnit(sizeof(Node) == sizeof(void *) + sizeof(std::size_t));
+      assertUnit(stats.bytesLive <= (std::int64_t)(1000 * (sizeof(Node) + 2 * sizeof(void *))));
+   }  // teardown
+
+   // the destructor gives back every node and the bucket array
+   void test_memory_destructor()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      AllocTracker::reset();
+      {
+         custom::compact_unordered_set<std::size_t> us;
+         for (std::size_t i = 0; i < 100; i++)
+            us.insert(i);
+      }  // exercise
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == stats.numFree);
+      assertUnit(stats.bytesLive == 0);
+   }  // teardown
+
+   /*************************************************************
+    * SETUP STANDARD FIXTURE
+    *      h[1] --> 31
+    *      h[7] --> 67
+    *      h[9] --> 59 49
+    *************************************************************/
+   void setupStandardFixture(custom::compact_unordered_set<std::size_t> & us)
+   {
+      us.clear();
+      us.insert(std::size_t(31));
+      us.insert(std::size_t(67));
+      us.insert(std::size_t(59));
+      us.insert(std::size_t(49));
+   }
+
+   /*************************************************************
+    * VERIFY STANDARD FIXTURE
+    *************************************************************/
+   void assertStandardFixtureParameters(const custom::compact_unordered_set<std::size_t> & us,
+                                        int line, const char * function)
+   {
+      assertIndirect(us.numElements == 4);
+      assertIndirect(us.numBuckets == 10);
+      assertIndirect(us.buckets != nullptr);
+      if (us.buckets == nullptr || us.numBuckets != 10)
+         return;
+      assertIndirect(us.bucket_size(1) == 1);
+      assertIndirect(us.bucket_size(7) == 1);
+      assertIndirect(us.bucket_size(9) == 2);
+      assertIndirect(us.buckets[0] == nullptr);
+      assertIndirect(us.buckets[2] == nullptr);
+      assertIndirect(us.find(std::size_t(31)) != us.end());
+      assertIndirect(us.find(std::size_t(67)) != us.end());
+      assertIndirect(us.find(std::size_t(59)) != us.end());
+      assertIndirect(us.find(std::size_t(49)) != us.end());
+   }
+};
+
+#endif // DEBUG
@@ -12,11 +12,27 @@
 #endif
  //#undef DEBUG  // Remove this comment to disable unit tests
 
+#ifdef DEBUG
+#define TRACK_ALLOCATIONS  // count every call to operator new in the tests
+#endif
+
 #include "testSpy.h"       // for the pair unit tests
+#include "testAllocTracker.h" // for the allocation tracker unit tests
+#include "testPerfCounters.h" // for the hardware counter unit tests
+#include "testPool.h"       // for the slab pool unit tests
+#include "testArena.h"      // for the arena unit tests
 #include "testPair.h"       // for the pair unit tests
 #include "testHash.h"       // for the hash unit tests
 #include "testList.h"       // for the list unit tests
-int Spy::counters[] = {};
+#include "testUnrolledList.h" // for the unrolled list unit tests
+#include "testVector.h"     // for the vector unit tests
+#include "testSmallVector.h" // for the small vector unit tests
+#include "testSimd.h"       // for the SIMD kernel unit tests
+#include "testParallel.h"   // for the parallel algorithm unit tests
+#include "testRadixSort.h"  // for the radix sort unit tests
+#include "testSoaVector.h"  // for the struct-of-arrays vector unit tests
+#include "testCompactHash.h" // for the compact hash unit tests
+thread_local SpyCounters Spy::counters;
 
 /**********************************************************************
  * MAIN
@@ -27,9 +43,21 @@ int main()
 #ifdef DEBUG
    // unit tests
    TestSpy().run();
+   TestAllocTracker().run();
+   TestPerfCounters().run();
+   TestPool().run();
+   TestArena().run();
    TestPair().run();
    TestList().run();
+   TestUnrolledList().run();
+   TestVector().run();
+   TestSmallVector().run();
+   TestSimd().run();
+   TestParallel().run();
+   TestRadixSort().run();
+   TestSoaVector().run();
    TestHash().run();
+   TestCompactHash().run();
 #endif // DEBUG
    
    // driver
@@ -13,12 +13,18 @@
 
 #include "hash.h"
 #include "unitTest.h"
+#include "allocTracker.h"
+#include "pool.h"
+#include "arena.h"
+#include "vector.h"
 
 #include <cassert>
 #include <memory>
 #include <unordered_set>
 #include <functional>
 #include <vector>
+#include <string>
+#include <algorithm>
 
 using std::cout;
 using std::endl;
@@ -47,78 +53,133 @@ public:
       reset();
 
       // Construct
-      test_construct_default();
-      test_constructIterator_standard();
-      test_constructCopy_empty();
-      test_constructCopy_standard();
+      addTest(test_construct_default);
+      addTest(test_constructIterator_standard);
+      addTest(test_constructCopy_empty);
+      addTest(test_constructCopy_standard);
 
       // Assign
-      test_assign_emptyEmpty();
-      test_assign_emptyStandard();
-      test_assign_standardEmpty();
-      test_assignMove_emptyEmpty();
-      test_assignMove_emptyStandard();
-      test_assignMove_standardEmpty();
-      test_swapMember_emptyEmpty();
-      test_swapMember_standardEmpty();
-      test_swapMember_standardOther();
-      test_swapNonMember_emptyEmpty();
-      test_swapNonMember_standardEmpty();
-      test_swapNonMember_standardOther();
+      addTest(test_assign_emptyEmpty);
+      addTest(test_assign_emptyStandard);
+      addTest(test_assign_standardEmpty);
+      addTest(test_assignMove_emptyEmpty);
+      addTest(test_assignMove_emptyStandard);
+      addTest(test_assignMove_standardEmpty);
+      addTest(test_swapMember_emptyEmpty);
+      addTest(test_swapMember_standardEmpty);
+      addTest(test_swapMember_standardOther);
+      addTest(test_swapNonMember_emptyEmpty);
+      addTest(test_swapNonMember_standardEmpty);
+      addTest(test_swapNonMember_standardOther);
 
       // Iterator
-      test_iterator_begin_empty();
-      test_iterator_begin_standard();
-      test_iterator_end_empty();
-      test_iterator_end_standard();
-      test_iterator_increment_empty();
-      test_iterator_increment_moreInBucket();
-      test_iterator_increment_nextBucket();
-      test_iterator_increment_toEnd();
-      test_iterator_dereference();
-      test_localIterator_begin_single();
-      test_localIterator_begin_multiple();
-      test_localIterator_begin_empty();
-      test_localIterator_increment_single();
-      test_localIterator_increment_multiple();
+      addTest(test_iterator_begin_empty);
+      addTest(test_iterator_begin_standard);
+      addTest(test_iterator_end_empty);
+      addTest(test_iterator_end_standard);
+      addTest(test_iterator_increment_empty);
+      addTest(test_iterator_increment_moreInBucket);
+      addTest(test_iterator_increment_nextBucket);
+      addTest(test_iterator_increment_toEnd);
+      addTest(test_iterator_dereference);
+      addTest(test_localIterator_begin_single);
+      addTest(test_localIterator_begin_multiple);
+      addTest(test_localIterator_begin_empty);
+      addTest(test_localIterator_increment_single);
+      addTest(test_localIterator_increment_multiple);
 
       // Access
-      test_bucket_empty0();
-      test_bucket_empty7();
-      test_bucket_empty58();
-      test_find_empty();
-      test_find_standardFront();
-      test_find_standardBack();
-      test_find_standardMissingEmptyList();
-      test_find_standardMissingFilledList();
+      addTest(test_bucket_empty0);
+      addTest(test_bucket_empty7);
+      addTest(test_bucket_empty58);
+      addTest(test_find_empty);
+      addTest(test_find_standardFront);
+      addTest(test_find_standardBack);
+      addTest(test_find_standardMissingEmptyList);
+      addTest(test_find_standardMissingFilledList);
 
       // Insert
-      test_insert_empty0();
-      test_insert_empty58();
-      test_insert_standard3();
-      test_insert_standard77();
-      test_insert_standardDuplicate();
+      addTest(test_insert_empty0);
+      addTest(test_insert_empty58);
+      addTest(test_insert_standard3);
+      addTest(test_insert_standard77);
+      addTest(test_insert_standardDuplicate);
 
       // Remove
-      test_clear_empty();
-      test_clear_standard();
-      test_erase_empty();
-      test_erase_standardMissing();
-      test_erase_standardAlone();
-      test_erase_standardFront();
-      test_erase_standardBack();
-      test_erase_standardLast();
+      addTest(test_clear_empty);
+      addTest(test_clear_standard);
+      addTest(test_erase_empty);
+      addTest(test_erase_standardMissing);
+      addTest(test_erase_standardAlone);
+      addTest(test_erase_standardFront);
+      addTest(test_erase_standardBack);
+      addTest(test_erase_standardLast);
       
       // Status
-      test_size_empty();
-      test_size_standard();
-      test_empty_empty();
-      test_empty_standard();
-      test_bucketSize_empty();
-      test_bucketSize_standardEmpty();
-      test_bucketSize_standardOne();
-      test_bucketSize_standardTwo();
+      addTest(test_size_empty);
+      addTest(test_size_standard);
+      addTest(test_empty_empty);
+      addTest(test_empty_standard);
+      addTest(test_bucketSize_empty);
+      addTest(test_bucketSize_standardEmpty);
+      addTest(test_bucketSize_standardOne);
+      addTest(test_bucketSize_standardTwo);
 
+      // Performance
+      addPerfTest(test_perf_find_standard);
+      addPerfTest(test_perf_insert_duplicate);
+      addPerfTest(test_perf_find_flooded);
+      addPerfTest(test_perf_find_small);
+
+      // Memory
+      addTest(test_memory_bytesPerElement);
+      addTest(test_memory_destructor);
+      addTest(test_memory_assignReuse);
+
+      // Allocator
+      addTest(test_allocator_pool);
+      addTest(test_allocator_arena);
+      addTest(test_allocator_arenaCopy);
+#ifdef __cpp_lib_memory_resource
+      addTest(test_allocator_pmr);
+      addTest(test_allocator_pmrMove);
+#endif // __cpp_lib_memory_resource
+
+      // Keys
+      addTest(test_key_pair);
+      addTest(test_key_vector);
+      addTest(test_key_list);
+      addTest(test_key_vectorBytes);
+      addTest(test_key_spread);
+
+      // Bucket policy
+      addTest(test_policy_modulo);
+      addTest(test_policy_fibonacci);
+      addTest(test_policy_fastrange);
+      addTest(test_buckets_fibonacci);
+      addTest(test_buckets_allocator);
+
+      // Seeded hash
+      addTest(test_seeded_sameSeed);
+      addTest(test_seeded_string);
+      addTest(test_seeded_perSet);
+      addTest(test_seeded_copy);
+      addTest(test_seeded_flooded);
+
+      // Small set
+      addTest(test_small_noAllocation);
+      addTest(test_small_find);
+      addTest(test_small_spill);
+      addTest(test_small_erase);
+      addTest(test_small_iterate);
+      addTest(test_small_copy);
+      addTest(test_small_assignSelf);
+      addTest(test_small_move);
+      addTest(test_small_swap);
+      addTest(test_small_clear);
+      addTest(test_small_string);
+
+      runTests();
       report("Hash");
    }
 
@@ -2295,6 +2356,753 @@ public:
    }
 
 
+   /***************************************
+    * PERFORMANCE
+    ***************************************/
+
+   // find only walks the one bucket, never allocating. With a bucket for
+   // every key that is a comparison or two, where a walk of all 4000 keys
+   // would be thousands of comparisons and tens of microseconds.
+   void test_perf_find_standard()
+   {  // setup
+      custom::unordered_set<Spy, std::hash<Spy>, std::allocator<Spy>,
+                            custom::bucket_fibonacci<12>> us;
+      custom::vector<Spy> keys;
+      for (int i = 0; i < 4000; i++)
+      {
+         us.insert(Spy(i));
+         keys.push_back(Spy(i));
+      }
+      std::size_t index = 0;
+      Spy::reset();
+      auto find = [&]() { us.find(keys[index]); index = (index + 7) % 4000; };
+      // exercise and verify
+      assertPerf(find, PerfBudget(5000.0 /*ns*/, 0 /*alloc*/, 2 /*compare*/, 200.0 /*L1 miss*/));
+      assertUnit(us.size() == 4000);
+      // teardown
+   }
+
+   // inserting a duplicate is a lookup and nothing more
+   void test_perf_insert_duplicate()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      auto insert = [&]() { us.insert(std::size_t(59)); };
+      // exercise and verify
+      assertPerf(insert, PerfBudget(20000.0 /*ns*/, 0 /*alloc*/));
+      assertStandardFixture(us);
+      // teardown
+   }
+
+   // keys chosen to share a bucket all land in one unless the hash is seeded,
+   // so a seeded find walks a bucket of ordinary length
+   void test_perf_find_flooded()
+   {  // setup
+      custom::unordered_set<std::size_t> usPlain;
+      custom::unordered_set<std::size_t, custom::seeded_hash<std::size_t>> usSeeded;
+      for (std::size_t i = 0; i < 2000; i++)
+      {
+         usPlain.insert(i * 10);   // std::hash is the identity: all in bucket 0
+         usSeeded.insert(i * 10);
+      }
+      std::size_t value = 0;
+      auto findPlain  = [&]() { usPlain.find(value);  value = (value + 70) % 20000; };
+      auto findSeeded = [&]() { usSeeded.find(value); value = (value + 70) % 20000; };
+      std::size_t largest = 0;
+      for (std::size_t i = 0; i < usSeeded.bucket_count(); i++)
+         largest = std::max(largest, usSeeded.bucket_size(i));
+      // exercise and verify
+      assertPerf(findPlain, PerfBudget(1.0e9 /*ns: only measured*/, 0 /*alloc*/));
+      assertPerf(findSeeded, PerfBudget(50000.0 /*ns*/, 0 /*alloc*/));
+      assertUnit(usPlain.bucket_size(0) == 2000);
+      assertUnit(largest <= 300);   // about 200 in each of the 10
+   }  // teardown
+
+   // a small set is a short linear search with no hashing
+   void test_perf_find_small()
+   {  // setup
+      SmallSet us;
+      for (std::size_t i = 0; i < 8; i++)
+         us.insert(i * 10);
+      std::size_t value = 0;
+      auto find = [&]() { us.find(value); value = (value + 10) % 100; };
+      // exercise and verify
+      assertPerf(find, PerfBudget(5000.0 /*ns*/, 0 /*alloc*/));
+      assertUnit(us.is_small());
+   }  // teardown
+
+   /***************************************
+    * MEMORY
+    ***************************************/
+
+   // each element costs one node in its bucket and nothing else
+   void test_memory_bytesPerElement()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      custom::unordered_set<std::size_t> us;
+      AllocTracker::reset();
+      // exercise
+      for (std::size_t i = 0; i < 100; i++)
+         us.insert(i);
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 100);
+      assertUnit(stats.bytesLive == 100 * sizeof(custom::list<std::size_t>::Node));
+   }  // teardown
+
+   // the destructor gives back every node of every bucket
+   void test_memory_destructor()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      AllocTracker::reset();
+      {
+         custom::unordered_set<std::size_t> us;
+         setupStandardFixture(us);
+      }  // exercise
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == stats.numFree);
+      assertUnit(stats.bytesLive == 0);
+   }  // teardown
+
+   // copying onto a set of the same shape reuses the nodes in every bucket
+   void test_memory_assignReuse()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      custom::unordered_set<std::size_t> usSrc;
+      custom::unordered_set<std::size_t> usDes;
+      for (std::size_t i = 0; i < 100; i++)
+      {
+         usSrc.insert(i);
+         usDes.insert(i + 1000);
+      }
+      AllocTracker::reset();
+      // exercise
+      usDes = usSrc;
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 0);
+      assertUnit(stats.numFree == 0);
+      assertUnit(usDes.size() == 100);
+      assertUnit(usDes.find(26) != usDes.end());
+      assertUnit(usDes.find(1026) == usDes.end());
+   }  // teardown
+
+   /***************************************
+    * ALLOCATOR
+    ***************************************/
+
+   // the buckets take their nodes from the set's allocator
+   void test_allocator_pool()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      custom::unordered_set<std::size_t, std::hash<std::size_t>,
+                            custom::pool_allocator<std::size_t>> us;
+      us.insert(std::size_t(99));
+      us.erase(std::size_t(99));
+      AllocTracker::reset();
+      // exercise
+      for (std::size_t i = 0; i < 100; i++)
+      {
+         us.insert(i);
+         us.erase(i);
+      }
+      us.insert(std::size_t(59));
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 0);
+      assertUnit(us.size() == 1);
+      assertUnit(us.find(std::size_t(59)) != us.end());
+      assertUnit(us.bucket_size(9) == 1);
+   }  // teardown
+
+   // a set built for one request costs no trips to operator new
+   void test_allocator_arena()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      alignas(16) char buffer[4096];
+      custom::arena a(buffer, sizeof(buffer));
+      AllocTracker::reset();
+      // exercise
+      std::size_t size;
+      bool found;
+      {
+         custom::unordered_set<std::size_t, std::hash<std::size_t>,
+                               custom::arena_allocator<std::size_t>>
+            us{ custom::arena_allocator<std::size_t>(a) };
+         for (std::size_t i = 0; i < 50; i++)
+            us.insert(i);
+         us.erase(std::size_t(7));
+         size = us.size();
+         found = us.find(std::size_t(49)) != us.end();
+      }
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 0);
+      assertUnit(stats.numFree == 0);
+      assertUnit(size == 49);
+      assertUnit(found);
+   }  // teardown
+
+   // a copy and a move of an arena set draw from the same arena
+   void test_allocator_arenaCopy()
+   {  // setup
+      alignas(16) char buffer[4096];
+      custom::arena a(buffer, sizeof(buffer));
+      typedef custom::unordered_set<std::size_t, std::hash<std::size_t>,
+                                    custom::arena_allocator<std::size_t>> Set;
+      Set usSrc{ custom::arena_allocator<std::size_t>(a) };
+      for (std::size_t i = 0; i < 20; i++)
+         usSrc.insert(i);
+      // exercise
+      Set usCopy(usSrc);
+      Set usMove(std::move(usSrc));
+      // verify
+      bool sameArena = true;
+      for (std::size_t i = 0; i < usCopy.bucket_count(); i++)
+      {
+         sameArena = sameArena && usCopy.buckets[i].get_allocator() == custom::arena_allocator<std::size_t>(a);
+         sameArena = sameArena && usMove.buckets[i].get_allocator() == custom::arena_allocator<std::size_t>(a);
+      }
+      assertUnit(sameArena);
+      assertUnit(usCopy.size() == 20);
+      assertUnit(usMove.size() == 20);
+      assertUnit(usCopy.find(std::size_t(19)) != usCopy.end());
+      assertUnit(usMove.find(std::size_t(19)) != usMove.end());
+   }  // teardown
+
+#ifdef __cpp_lib_memory_resource
+   // a pmr set puts every bucket's nodes in the memory resource
+   void test_allocator_pmr()
+   {  // setup
+      alignas(16) char buffer[4096];
+      std::pmr::monotonic_buffer_resource resource(buffer, sizeof(buffer),
+                                                   std::pmr::null_memory_resource());
+      custom::pmr::unordered_set<std::size_t> us(&resource);
+      // exercise
+      for (std::size_t i = 0; i < 30; i++)
+         us.insert(i);
+      // verify
+      assertUnit(us.size() == 30);
+      assertUnit(us.get_allocator().resource() == &resource);
+      for (std::size_t i = 0; i < us.bucket_count(); i++)
+         assertUnit(us.buckets[i].get_allocator().resource() == &resource);
+      assertUnit(us.find(std::size_t(29)) != us.end());
+   }  // teardown
+
+   // a moved pmr set keeps the memory resource
+   void test_allocator_pmrMove()
+   {  // setup
+      alignas(16) char buffer[4096];
+      std::pmr::monotonic_buffer_resource resource(buffer, sizeof(buffer),
+                                                   std::pmr::null_memory_resource());
+      custom::pmr::unordered_set<std::size_t> usSrc(&resource);
+      for (std::size_t i = 0; i < 30; i++)
+         usSrc.insert(i);
+      // exercise
+      custom::pmr::unordered_set<std::size_t> usDes(std::move(usSrc));
+      // verify
+      assertUnit(usDes.size() == 30);
+      assertUnit(usDes.get_allocator().resource() == &resource);
+      for (std::size_t i = 0; i < usDes.bucket_count(); i++)
+         assertUnit(usDes.buckets[i].get_allocator().resource() == &resource);
+      assertUnit(usDes.find(std::size_t(29)) != usDes.end());
+   }  // teardown
+#endif // __cpp_lib_memory_resource
+
+   /***************************************
+    * KEYS
+    ***************************************/
+
+   // pairs are keyed on their first, just as they compare
+   void test_key_pair()
+   {  // setup
+      custom::unordered_set<custom::pair<int, std::string>> us;
+      // exercise
+      us.insert(custom::pair<int, std::string>(26, "Alpha"));
+      us.insert(custom::pair<int, std::string>(49, "Bravo"));
+      bool inserted = us.insert(custom::pair<int, std::string>(26, "Zulu")).second;
+      // verify
+      assertUnit(!inserted);
+      assertUnit(us.size() == 2);
+      assertUnit(us.find(custom::pair<int, std::string>(49, "")) != us.end());
+      assertUnit(us.find(custom::pair<int, std::string>(67, "")) == us.end());
+   }  // teardown
+
+   // vectors are keyed on every element
+   void test_key_vector()
+   {  // setup
+      custom::unordered_set<custom::vector<int>> us;
+      // exercise
+      us.insert(custom::vector<int>{ 10, 1, 3 });
+      us.insert(custom::vector<int>{ 10, 3, 1 });
+      bool inserted = us.insert(custom::vector<int>{ 10, 1, 3 }).second;
+      // verify
+      assertUnit(!inserted);
+      assertUnit(us.size() == 2);
+      assertUnit(us.find(custom::vector<int>{ 10, 3, 1 }) != us.end());
+      assertUnit(us.find(custom::vector<int>{ 10, 3 }) == us.end());
+   }  // teardown
+
+   // lists are keyed on every element, in order
+   void test_key_list()
+   {  // setup
+      custom::unordered_set<custom::list<std::string>> us;
+      // exercise
+      us.insert(custom::list<std::string>{ "core", "edge" });
+      us.insert(custom::list<std::string>{ "edge", "core" });
+      bool inserted = us.insert(custom::list<std::string>{ "core", "edge" }).second;
+      // verify
+      assertUnit(!inserted);
+      assertUnit(us.size() == 2);
+      assertUnit(us.find(custom::list<std::string>{ "edge", "core" }) != us.end());
+      assertUnit(us.find(custom::list<std::string>{ "edge" }) == us.end());
+   }  // teardown
+
+   // a vector of integers is hashed as one run of bytes
+   void test_key_vectorBytes()
+   {  // setup
+      custom::vector<int> v{ 10, 1, 3, 16, 67 };
+      custom::vector<int> vEmpty;
+      // exercise
+      std::size_t h = std::hash<custom::vector<int>>()(v);
+      std::size_t hEmpty = std::hash<custom::vector<int>>()(vEmpty);
+      // verify
+      assertUnit(h == static_cast<std::size_t>(custom::hash_bytes(&v[0], 5 * sizeof(int))));
+      assertUnit(hEmpty == static_cast<std::size_t>(custom::hash_bytes(nullptr, 0)));
+      assertUnit(h != hEmpty);
+   }  // teardown
+
+   // consecutive keys spread over every bucket, not just a few
+   void test_key_spread()
+   {  // setup
+      std::size_t counts[10] = {};
+      std::size_t countsPair[10] = {};
+      // exercise
+      for (int i = 0; i < 1000; i++)
+      {
+         custom::vector<int> v{ i * 10, i * 10 };
+         counts[std::hash<custom::vector<int>>()(v) % 10]++;
+         countsPair[std::hash<custom::pair<int, int>>()(custom::pair<int, int>(i * 10, 0)) % 10]++;
+      }
+      // verify
+      for (int b = 0; b < 10; b++)
+      {
+         assertUnit(counts[b] > 50 && counts[b] < 150);
+         assertUnit(countsPair[b] > 50 && countsPair[b] < 150);
+      }
+   }  // teardown
+
+   /***************************************
+    * BUCKET POLICY
+    ***************************************/
+
+   // the default is the remainder by ten
+   void test_policy_modulo()
+   {  // setup
+      typedef custom::bucket_modulo<10> Policy;
+      // exercise
+      // verify
+      assertUnit(Policy::count == 10);
+      assertUnit(Policy::index(0) == 0);
+      assertUnit(Policy::index(67) == 7);
+      assertUnit(Policy::index(59) == 9);
+      assertUnit(custom::bucket_modulo<97>::index(1000) == 30);
+   }  // teardown
+
+   // multiples of the bucket count still spread over every bucket
+   void test_policy_fibonacci()
+   {  // setup
+      typedef custom::bucket_fibonacci<4> Policy;
+      std::size_t counts[16] = {};
+      // exercise
+      for (std::size_t i = 0; i < 1600; i++)
+         counts[Policy::index(i * 16)]++;
+      // verify
+      assertUnit(Policy::count == 16);
+      for (int b = 0; b < 16; b++)
+         assertUnit(counts[b] > 50 && counts[b] < 150);
+   }  // teardown
+
+   // any count, always in range and evenly used
+   void test_policy_fastrange()
+   {  // setup
+      typedef custom::bucket_fastrange<13> Policy;
+      std::size_t counts[13] = {};
+      bool inRange = true;
+      // exercise
+      for (std::size_t i = 0; i < 1300; i++)
+      {
+         std::size_t index = Policy::index(i);
+         inRange = inRange && index < 13;
+         if (index < 13)
+            counts[index]++;
+      }
+      inRange = inRange && Policy::index(~std::size_t(0)) < 13;
+      // verify
+      assertUnit(Policy::count == 13);
+      assertUnit(inRange);
+      for (int b = 0; b < 13; b++)
+         assertUnit(counts[b] > 50 && counts[b] < 150);
+   }  // teardown
+
+   // a set with a power of two buckets finds what it holds
+   void test_buckets_fibonacci()
+   {  // setup
+      custom::unordered_set<std::size_t, std::hash<std::size_t>,
+                            std::allocator<std::size_t>,
+                            custom::bucket_fibonacci<5>> us;
+      // exercise
+      for (std::size_t i = 0; i < 320; i++)
+         us.insert(i * 32);
+      // verify
+      assertUnit(us.bucket_count() == 32);
+      assertUnit(us.size() == 320);
+      bool found = true;
+      for (std::size_t i = 0; i < 320; i++)
+         found = found && us.find(i * 32) != us.end();
+      assertUnit(found);
+      assertUnit(us.find(33) == us.end());
+      std::size_t largest = 0;
+      for (std::size_t i = 0; i < us.bucket_count(); i++)
+         largest = std::max(largest, us.bucket_size(i));
+      assertUnit(largest < 30);
+      std::size_t count = 0;
+      for (auto it = us.begin(); it != us.end(); ++it)
+         count++;
+      assertUnit(count == 320);
+   }  // teardown
+
+   // every bucket of a set with another count gets the allocator
+   void test_buckets_allocator()
+   {  // setup
+      alignas(16) char buffer[4096];
+      custom::arena a(buffer, sizeof(buffer));
+      // exercise
+      custom::unordered_set<std::size_t, std::hash<std::size_t>,
+                            custom::arena_allocator<std::size_t>,
+                            custom::bucket_fastrange<7>>
+         us{ custom::arena_allocator<std::size_t>(a) };
+      for (std::size_t i = 0; i < 50; i++)
+         us.insert(i);
+      // verify
+      assertUnit(us.bucket_count() == 7);
+      assertUnit(us.size() == 50);
+      bool sameArena = true;
+      for (std::size_t i = 0; i < us.bucket_count(); i++)
+         sameArena = sameArena && us.buckets[i].get_allocator() == custom::arena_allocator<std::size_t>(a);
+      assertUnit(sameArena);
+      assertUnit(us.find(26) != us.end());
+      us.erase(26);
+      assertUnit(us.find(26) == us.end());
+   }  // teardown
+
+   /***************************************
+    * SEEDED HASH
+    ***************************************/
+
+   // the same seed gives the same hash, another seed another one
+   void test_seeded_sameSeed()
+   {  // setup
+      custom::seeded_hash<std::size_t> h1(26);
+      custom::seeded_hash<std::size_t> h2(26);
+      custom::seeded_hash<std::size_t> h3(49);
+      // exercise
+      // verify
+      assertUnit(h1.get_seed() == 26);
+      assertUnit(h1(67) == h2(67));
+      assertUnit(h1(67) != h3(67));
+      assertUnit(h1(67) != h1(68));
+   }  // teardown
+
+   // strings are hashed by their characters, with the seed
+   void test_seeded_string()
+   {  // setup
+      custom::seeded_hash<std::string> h1(26);
+      custom::seeded_hash<std::string> h2(49);
+      std::string s1("client-0001");
+      std::string s2("client-0001");
+      // exercise
+      // verify
+      assertUnit(h1(s1) == h1(s2));
+      assertUnit(h1(s1) == static_cast<std::size_t>(custom::hash_bytes(s1.data(), s1.size(), 26)));
+      assertUnit(h1(s1) != h2(s1));
+      assertUnit(h1(s1) != h1(std::string("client-0002")));
+   }  // teardown
+
+   // each set draws a seed of its own
+   void test_seeded_perSet()
+   {  // setup
+      // exercise
+      custom::unordered_set<std::size_t, custom::seeded_hash<std::size_t>> us1;
+      custom::unordered_set<std::size_t, custom::seeded_hash<std::size_t>> us2;
+      custom::unordered_set<std::size_t, custom::seeded_hash<std::size_t>> us3(
+         custom::seeded_hash<std::size_t>(99));
+      // verify
+      assertUnit(us1.hash_function().get_seed() != us2.hash_function().get_seed());
+      assertUnit(us3.hash_function().get_seed() == 99);
+   }  // teardown
+
+   // a copy keeps the seed, so it finds what it was given
+   void test_seeded_copy()
+   {  // setup
+      custom::unordered_set<std::size_t, custom::seeded_hash<std::size_t>> usSrc;
+      for (std::size_t i = 0; i < 100; i++)
+         usSrc.insert(i);
+      // exercise
+      custom::unordered_set<std::size_t, custom::seeded_hash<std::size_t>> usDes(usSrc);
+      // verify
+      assertUnit(usDes.hash_function().get_seed() == usSrc.hash_function().get_seed());
+      bool found = true;
+      for (std::size_t i = 0; i < 100; i++)
+         found = found && usDes.find(i) != usDes.end();
+      assertUnit(found);
+   }  // teardown
+
+   // keys that all share a bucket under std::hash spread out when seeded
+   void test_seeded_flooded()
+   {  // setup
+      custom::unordered_set<std::size_t> usPlain;
+      custom::unordered_set<std::size_t, custom::seeded_hash<std::size_t>> usSeeded;
+      // exercise
+      for (std::size_t i = 0; i < 1000; i++)
+      {
+         usPlain.insert(i * 10);
+         usSeeded.insert(i * 10);
+      }
+      // verify
+      std::size_t largest = 0;
+      for (std::size_t i = 0; i < usSeeded.bucket_count(); i++)
+         largest = std::max(largest, usSeeded.bucket_size(i));
+      assertUnit(usPlain.bucket_size(0) == 1000);
+      assertUnit(largest < 150);
+      assertUnit(usSeeded.find(9990) != usSeeded.end());
+   }  // teardown
+
+   /***************************************
+    * SMALL SET
+    ***************************************/
+
+   // up to eight elements take no allocation at all
+   void test_small_noAllocation()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      SmallSet us;
+      AllocTracker::reset();
+      // exercise
+      for (std::size_t i = 0; i < 8; i++)
+         us.insert(i);
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 0);
+      assertUnit(us.is_small());
+      assertUnit(us.size() == 8);
+   }  // teardown
+
+   // finding in a small set, and inserting a duplicate
+   void test_small_find()
+   {  // setup
+      SmallSet us;
+      us.insert(std::size_t(31));
+      us.insert(std::size_t(49));
+      us.insert(std::size_t(67));
+      // exercise
+      bool inserted = us.insert(std::size_t(49)).second;
+      SmallSet::iterator it = us.find(std::size_t(67));
+      // verify
+      assertUnit(!inserted);
+      assertUnit(us.size() == 3);
+      assertUnit(it != us.end());
+      if (it != us.end())
+         assertUnit(*it == 67);
+      assertUnit(us.find(std::size_t(59)) == us.end());
+      assertUnit(us.bucket_size(7) == 0);
+   }  // teardown
+
+   // the ninth element moves everything into the buckets
+   void test_small_spill()
+   {  // setup
+      SmallSet us;
+      for (std::size_t i = 0; i < 8; i++)
+         us.insert(i * 10 + 1);
+      // exercise
+      bool inserted = us.insert(std::size_t(99)).second;
+      // verify
+      assertUnit(inserted);
+      assertUnit(!us.is_small());
+      assertUnit(us.size() == 9);
+      assertUnit(us.bucket_size(1) == 8);
+      assertUnit(us.bucket_size(9) == 1);
+      bool found = true;
+      for (std::size_t i = 0; i < 8; i++)
+         found = found && us.find(i * 10 + 1) != us.end();
+      assertUnit(found);
+   }  // teardown
+
+   // erasing fills the hole and keeps the rest findable
+   void test_small_erase()
+   {  // setup
+      SmallSet us;
+      for (std::size_t i = 1; i <= 5; i++)
+         us.insert(i);
+      // exercise
+      SmallSet::iterator it = us.erase(std::size_t(2));
+      SmallSet::iterator itLast = us.erase(std::size_t(4));
+      SmallSet::iterator itMissing = us.erase(std::size_t(2));
+      // verify
+      assertUnit(us.size() == 3);
+      assertUnit(it != us.end());
+      if (it != us.end())
+         assertUnit(*it == 5);
+      assertUnit(itLast == us.end());
+      assertUnit(itMissing == us.end());
+      assertUnit(us.find(std::size_t(1)) != us.end());
+      assertUnit(us.find(std::size_t(3)) != us.end());
+      assertUnit(us.find(std::size_t(5)) != us.end());
+      assertUnit(us.find(std::size_t(2)) == us.end());
+   }  // teardown
+
+   // the iterator walks the small array and then stops
+   void test_small_iterate()
+   {  // setup
+      SmallSet us;
+      SmallSet usEmpty;
+      for (std::size_t i = 1; i <= 4; i++)
+         us.insert(i);
+      std::size_t sum = 0;
+      std::size_t count = 0;
+      // exercise
+      for (SmallSet::iterator it = us.begin(); it != us.end(); it++)
+      {
+         sum += *it;
+         count++;
+      }
+      // verify
+      assertUnit(count == 4);
+      assertUnit(sum == 10);
+      assertUnit(usEmpty.begin() == usEmpty.end());
+   }  // teardown
+
+   // a copy of a small set is small, and its own
+   void test_small_copy()
+   {  // setup
+      SmallSet usSrc;
+      usSrc.insert(std::size_t(26));
+      usSrc.insert(std::size_t(49));
+      const SmallSet & usConst = usSrc;
+      // exercise
+      SmallSet usDes(usConst);
+      usDes.insert(std::size_t(67));
+      // verify
+      assertUnit(usDes.is_small());
+      assertUnit(usDes.size() == 3);
+      assertUnit(usSrc.size() == 2);
+      assertUnit(usDes.find(std::size_t(49)) != usDes.end());
+      assertUnit(usSrc.find(std::size_t(67)) == usSrc.end());
+   }  // teardown
+
+   // assigning a small set to itself keeps its elements
+   void test_small_assignSelf()
+   {  // setup
+      custom::unordered_set<std::string, std::hash<std::string>,
+                            std::allocator<std::string>,
+                            custom::bucket_modulo<10>, 4> us;
+      us.insert(std::string("a string too long for the small string buffer"));
+      us.insert(std::string("Bravo"));
+      auto & usAlias = us;
+      // exercise
+      us = usAlias;
+      us = std::move(usAlias);
+      // verify
+      assertUnit(us.is_small());
+      assertUnit(us.size() == 2);
+      assertUnit(us.find(std::string("Bravo")) != us.end());
+      assertUnit(us.find(std::string("a string too long for the small string buffer")) != us.end());
+   }  // teardown
+
+   // moving a small set moves its elements and leaves the source empty
+   void test_small_move()
+   {  // setup
+      SmallSet usSrc;
+      usSrc.insert(std::size_t(26));
+      usSrc.insert(std::size_t(49));
+      // exercise
+      SmallSet usDes(std::move(usSrc));
+      // verify
+      assertUnit(usDes.size() == 2);
+      assertUnit(usDes.find(std::size_t(26)) != usDes.end());
+      assertUnit(usSrc.empty());
+      assertUnit(usSrc.is_small());
+      assertUnit(usSrc.begin() == usSrc.end());
+   }  // teardown
+
+   // a small set swaps with a spilled one
+   void test_small_swap()
+   {  // setup
+      SmallSet usSmall;
+      SmallSet usBig;
+      usSmall.insert(std::size_t(26));
+      for (std::size_t i = 0; i < 20; i++)
+         usBig.insert(i + 100);
+      // exercise
+      usSmall.swap(usBig);
+      // verify
+      assertUnit(!usSmall.is_small());
+      assertUnit(usSmall.size() == 20);
+      assertUnit(usSmall.find(std::size_t(119)) != usSmall.end());
+      assertUnit(usBig.is_small());
+      assertUnit(usBig.size() == 1);
+      assertUnit(usBig.find(std::size_t(26)) != usBig.end());
+   }  // teardown
+
+   // a cleared set starts small again
+   void test_small_clear()
+   {  // setup
+      SmallSet us;
+      for (std::size_t i = 0; i < 20; i++)
+         us.insert(i);
+      // exercise
+      us.clear();
+      us.insert(std::size_t(26));
+      // verify
+      assertUnit(us.is_small());
+      assertUnit(us.size() == 1);
+      assertUnit(us.bucket_size(6) == 0);
+      assertUnit(us.find(std::size_t(26)) != us.end());
+   }  // teardown
+
+   // elements with destructors are built and destroyed in the array
+   void test_small_string()
+   {  // setup
+      custom::unordered_set<std::string, std::hash<std::string>,
+                            std::allocator<std::string>,
+                            custom::bucket_modulo<10>, 4> us;
+      // exercise
+      us.insert(std::string("a string too long for the small string buffer"));
+      us.insert(std::string("Bravo"));
+      us.erase(std::string("a string too long for the small string buffer"));
+      us.insert(std::string("Charlie"));
+      // verify
+      assertUnit(us.is_small());
+      assertUnit(us.size() == 2);
+      assertUnit(us.find(std::string("Bravo")) != us.end());
+      for (int i = 0; i < 5; i++)
+         us.insert(std::string(40, char('a' + i)));
+      assertUnit(!us.is_small());
+      assertUnit(us.find(std::string("Charlie")) != us.end());
+   }  // teardown
+
+   // a set that keeps its first eight elements in a flat array
+   typedef custom::unordered_set<std::size_t, std::hash<std::size_t>,
+                                 std::allocator<std::size_t>,
+                                 custom::bucket_modulo<10>, 8> SmallSet;
+
    /*************************************************************
     * SETUP STANDARD FIXTURE
     *      h[0] -->  
@@ -14,6 +14,10 @@
 #include "list.h"
 #include <list>
 #include "unitTest.h"
+#include "spy.h"
+#include "allocTracker.h"
+#include "pool.h"
+#include "arena.h"
 
 #include <vector>
 #include <cassert>
@@ -28,98 +32,138 @@ public:
       reset();
 
       // Construct
-      test_construct_default();
-      test_construct_sizeZero();
-      test_construct_sizeThree();
-      test_construct_sizeThreeFill();
-      test_constructCopy_empty();
-      test_constructCopy_standard();
-      test_constructMove_empty();
-      test_constructMove_standard();
-      test_constructInit_empty();
-      test_constructInit_standard();
-      test_constructRange_empty();
-      test_constructRange_standard();
-      test_destructor_empty();
-      test_destructor_standard();
+      addTest(test_construct_default);
+      addTest(test_construct_sizeZero);
+      addTest(test_construct_sizeThree);
+      addTest(test_construct_sizeThreeFill);
+      addTest(test_constructCopy_empty);
+      addTest(test_constructCopy_standard);
+      addTest(test_constructMove_empty);
+      addTest(test_constructMove_standard);
+      addTest(test_constructInit_empty);
+      addTest(test_constructInit_standard);
+      addTest(test_constructRange_empty);
+      addTest(test_constructRange_standard);
+      addTest(test_destructor_empty);
+      addTest(test_destructor_standard);
 
       // Assign
-      test_assign_emptyToEmpty();
-      test_assign_standardToEmpty();
-      test_assign_emptyToStandard();
-      test_assign_smallToBig();
-      test_assign_bigToSmall();
-      test_assignInit_empty();
-      test_assignInit_sameSize();
-      test_assignInit_rightBigger();
-      test_assignInit_leftBigger();
-      test_assignMove_emptyToEmpty();
-      test_assignMove_standardToEmpty();
-      test_assignMove_emptyToStandard();
-      test_assignMove_bigToSmall();
-      test_swap_emptyToEmpty();
-      test_swap_standardToEmpty();
-      test_swap_emptyToStandard();
-      test_swap_bigToSmall();
+      addTest(test_assign_emptyToEmpty);
+      addTest(test_assign_standardToEmpty);
+      addTest(test_assign_emptyToStandard);
+      addTest(test_assign_smallToBig);
+      addTest(test_assign_bigToSmall);
+      addTest(test_assignInit_empty);
+      addTest(test_assignInit_sameSize);
+      addTest(test_assignInit_rightBigger);
+      addTest(test_assignInit_leftBigger);
+      addTest(test_assignMove_emptyToEmpty);
+      addTest(test_assignMove_standardToEmpty);
+      addTest(test_assignMove_emptyToStandard);
+      addTest(test_assignMove_bigToSmall);
+      addTest(test_swap_emptyToEmpty);
+      addTest(test_swap_standardToEmpty);
+      addTest(test_swap_emptyToStandard);
+      addTest(test_swap_bigToSmall);
 
       // Iterator
-      test_iterator_begin_empty();
-      test_iterator_begin_standard();
-      test_iterator_end_standard();
-      test_iterator_increment_standardMiddle();
-      test_iterator_increment_standardEnd();
-      test_iterator_incrementPost_standardMiddle();
-      test_iterator_decrement_standardMiddle();
-      test_iterator_decrement_standardBegin();
-      test_iterator_decrementPost_standardMiddle();
-      test_iterator_dereference_read();
-      test_iterator_dereference_update();
+      addTest(test_iterator_begin_empty);
+      addTest(test_iterator_begin_standard);
+      addTest(test_iterator_end_standard);
+      addTest(test_iterator_increment_standardMiddle);
+      addTest(test_iterator_increment_standardEnd);
+      addTest(test_iterator_incrementPost_standardMiddle);
+      addTest(test_iterator_decrement_standardMiddle);
+      addTest(test_iterator_decrement_standardBegin);
+      addTest(test_iterator_decrementPost_standardMiddle);
+      addTest(test_iterator_dereference_read);
+      addTest(test_iterator_dereference_update);
 
       // Access
-      test_front_empty();
-      test_front_standardRead();
-      test_front_standardWrite();
-      test_back_empty();
-      test_back_standardRead();
-      test_back_standardWrite();
+      addTest(test_front_empty);
+      addTest(test_front_standardRead);
+      addTest(test_front_standardWrite);
+      addTest(test_back_empty);
+      addTest(test_back_standardRead);
+      addTest(test_back_standardWrite);
 
       // Insert
-      test_pushback_empty();
-      test_pushback_standard();
-      test_pushback_moveEmpty();
-      test_pushback_moveStandard();
-      test_pushfront_empty();
-      test_pushfront_standard();
-      test_pushfront_moveEmpty();
-      test_pushfront_moveStandard();
-      test_insert_empty();
-      test_insert_standardFront();
-      test_insert_standardMiddle();
-      test_insert_standardEnd();
-      test_insertMove_empty();
-      test_insertMove_standardFront();
-      test_insertMove_standardMiddle();
+      addTest(test_pushback_empty);
+      addTest(test_pushback_standard);
+      addTest(test_pushback_moveEmpty);
+      addTest(test_pushback_moveStandard);
+      addTest(test_pushfront_empty);
+      addTest(test_pushfront_standard);
+      addTest(test_pushfront_moveEmpty);
+      addTest(test_pushfront_moveStandard);
+      addTest(test_insert_empty);
+      addTest(test_insert_standardFront);
+      addTest(test_insert_standardMiddle);
+      addTest(test_insert_standardEnd);
+      addTest(test_insertMove_empty);
+      addTest(test_insertMove_standardFront);
+      addTest(test_insertMove_standardMiddle);
+      addTest(test_emplace_standardMiddle);
+      addTest(test_emplaceBack_spy);
+      addTest(test_emplaceFront_spy);
 
       // Remove
-      test_clear_empty();
-      test_clear_standard();
-      test_popback_empty();
-      test_popback_standard();
-      test_popback_single();
-      test_popfront_empty();
-      test_popfront_standard();
-      test_popfront_single();
-      test_erase_empty();
-      test_erase_standardFront();
-      test_erase_standardMiddle();
-      test_erase_standardEnd();
+      addTest(test_clear_empty);
+      addTest(test_clear_standard);
+      addTest(test_popback_empty);
+      addTest(test_popback_standard);
+      addTest(test_popback_single);
+      addTest(test_popfront_empty);
+      addTest(test_popfront_standard);
+      addTest(test_popfront_single);
+      addTest(test_erase_empty);
+      addTest(test_erase_standardFront);
+      addTest(test_erase_standardMiddle);
+      addTest(test_erase_standardEnd);
+      addTest(test_removeIf_some);
+      addTest(test_unique_runs);
+
+      // Operations
+      addTest(test_splice_all);
+      addTest(test_splice_one);
+      addTest(test_splice_otherTail);
+      addTest(test_splice_range);
+      addTest(test_splice_noAlloc);
+      addTest(test_merge_interleave);
+      addTest(test_merge_intoEmpty);
+      addTest(test_sort_reverse);
+      addTest(test_sort_stable);
+      addTest(test_sort_noCopy);
 
       // Status
-      test_size_empty();
-      test_size_three();
-      test_empty_empty();
-      test_empty_three();
-
+      addTest(test_size_empty);
+      addTest(test_size_three);
+      addTest(test_empty_empty);
+      addTest(test_empty_three);
+
+      // Performance
+      addPerfTest(test_perf_pushback_constant);
+      addPerfTest(test_perf_popfront_constant);
+
+      // Memory
+      addTest(test_memory_destructor);
+      addTest(test_memory_constructMove);
+      addTest(test_memory_bytesPerElement);
+      addTest(test_memory_assignSameSize);
+      addTest(test_memory_assignBigToSmall);
+      addTest(test_memory_assignSmallToBig);
+
+      // Allocator
+      addTest(test_allocator_pool);
+      addTest(test_allocator_poolChurn);
+      addTest(test_allocator_arena);
+      addTest(test_allocator_arenaClear);
+      addTest(test_allocator_arenaDestructor);
+#ifdef __cpp_lib_memory_resource
+      addTest(test_allocator_pmr);
+#endif // __cpp_lib_memory_resource
+
+      runTests();
       report("List");
    }
 
@@ -1888,6 +1932,72 @@ public:
       teardownStandardFixture(l);
    }
 
+   /***************************************
+    * EMPLACE
+    ***************************************/
+
+   // build an item in the middle of the list
+   void test_emplace_standardMiddle()
+   {  // setup
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      //                  it
+      custom::list<int> l;
+      setupStandardFixture(l);
+      custom::list<int>::iterator it(l.pHead->pNext);
+      // exercise
+      it = l.emplace(it, 99);
+      // verify
+      //       +----+   +----+   +----+   +----+
+      //       | 11 | - | 99 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+   +----+
+      //                  it
+      assertUnit(it.p == l.pHead->pNext);
+      assertUnit(matches(l, { 11, 99, 26, 31 }));
+      // teardown
+      l.clear();
+   }
+
+   // emplace_back builds the Spy once, in the node
+   void test_emplaceBack_spy()
+   {  // setup
+      custom::list<Spy> l;
+      l.push_back(Spy(11));
+      Spy::reset();
+      // exercise
+      Spy & s = l.emplace_back(99);
+      // verify
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(&s == &l.pTail->data);
+      assertUnit(s.get() == 99);
+      assertUnit(l.size() == 2);
+   }  // teardown
+
+   // emplace_front builds the Spy once, in the node
+   void test_emplaceFront_spy()
+   {  // setup
+      custom::list<Spy> l;
+      l.push_back(Spy(11));
+      Spy::reset();
+      // exercise
+      Spy & s = l.emplace_front(99);
+      // verify
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(&s == &l.pHead->data);
+      assertUnit(l.pHead->pNext == l.pTail);
+      assertUnit(l.pTail->pPrev == l.pHead);
+   }  // teardown
+
 
    /***************************************
     * ERASE
@@ -2348,6 +2458,526 @@ public:
       teardownStandardFixture(l);
    }
 
+   /***************************************
+    * REMOVE IF and UNIQUE
+    ***************************************/
+
+   // remove every odd number
+   void test_removeIf_some()
+   {  // setup
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      custom::list<int> l;
+      setupStandardFixture(l);
+      // exercise
+      size_t num = l.remove_if([](int i) { return i % 2 == 1; });
+      // verify
+      //        pHead
+      //        pTail
+      //       +----+
+      //       | 26 |
+      //       +----+
+      assertUnit(num == 2);
+      assertUnit(matches(l, { 26 }));
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // runs of equal items collapse to the first of each
+   void test_unique_runs()
+   {  // setup
+      custom::list<int> l{ 11, 11, 26, 31, 31, 31, 11 };
+      // exercise
+      size_t num = l.unique();
+      // verify
+      assertUnit(num == 3);
+      assertUnit(matches(l, { 11, 26, 31, 11 }));
+   }  // teardown
+
+   /***************************************
+    * SPLICE
+    ***************************************/
+
+   // all of one list goes into the middle of another
+   void test_splice_all()
+   {  // setup
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      //                  pos
+      custom::list<int> l;
+      setupStandardFixture(l);
+      custom::list<int> lSrc{ 99, 88 };
+      custom::list<int>::iterator pos(l.pHead->pNext);
+      // exercise
+      l.splice(pos, lSrc);
+      // verify
+      //       +----+   +----+   +----+   +----+   +----+
+      //       | 11 | - | 99 | - | 88 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+   +----+   +----+
+      assertUnit(matches(l, { 11, 99, 88, 26, 31 }));
+      assertUnit(lSrc.numElements == 0);
+      assertUnit(lSrc.pHead == nullptr);
+      assertUnit(lSrc.pTail == nullptr);
+      // teardown
+      l.clear();
+   }
+
+   // one node moves from the front of one list to the back of another
+   void test_splice_one()
+   {  // setup
+      custom::list<int> l;
+      setupStandardFixture(l);
+      custom::list<int> lSrc{ 99, 88 };
+      custom::list<int>::Node * p = lSrc.pHead;
+      // exercise
+      l.splice(l.end(), lSrc, lSrc.begin());
+      // verify
+      //       +----+   +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 | - | 99 |
+      //       +----+   +----+   +----+   +----+
+      assertUnit(matches(l, { 11, 26, 31, 99 }));
+      assertUnit(matches(lSrc, { 88 }));
+      assertUnit(l.pTail == p);
+      // teardown
+      l.clear();
+   }
+
+   // the last node of another list moves onto the end of this one
+   void test_splice_otherTail()
+   {  // setup
+      custom::list<int> l;
+      setupStandardFixture(l);
+      custom::list<int> lSrc{ 99, 88 };
+      custom::list<int>::Node * p = lSrc.pTail;
+      // exercise
+      l.splice(l.end(), lSrc, lSrc.rbegin());
+      // verify
+      //       +----+   +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 | - | 88 |
+      //       +----+   +----+   +----+   +----+
+      assertUnit(matches(l, { 11, 26, 31, 88 }));
+      assertUnit(matches(lSrc, { 99 }));
+      assertUnit(l.pTail == p);
+      assertUnit(l.size() == 4);
+      assertUnit(lSrc.size() == 1);
+      // teardown
+      l.clear();
+   }
+
+   // a range in the middle of one list goes to the front of another
+   void test_splice_range()
+   {  // setup
+      custom::list<int> l;
+      setupStandardFixture(l);
+      custom::list<int> lSrc{ 1, 2, 3, 4 };
+      auto first = lSrc.begin();
+      ++first;
+      auto last = first;
+      ++last;
+      ++last;
+      // exercise
+      l.splice(l.begin(), lSrc, first, last);
+      // verify
+      //       +----+   +----+   +----+   +----+   +----+
+      //       |  2 | - |  3 | - | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+   +----+   +----+
+      assertUnit(matches(l, { 2, 3, 11, 26, 31 }));
+      assertUnit(matches(lSrc, { 1, 4 }));
+      // teardown
+      l.clear();
+   }
+
+   // splicing touches neither the allocator nor the elements
+   void test_splice_noAlloc()
+   {  // setup
+      custom::list<Spy> l;
+      custom::list<Spy> lSrc;
+      for (int i = 0; i < 10; i++)
+      {
+         l.push_back(Spy(i));
+         lSrc.push_back(Spy(i + 10));
+      }
+      AllocTracker::reset();
+      Spy::reset();
+      // exercise
+      l.splice(l.begin(), lSrc, lSrc.begin());
+      l.splice(l.end(), lSrc);
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 0);
+      assertUnit(stats.numFree == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(l.size() == 20);
+      assertUnit(lSrc.empty());
+      assertUnit(l.front().get() == 10);
+      assertUnit(l.back().get() == 19);
+   }  // teardown
+
+   /***************************************
+    * MERGE
+    ***************************************/
+
+   // two sorted lists become one
+   void test_merge_interleave()
+   {  // setup
+      custom::list<int> l;
+      setupStandardFixture(l);
+      custom::list<int> lSrc{ 5, 26, 30, 40 };
+      // exercise
+      l.merge(lSrc);
+      // verify
+      assertUnit(matches(l, { 5, 11, 26, 26, 30, 31, 40 }));
+      assertUnit(lSrc.empty());
+      assertUnit(lSrc.pHead == nullptr);
+      // teardown
+      l.clear();
+   }
+
+   // merging into an empty list takes everything
+   void test_merge_intoEmpty()
+   {  // setup
+      custom::list<int> l;
+      custom::list<int> lSrc;
+      setupStandardFixture(lSrc);
+      // exercise
+      l.merge(lSrc);
+      // verify
+      assertStandardFixture(l);
+      assertEmptyFixture(lSrc);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   /***************************************
+    * SORT
+    ***************************************/
+
+   // a reversed list comes out in order with every link fixed
+   void test_sort_reverse()
+   {  // setup
+      custom::list<int> l{ 7, 6, 5, 4, 3, 2, 1 };
+      // exercise
+      l.sort();
+      // verify
+      assertUnit(matches(l, { 1, 2, 3, 4, 5, 6, 7 }));
+   }  // teardown
+
+   // equal items keep their order
+   void test_sort_stable()
+   {  // setup
+      custom::list<int> l{ 12, 31, 11, 26, 19 };
+      // exercise
+      l.sort([](int lhs, int rhs) { return lhs / 10 < rhs / 10; });
+      // verify
+      assertUnit(matches(l, { 12, 11, 19, 26, 31 }));
+   }  // teardown
+
+   // sorting relinks nodes: no element is copied or moved
+   void test_sort_noCopy()
+   {  // setup
+      custom::list<Spy> l;
+      for (int i = 0; i < 100; i++)
+         l.push_back(Spy((i * 37) % 100));
+      AllocTracker::reset();
+      Spy::reset();
+      // exercise
+      l.sort();
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(Spy::numLessthan() <= 100 * 7);
+      int expected = 0;
+      for (auto it = l.begin(); it != l.end(); ++it)
+         assertUnit((*it).get() == expected++);
+      assertUnit(l.pTail->data.get() == 99);
+      assertUnit(l.pHead->pPrev == nullptr);
+   }  // teardown
+
+   /***************************************
+    * PERFORMANCE
+    ***************************************/
+
+   // push_back is O(1): one copy of the Spy, no comparisons. Walking
+   // the 100000 nodes already there would blow the time budget.
+   void test_perf_pushback_constant()
+   {  // setup
+      custom::list<Spy> l;
+      for (int i = 0; i < 100000; i++)
+         l.push_back(Spy(i));
+      Spy s(99);
+      Spy::reset();
+      auto pushback = [&]() { l.push_back(s); };
+      // exercise and verify
+      assertPerf(pushback, PerfBudget(5000.0 /*ns*/, 1 /*alloc*/, 0 /*compare*/));
+      assertUnit(l.size() == 100000 + 101);
+      // teardown
+      l.clear();
+   }
+
+   // pop_front is O(1): nothing allocated, no comparisons, and no
+   // time spent on the 100000 nodes behind it
+   void test_perf_popfront_constant()
+   {  // setup
+      custom::list<Spy> l;
+      for (int i = 0; i < 100000; i++)
+         l.push_back(Spy(i));
+      Spy::reset();
+      auto popfront = [&]() { l.pop_front(); };
+      // exercise and verify
+      assertPerf(popfront, PerfBudget(5000.0 /*ns*/, 0 /*alloc*/, 0 /*compare*/));
+      assertUnit(l.size() == 100000 - 101);
+      // teardown
+      l.clear();
+   }
+
+   /***************************************
+    * MEMORY
+    ***************************************/
+
+   // the destructor gives back every node
+   void test_memory_destructor()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      AllocTracker::reset();
+      {
+         custom::list<int> l{ 11, 26, 31 };
+      }  // exercise
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 3);
+      assertUnit(stats.numFree == 3);
+      assertUnit(stats.bytesLive == 0);
+   }  // teardown
+
+   // the move constructor steals the nodes without allocating
+   void test_memory_constructMove()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      custom::list<int> lSrc{ 11, 26, 31 };
+      AllocTracker::reset();
+      // exercise
+      custom::list<int> lDest(std::move(lSrc));
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 0);
+      assertUnit(stats.numFree == 0);
+      assertUnit(lDest.size() == 3);
+      assertUnit(lSrc.empty());
+   }  // teardown
+
+   // each element costs exactly one node
+   void test_memory_bytesPerElement()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      custom::list<int> l;
+      AllocTracker::reset();
+      // exercise
+      for (int i = 0; i < 100; i++)
+         l.push_back(i);
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 100);
+      assertUnit(stats.bytesLive == 100 * sizeof(custom::list<int>::Node));
+   }  // teardown
+
+   // assigning onto a list of the same size reuses every node
+   void test_memory_assignSameSize()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      custom::list<int> lSrc{ 11, 26, 31 };
+      custom::list<int> lDes{ 85, 99, 42 };
+      custom::list<int>::Node * pHead = lDes.pHead;
+      custom::list<int>::Node * pTail = lDes.pTail;
+      AllocTracker::reset();
+      // exercise
+      lDes = lSrc;
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 0);
+      assertUnit(stats.numFree == 0);
+      assertUnit(lDes.pHead == pHead);
+      assertUnit(lDes.pTail == pTail);
+      assertStandardFixture(lDes);
+   }  // teardown
+
+   // assigning a big list onto a small one allocates only the difference
+   void test_memory_assignBigToSmall()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      custom::list<int> lSrc{ 11, 26, 31 };
+      custom::list<int> lDes{ 85 };
+      custom::list<int>::Node * pHead = lDes.pHead;
+      AllocTracker::reset();
+      // exercise
+      lDes = lSrc;
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 2);
+      assertUnit(stats.numFree == 0);
+      assertUnit(lDes.pHead == pHead);
+      assertStandardFixture(lDes);
+   }  // teardown
+
+   // assigning a small list onto a big one frees only the excess
+   void test_memory_assignSmallToBig()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      custom::list<int> lSrc{ 11, 26, 31 };
+      custom::list<int> lDes{ 85, 99, 42, 17, 64 };
+      custom::list<int>::Node * pHead = lDes.pHead;
+      AllocTracker::reset();
+      // exercise
+      lDes = lSrc;
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 0);
+      assertUnit(stats.numFree == 2);
+      assertUnit(lDes.pHead == pHead);
+      assertUnit(lDes.pTail->pNext == nullptr);
+      assertStandardFixture(lDes);
+   }  // teardown
+
+   /***************************************
+    * ALLOCATOR
+    ***************************************/
+
+   // a list drawing from the pool behaves as any other
+   void test_allocator_pool()
+   {  // setup
+      custom::list<int, custom::pool_allocator<int>> l;
+      // exercise
+      l.push_back(26);
+      l.push_front(11);
+      l.push_back(31);
+      // verify
+      //    +----+   +----+   +----+
+      //    | 11 | - | 26 | - | 31 |
+      //    +----+   +----+   +----+
+      assertUnit(l.size() == 3);
+      assertUnit(l.front() == 11);
+      assertUnit(l.back() == 31);
+      assertUnit(l.pHead->pNext->data == 26);
+      assertUnit(l.pHead->pNext->pPrev == l.pHead);
+   }  // teardown
+
+   // insert and erase churn does not reach operator new
+   void test_allocator_poolChurn()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      custom::list<int, custom::pool_allocator<int>> l{ 11, 26, 31 };
+      l.pop_back();
+      l.push_back(31);
+      AllocTracker::reset();
+      // exercise
+      for (int i = 0; i < 100; i++)
+      {
+         l.push_back(i);
+         l.pop_front();
+      }
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 0);
+      assertUnit(stats.numFree == 0);
+      assertUnit(l.size() == 3);
+   }  // teardown
+
+   // a list in an arena on the stack never reaches operator new
+   void test_allocator_arena()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      alignas(16) char buffer[1024];
+      custom::arena a(buffer, sizeof(buffer));
+      AllocTracker::reset();
+      // exercise
+      {
+         custom::list<int, custom::arena_allocator<int>> l{ custom::arena_allocator<int>(a) };
+         l.push_back(11);
+         l.push_back(26);
+         l.push_back(31);
+         l.pop_front();
+      }
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 0);
+      assertUnit(stats.numFree == 0);
+      assertUnit(a.used() > 0);
+   }  // teardown
+
+   // clearing a list of int from an arena just forgets the nodes
+   void test_allocator_arenaClear()
+   {  // setup
+      custom::arena a;
+      custom::list<int, custom::arena_allocator<int>> l{ custom::arena_allocator<int>(a) };
+      l.push_back(11);
+      l.push_back(26);
+      l.push_back(31);
+      std::size_t used = a.used();
+      // exercise
+      l.clear();
+      // verify
+      assertUnit(l.empty());
+      assertUnit(l.pHead == nullptr);
+      assertUnit(l.pTail == nullptr);
+      assertUnit(a.used() == used);
+      l.push_back(99);
+      assertUnit(l.front() == 99);
+      assertUnit(l.back() == 99);
+   }  // teardown
+
+   // elements with a destructor are still destroyed
+   void test_allocator_arenaDestructor()
+   {  // setup
+      custom::arena a;
+      custom::list<Spy, custom::arena_allocator<Spy>> l{ custom::arena_allocator<Spy>(a) };
+      l.push_back(Spy(11));
+      l.push_back(Spy(26));
+      Spy::reset();
+      // exercise
+      l.clear();
+      // verify
+      assertUnit(Spy::numDestructor() == 2);
+      assertUnit(l.empty());
+   }  // teardown
+
+#ifdef __cpp_lib_memory_resource
+   // a pmr list takes its nodes from the memory resource
+   void test_allocator_pmr()
+   {  // setup
+      alignas(16) char buffer[1024];
+      std::pmr::monotonic_buffer_resource resource(buffer, sizeof(buffer),
+                                                   std::pmr::null_memory_resource());
+      custom::pmr::list<int> l(&resource);
+      // exercise
+      l.push_back(26);
+      l.push_front(11);
+      // verify
+      assertUnit(l.size() == 2);
+      assertUnit((char *)l.pHead >= buffer && (char *)l.pHead < buffer + sizeof(buffer));
+      assertUnit((char *)l.pTail >= buffer && (char *)l.pTail < buffer + sizeof(buffer));
+      assertUnit(l.front() == 11);
+      assertUnit(l.back() == 26);
+   }  // teardown
+#endif // __cpp_lib_memory_resource
+
    /****************************************************************
     * Setup Standard Fixture
     *        pHead             pTail
@@ -2405,6 +3035,26 @@ public:
       }
    }
 
+   /****************************************************************
+    * MATCHES
+    * Does the list hold exactly these items, linked both ways?
+    ****************************************************************/
+   bool matches(const custom::list<int>& l, const std::initializer_list<int>& il)
+   {
+      if (l.numElements != il.size())
+         return false;
+      custom::list<int>::Node* pPrev = nullptr;
+      custom::list<int>::Node* p = l.pHead;
+      for (int i : il)
+      {
+         if (p == nullptr || p->data != i || p->pPrev != pPrev)
+            return false;
+         pPrev = p;
+         p = p->pNext;
+      }
+      return p == nullptr && l.pTail == pPrev;
+   }
+
    /****************************************************************
     * Verify Empty Fixture
     ****************************************************************/
@@ -14,6 +14,8 @@
 #include "unitTest.h"   // unit test baseclass
 #include "spy.h"        // spy is a mock class to monitor the class under test
 
+#include <utility>      // for std::pair to compare sizes against
+
 /***********************************************
  * TEST PAIR
  * Unit tests for the Pair class
@@ -27,60 +29,65 @@ public:
       reset();
       
       // Create
-      test_create_default();
-      test_create_nondefault();
-      test_create_nondefaultMove();
+      addTest(test_create_default);
+      addTest(test_create_nondefault);
+      addTest(test_create_nondefaultMove);
       
       // Make Pair
-      test_makePair_default();
-      test_makePair_nondefault();
+      addTest(test_makePair_default);
+      addTest(test_makePair_nondefault);
       
       // Delete
-      test_delete_default();
-      test_delete_standard();
+      addTest(test_delete_default);
+      addTest(test_delete_standard);
             
       // Copy
-      test_copy_default();
-      test_copy_standard();
+      addTest(test_copy_default);
+      addTest(test_copy_standard);
 
       // Copy move
-      test_copyMove_default();
-      test_copyMove_standard();
+      addTest(test_copyMove_default);
+      addTest(test_copyMove_standard);
       
       // Assign
-      test_assign_defaultToDefault();
-      test_assign_standardToDefault();
-      test_assign_defaultToStandard();
-      test_assign_standardToStandard();
+      addTest(test_assign_defaultToDefault);
+      addTest(test_assign_standardToDefault);
+      addTest(test_assign_defaultToStandard);
+      addTest(test_assign_standardToStandard);
       
       // Assign Move
-      test_assignMove_defaultToDefault();
-      test_assignMove_standardToDefault();
-      test_assignMove_defaultToStandard();
-      test_assignMove_standardToStandard();
+      addTest(test_assignMove_defaultToDefault);
+      addTest(test_assignMove_standardToDefault);
+      addTest(test_assignMove_defaultToStandard);
+      addTest(test_assignMove_standardToStandard);
 
       // Direct Access
-      test_directAccess_namedRead();
-      test_directAccess_namedWrite();
+      addTest(test_directAccess_namedRead);
+      addTest(test_directAccess_namedWrite);
 
       // Equivalence
-      test_equivalence_same();
-      test_equivalence_firstSmaller();
-      test_equivalence_firstLarger();
+      addTest(test_equivalence_same);
+      addTest(test_equivalence_firstSmaller);
+      addTest(test_equivalence_firstLarger);
       
       // Swap
-      test_swap_defaultToDefault();
-      test_swap_standardToDefault();
-      test_swap_defaultToStandard();
-      test_swap_standardToStandard();
-      test_swapStandalone_defaultToDefault();
-      test_swapStandalone_standardToDefault();
-      test_swapStandalone_defaultToStandard();
-      test_swapStandalone_standardToStandard();
+      addTest(test_swap_defaultToDefault);
+      addTest(test_swap_standardToDefault);
+      addTest(test_swap_defaultToStandard);
+      addTest(test_swap_standardToStandard);
+      addTest(test_swapStandalone_defaultToDefault);
+      addTest(test_swapStandalone_standardToDefault);
+      addTest(test_swapStandalone_defaultToStandard);
+      addTest(test_swapStandalone_standardToStandard);
   
       // Get
-      test_get_firstRead();
+      addTest(test_get_firstRead);
+
+      // Size
+      addTest(test_size_emptyCompare);
+      addTest(test_size_statefulCompare);
       
+      runTests();
       report("Pair");
    }
    
@@ -100,6 +107,45 @@ public:
 //      answer = custom::test<1>(p);
    }
    
+   /***************************************
+    * SIZE
+    ***************************************/
+
+   // a comparator with no state takes no space
+   void test_size_emptyCompare()
+   {  // setup
+      // exercise
+      // verify
+      assertUnit(sizeof(custom::pair<int, int>) == 2 * sizeof(int));
+      assertUnit(sizeof(custom::pair<int, double>) == sizeof(std::pair<int, double>));
+      custom::pair<int, int> p1(26, 1);
+      custom::pair<int, int> p2(49, 2);
+      assertUnit(p1 < p2);
+      assertUnit(!(p2 < p1));
+   }  // teardown
+
+   // a comparator with state is still kept and used
+   void test_size_statefulCompare()
+   {  // setup
+      struct Reversed
+      {
+         bool descending;
+         bool operator () (int lhs, int rhs) const
+         {
+            return descending ? rhs < lhs : lhs < rhs;
+         }
+      };
+      Reversed reversed{ true };
+      // exercise
+      custom::pair<int, int, Reversed> p1(26, 1, reversed);
+      custom::pair<int, int, Reversed> p2(49, 2, reversed);
+      // verify
+      assertUnit(sizeof(p1) > 2 * sizeof(int));
+      assertUnit(p1.key_comp().descending);
+      assertUnit(p2 < p1);
+      assertUnit(!(p1 < p2));
+   }  // teardown
+
    /***************************************
     * CREATE
     ***************************************/
@@ -0,0 +1,276 @@
+/***********************************************************************
+ * Header:
+ *    TEST PARALLEL
+ * Summary:
+ *    Unit tests for the parallel algorithms
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "parallel.h"   // functions under test
+#include "simd.h"       // for custom::count
+#include "unitTest.h"   // unit test baseclass
+
+#include <algorithm>    // for std::is_sorted
+#include <atomic>       // for std::atomic
+#include <functional>   // for std::greater
+#include <stdexcept>    // for std::runtime_error
+
+/***********************************************
+ * TEST PARALLEL
+ * Most tests use a small grain so that even a modest
+ * vector is split into many tasks.
+ ***********************************************/
+class TestParallel : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Pool
+      addTest(test_pool_ownPool);
+      addTest(test_taskGroup_nested);
+      addTest(test_taskGroup_exception);
+
+      // For each and transform
+      addTest(test_forEach_every);
+      addTest(test_transform_type);
+
+      // Reduce and scan
+      addTest(test_reduce_sum);
+      addTest(test_reduce_order);
+      addTest(test_scan_sum);
+      addTest(test_scan_inPlace);
+
+      // Sort
+      addTest(test_sort_random);
+      addTest(test_sort_duplicates);
+      addTest(test_sort_greater);
+      addTest(test_sort_small);
+
+      runTests();
+      report("Parallel");
+   }
+
+   /***************************************
+    * POOL
+    ***************************************/
+
+   // a pool of our own runs every task it is given
+   void test_pool_ownPool()
+   {  // setup
+      custom::parallel::thread_pool pool(3);
+      std::atomic<int> sum(0);
+      // exercise
+      {
+         custom::parallel::task_group group(pool);
+         for (int i = 1; i <= 100; i++)
+            group.run([&sum, i] { sum += i; });
+         group.wait();
+      }
+      // verify
+      assertUnit(pool.size() == 4);
+      assertUnit(sum == 5050);
+   }  // teardown
+
+   // tasks that start tasks and wait on them do not deadlock
+   void test_taskGroup_nested()
+   {  // setup
+      std::atomic<int> count(0);
+      // exercise
+      custom::parallel::task_group outer;
+      for (int i = 0; i < 16; i++)
+         outer.run([&count]
+         {
+            custom::parallel::task_group inner;
+            for (int j = 0; j < 16; j++)
+               inner.run([&count] { count++; });
+            inner.wait();
+         });
+      outer.wait();
+      // verify
+      assertUnit(count == 256);
+   }  // teardown
+
+   // the exception a task throws comes out of wait
+   void test_taskGroup_exception()
+   {  // setup
+      custom::parallel::task_group group;
+      bool thrown = false;
+      // exercise
+      group.run([] { throw std::runtime_error("task"); });
+      try
+      {
+         group.wait();
+      }
+      catch (const std::runtime_error &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+   }  // teardown
+
+   /***************************************
+    * FOR EACH and TRANSFORM
+    ***************************************/
+
+   // every element is visited exactly once
+   void test_forEach_every()
+   {  // setup
+      custom::vector<int> v(10000);
+      // exercise
+      custom::parallel::for_each(v, [](int & i) { i++; }, 64);
+      // verify
+      assertUnit(custom::count(v, 1) == 10000);
+   }  // teardown
+
+   // the destination may hold another type
+   void test_transform_type()
+   {  // setup
+      custom::vector<int> vSrc;
+      for (int i = 0; i < 5000; i++)
+         vSrc.push_back(i);
+      custom::vector<double> vDest;
+      // exercise
+      custom::parallel::transform(vSrc, vDest, [](int i) { return i * 0.5; }, 64);
+      // verify
+      assertUnit(vDest.size() == 5000);
+      assertUnit(vDest[0] == 0.0);
+      assertUnit(vDest[4999] == 2499.5);
+   }  // teardown
+
+   /***************************************
+    * REDUCE and SCAN
+    ***************************************/
+
+   // the sum of 1..100000
+   void test_reduce_sum()
+   {  // setup
+      custom::vector<long long> v;
+      for (long long i = 1; i <= 100000; i++)
+         v.push_back(i);
+      // exercise
+      long long sum = custom::parallel::reduce(v, 0LL,
+         [](long long a, long long b) { return a + b; }, 64);
+      // verify
+      assertUnit(sum == 5000050000LL);
+      assertUnit(custom::parallel::reduce(v) == 5000050000LL);
+   }  // teardown
+
+   // chunks are combined in order, so an operator that does not commute works
+   void test_reduce_order()
+   {  // setup
+      custom::vector<int> v;
+      for (int i = 0; i < 1000; i++)
+         v.push_back(i % 10);
+      // exercise: the last digit seen, left to right
+      int last = custom::parallel::reduce(v, -1, [](int, int b) { return b; }, 16);
+      // verify
+      assertUnit(last == 9);
+   }  // teardown
+
+   // each element is the sum of those before it and itself
+   void test_scan_sum()
+   {  // setup
+      custom::vector<int> vSrc(10001, 1);
+      custom::vector<int> vDest;
+      // exercise
+      custom::parallel::inclusive_scan(vSrc, vDest, [](int a, int b) { return a + b; }, 64);
+      // verify
+      assertUnit(vDest.size() == 10001);
+      bool good = true;
+      for (int i = 0; i < 10001; i++)
+         good = good && vDest[i] == i + 1;
+      assertUnit(good);
+   }  // teardown
+
+   // a vector can be scanned onto itself
+   void test_scan_inPlace()
+   {  // setup
+      custom::vector<long long> v;
+      for (long long i = 0; i < 3000; i++)
+         v.push_back(i);
+      // exercise
+      custom::parallel::inclusive_scan(v, v);
+      // verify
+      assertUnit(v[0] == 0);
+      assertUnit(v[10] == 55);
+      assertUnit(v[2999] == 2999LL * 3000 / 2);
+   }  // teardown
+
+   /***************************************
+    * SORT
+    ***************************************/
+
+   // a large pseudo-random vector ends up in order with nothing lost
+   void test_sort_random()
+   {  // setup
+      custom::vector<unsigned int> v;
+      unsigned int x = 2463534242u;
+      long long sumBefore = 0;
+      for (int i = 0; i < 200000; i++)
+      {
+         x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+         v.push_back(x);
+         sumBefore += x;
+      }
+      // exercise
+      custom::parallel::sort(v);
+      // verify
+      assertUnit(std::is_sorted(&v[0], &v[0] + v.size()));
+      assertUnit(custom::parallel::reduce(v, 0LL,
+         [](long long a, long long b) { return a + b; }) == sumBefore);
+   }  // teardown
+
+   // only a few distinct keys
+   void test_sort_duplicates()
+   {  // setup
+      custom::vector<int> v;
+      for (int i = 0; i < 50000; i++)
+         v.push_back((i * 7919) % 5);
+      // exercise
+      custom::parallel::sort(v, std::less<int>(), 64);
+      // verify
+      assertUnit(std::is_sorted(&v[0], &v[0] + v.size()));
+      assertUnit(custom::count(v, 0) == 10000);
+      assertUnit(v[49999] == 4);
+   }  // teardown
+
+   // any strict weak ordering will do
+   void test_sort_greater()
+   {  // setup
+      custom::vector<int> v;
+      for (int i = 0; i < 20000; i++)
+         v.push_back(i);
+      // exercise
+      custom::parallel::sort(v, std::greater<int>(), 64);
+      // verify
+      assertUnit(v[0] == 19999);
+      assertUnit(v[19999] == 0);
+      assertUnit(std::is_sorted(&v[0], &v[0] + v.size(), std::greater<int>()));
+   }  // teardown
+
+   // below the cutoff it is an ordinary sort
+   void test_sort_small()
+   {  // setup
+      custom::vector<int> v{ 67, 26, 89, 49 };
+      custom::vector<int> vEmpty;
+      // exercise
+      custom::parallel::sort(v);
+      custom::parallel::sort(vEmpty);
+      // verify
+      assertUnit(v[0] == 26);
+      assertUnit(v[1] == 49);
+      assertUnit(v[2] == 67);
+      assertUnit(v[3] == 89);
+      assertUnit(vEmpty.empty());
+   }  // teardown
+};
+
+#endif // DEBUG
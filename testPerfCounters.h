@@ -0,0 +1,122 @@
+/***********************************************************************
+ * Header:
+ *    TEST PERF COUNTERS
+ * Summary:
+ *    Unit tests for the hardware performance counters. These pass
+ *    whether or not the machine lets us read the counters.
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+#ifdef DEBUG
+
+#include "perfCounters.h"  // class under test
+#include "unitTest.h"      // unit test baseclass
+
+/***********************************************
+ * TEST PERF COUNTERS
+ * Unit tests for the custom::perf_counters class
+ ***********************************************/
+class TestPerfCounters : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      addTest(test_construct_notCounting);
+      addTest(test_construct_available);
+
+      // Count
+      addTest(test_count_loop);
+      addTest(test_count_stopped);
+
+      // Name
+      addTest(test_name_all);
+
+      runTests();
+      report("PerfCounters");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // nothing is counted until start()
+   void test_construct_notCounting()
+   {  // setup
+      // exercise
+      custom::perf_counters counters;
+      // verify
+      for (int e = 0; e < custom::perf_counters::NUM_EVENTS; e++)
+         assertUnit(counters.get(custom::perf_counters::event(e)) == 0);
+   }  // teardown
+
+   // available() is true when any one counter is
+   void test_construct_available()
+   {  // setup
+      // exercise
+      custom::perf_counters counters;
+      // verify
+      bool any = false;
+      for (int e = 0; e < custom::perf_counters::NUM_EVENTS; e++)
+         any = any || counters.available(custom::perf_counters::event(e));
+      assertUnit(any == counters.available());
+   }  // teardown
+
+   /***************************************
+    * COUNT
+    ***************************************/
+
+   // a loop retires at least one instruction per trip, or reads zero
+   void test_count_loop()
+   {  // setup
+      custom::perf_counters counters;
+      volatile int sum = 0;
+      // exercise
+      counters.start();
+      for (int i = 0; i < 10000; i++)
+         sum = sum + i;
+      counters.stop();
+      // verify
+      std::uint64_t instructions = counters.get(custom::perf_counters::INSTRUCTIONS);
+      if (counters.available(custom::perf_counters::INSTRUCTIONS))
+         assertUnit(instructions >= 10000);
+      else
+         assertUnit(instructions == 0);
+   }  // teardown
+
+   // work done after stop() is not counted
+   void test_count_stopped()
+   {  // setup
+      custom::perf_counters counters;
+      volatile int sum = 0;
+      counters.start();
+      counters.stop();
+      std::uint64_t before = counters.get(custom::perf_counters::INSTRUCTIONS);
+      // exercise
+      for (int i = 0; i < 10000; i++)
+         sum = sum + i;
+      // verify
+      assertUnit(counters.get(custom::perf_counters::INSTRUCTIONS) == before);
+   }  // teardown
+
+   /***************************************
+    * NAME
+    ***************************************/
+
+   // every counter has a name for the reports
+   void test_name_all()
+   {  // setup
+      // exercise
+      // verify
+      for (int e = 0; e < custom::perf_counters::NUM_EVENTS; e++)
+         assertUnit(custom::perf_counters::name(custom::perf_counters::event(e)) != nullptr);
+      assertUnit(std::string("cycles") ==
+                 custom::perf_counters::name(custom::perf_counters::CYCLES));
+   }  // teardown
+};
+
+#endif // DEBUG
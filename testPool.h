@@ -0,0 +1,184 @@
+/***********************************************************************
+ * Header:
+ *    TEST POOL
+ * Summary:
+ *    Unit tests for the slab pool and its allocator
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+#ifdef DEBUG
+
+#include "pool.h"          // class under test
+#include "allocTracker.h"  // to see what reaches operator new
+#include "unitTest.h"      // unit test baseclass
+
+/***********************************************
+ * TEST POOL
+ * Unit tests for custom::slab_pool and custom::pool_allocator
+ ***********************************************/
+class TestPool : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Size Class
+      addTest(test_sizeClass_boundaries);
+
+      // Allocate
+      addTest(test_allocate_aligned);
+      addTest(test_allocate_distinct);
+      addTest(test_allocate_reuse);
+      addTest(test_allocate_noMalloc);
+      addTest(test_allocate_big);
+
+      // Allocator
+      addTest(test_allocator_rebind);
+      addTest(test_allocator_overAligned);
+
+      runTests();
+      report("Pool");
+   }
+
+   /***************************************
+    * SIZE CLASS
+    ***************************************/
+
+   // sizes round up to the next multiple of 16
+   void test_sizeClass_boundaries()
+   {  // setup
+      // exercise
+      // verify
+      assertUnit(custom::slab_pool::sizeClass(1) == 0);
+      assertUnit(custom::slab_pool::sizeClass(16) == 0);
+      assertUnit(custom::slab_pool::sizeClass(17) == 1);
+      assertUnit(custom::slab_pool::sizeClass(24) == 1);
+      assertUnit(custom::slab_pool::sizeClass(256) == custom::slab_pool::NUM_CLASSES - 1);
+   }  // teardown
+
+   /***************************************
+    * ALLOCATE
+    ***************************************/
+
+   // every block is 16-byte aligned
+   void test_allocate_aligned()
+   {  // setup
+      // exercise
+      void * p1 = custom::slab_pool::allocate(24);
+      void * p2 = custom::slab_pool::allocate(24);
+      // verify
+      assertUnit(((std::size_t)p1 % custom::slab_pool::ALIGN) == 0);
+      assertUnit(((std::size_t)p2 % custom::slab_pool::ALIGN) == 0);
+      // teardown
+      custom::slab_pool::deallocate(p1, 24);
+      custom::slab_pool::deallocate(p2, 24);
+   }
+
+   // two live blocks never overlap
+   void test_allocate_distinct()
+   {  // setup
+      // exercise
+      char * p1 = (char *)custom::slab_pool::allocate(32);
+      char * p2 = (char *)custom::slab_pool::allocate(32);
+      // verify
+      assertUnit(p1 != p2);
+      assertUnit(p1 + 32 <= p2 || p2 + 32 <= p1);
+      // teardown
+      custom::slab_pool::deallocate(p1, 32);
+      custom::slab_pool::deallocate(p2, 32);
+   }
+
+   // a freed block is the next one handed out
+   void test_allocate_reuse()
+   {  // setup
+      void * p1 = custom::slab_pool::allocate(48);
+      custom::slab_pool::deallocate(p1, 48);
+      // exercise
+      void * p2 = custom::slab_pool::allocate(48);
+      // verify
+      assertUnit(p1 == p2);
+      // teardown
+      custom::slab_pool::deallocate(p2, 48);
+   }
+
+   // once warm, churn never reaches operator new
+   void test_allocate_noMalloc()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      custom::slab_pool::deallocate(custom::slab_pool::allocate(64), 64);
+      AllocTracker::reset();
+      // exercise
+      for (int i = 0; i < 100; i++)
+         custom::slab_pool::deallocate(custom::slab_pool::allocate(64), 64);
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 0);
+      assertUnit(stats.numFree == 0);
+   }  // teardown
+
+   // big blocks go straight to operator new
+   void test_allocate_big()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      AllocTracker::reset();
+      // exercise
+      void * p = custom::slab_pool::allocate(1000);
+      custom::slab_pool::deallocate(p, 1000);
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 1);
+      assertUnit(stats.numFree == 1);
+      assertUnit(stats.bytesAlloc == 1000);
+   }  // teardown
+
+   /***************************************
+    * ALLOCATOR
+    ***************************************/
+
+   // a rebound allocator draws from the same pool
+   void test_allocator_rebind()
+   {  // setup
+      custom::pool_allocator<int> allocInt;
+      // exercise
+      custom::pool_allocator<double> allocDouble(allocInt);
+      double * p = allocDouble.allocate(1);
+      *p = 99.9;
+      // verify
+      assertUnit(allocInt == allocDouble);
+      assertUnit(*p == 99.9);
+      // teardown
+      allocDouble.deallocate(p, 1);
+   }
+
+   // an array of an over-aligned type keeps its alignment
+   void test_allocator_overAligned()
+   {  // setup
+      struct alignas(64) Line { char data[64]; };
+      custom::pool_allocator<Line> alloc;
+      AllocTracker::reset();
+      // exercise
+      Line * p1 = alloc.allocate(1);
+      Line * p3 = alloc.allocate(3);
+      std::size_t address1 = (std::size_t)p1;
+      std::size_t address3 = (std::size_t)p3;
+      alloc.deallocate(p1, 1);
+      alloc.deallocate(p3, 3);
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(address1 % 64 == 0);
+      assertUnit(address3 % 64 == 0);
+      if (AllocTracker::enabled())
+      {
+         assertUnit(stats.numAlloc == 2);
+         assertUnit(stats.numFree == 2);
+         assertUnit(stats.bytesLive == 0);
+      }
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,228 @@
+/***********************************************************************
+ * Header:
+ *    TEST RADIX SORT
+ * Summary:
+ *    Unit tests for the radix sort
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "radixSort.h"  // function under test
+#include "unitTest.h"   // unit test baseclass
+
+#include <algorithm>    // for std::is_sorted
+#include <cstdint>      // for std::uint64_t
+#include <string>       // for the pair values
+
+/***********************************************
+ * TEST RADIX SORT
+ * The keys come from a xorshift generator so each
+ * run sorts the same pseudo-random data.
+ ***********************************************/
+class TestRadixSort : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Integers
+      addTest(test_sort_empty);
+      addTest(test_sort_short);
+      addTest(test_sort_unsigned);
+      addTest(test_sort_signed);
+      addTest(test_sort_int64);
+
+      // Floating point
+      addTest(test_sort_float);
+      addTest(test_sort_double);
+
+      // Pairs
+      addTest(test_sort_pairStable);
+
+      // Skipping digits
+      addTest(test_passes_smallKeys);
+      addTest(test_passes_sameKeys);
+
+      runTests();
+      report("RadixSort");
+   }
+
+   /***************************************
+    * INTEGERS
+    ***************************************/
+
+   // nothing to do with zero or one element
+   void test_sort_empty()
+   {  // setup
+      custom::vector<int> vEmpty;
+      custom::vector<int> vOne{ 26 };
+      // exercise
+      std::size_t passes = custom::radix_sort(vEmpty) + custom::radix_sort(vOne);
+      // verify
+      assertUnit(passes == 0);
+      assertUnit(vEmpty.empty());
+      assertUnit(vOne[0] == 26);
+   }  // teardown
+
+   // a short vector is sorted too
+   void test_sort_short()
+   {  // setup
+      custom::vector<int> v{ 67, -26, 89, 49, 0 };
+      // exercise
+      custom::radix_sort(v);
+      // verify
+      assertUnit(v[0] == -26);
+      assertUnit(v[1] == 0);
+      assertUnit(v[2] == 49);
+      assertUnit(v[3] == 67);
+      assertUnit(v[4] == 89);
+   }  // teardown
+
+   // the whole range of unsigned int
+   void test_sort_unsigned()
+   {  // setup
+      custom::vector<unsigned int> v;
+      for (int i = 0; i < 10000; i++)
+         v.push_back(static_cast<unsigned int>(next()));
+      // exercise
+      custom::radix_sort(v);
+      // verify
+      assertUnit(v.size() == 10000);
+      assertUnit(std::is_sorted(&v[0], &v[0] + v.size()));
+   }  // teardown
+
+   // negative numbers come before positive ones
+   void test_sort_signed()
+   {  // setup
+      custom::vector<int> v;
+      for (int i = 0; i < 10000; i++)
+         v.push_back(static_cast<int>(next()));
+      v.push_back(-2147483647 - 1);
+      v.push_back(2147483647);
+      // exercise
+      custom::radix_sort(v);
+      // verify
+      assertUnit(std::is_sorted(&v[0], &v[0] + v.size()));
+      assertUnit(v.front() == -2147483647 - 1);
+      assertUnit(v.back() == 2147483647);
+   }  // teardown
+
+   // all eight bytes of a 64-bit key
+   void test_sort_int64()
+   {  // setup
+      custom::vector<long long> v;
+      for (int i = 0; i < 10000; i++)
+         v.push_back(static_cast<long long>(next()));
+      // exercise
+      std::size_t passes = custom::radix_sort(v);
+      // verify
+      assertUnit(passes == 8);
+      assertUnit(std::is_sorted(&v[0], &v[0] + v.size()));
+   }  // teardown
+
+   /***************************************
+    * FLOATING POINT
+    ***************************************/
+
+   // negative floats, small and large, in order
+   void test_sort_float()
+   {  // setup
+      custom::vector<float> v;
+      for (int i = 0; i < 1000; i++)
+         v.push_back(static_cast<float>(static_cast<int>(next() % 20001) - 10000) / 7.0f);
+      v.push_back(-1.0e30f);
+      v.push_back(1.0e30f);
+      // exercise
+      custom::radix_sort(v);
+      // verify
+      assertUnit(std::is_sorted(&v[0], &v[0] + v.size()));
+      assertUnit(v.front() == -1.0e30f);
+      assertUnit(v.back() == 1.0e30f);
+   }  // teardown
+
+   // doubles on both sides of zero
+   void test_sort_double()
+   {  // setup
+      custom::vector<double> v;
+      for (int i = 0; i < 1000; i++)
+         v.push_back((static_cast<double>(next() % 2000001) - 1000000.0) / 3.0);
+      // exercise
+      custom::radix_sort(v);
+      // verify
+      assertUnit(std::is_sorted(&v[0], &v[0] + v.size()));
+   }  // teardown
+
+   /***************************************
+    * PAIRS
+    ***************************************/
+
+   // pairs sort on first, and equal keys keep their order
+   void test_sort_pairStable()
+   {  // setup
+      custom::vector<custom::pair<int, std::string>> v;
+      for (int i = 0; i < 100; i++)
+         v.push_back(custom::pair<int, std::string>(i % 10 - 5, std::string(1, char('A' + i / 10))));
+      // exercise
+      custom::radix_sort(v);
+      // verify
+      bool good = true;
+      for (std::size_t i = 1; i < v.size(); i++)
+      {
+         good = good && v[i - 1].first <= v[i].first;
+         if (v[i - 1].first == v[i].first)
+            good = good && v[i - 1].second < v[i].second;
+      }
+      assertUnit(good);
+      assertUnit(v[0].first == -5);
+      assertUnit(v[0].second == "A");
+      assertUnit(v[9].second == "J");
+      assertUnit(v[99].first == 4);
+   }  // teardown
+
+   /***************************************
+    * SKIPPING DIGITS
+    ***************************************/
+
+   // keys below 256 vary in one byte only
+   void test_passes_smallKeys()
+   {  // setup
+      custom::vector<std::uint64_t> v;
+      for (int i = 0; i < 1000; i++)
+         v.push_back(next() % 256);
+      // exercise
+      std::size_t passes = custom::radix_sort(v);
+      // verify
+      assertUnit(passes == 1);
+      assertUnit(std::is_sorted(&v[0], &v[0] + v.size()));
+   }  // teardown
+
+   // identical keys need no pass at all
+   void test_passes_sameKeys()
+   {  // setup
+      custom::vector<int> v(1000, 42);
+      // exercise
+      std::size_t passes = custom::radix_sort(v);
+      // verify
+      assertUnit(passes == 0);
+      assertUnit(v[0] == 42);
+      assertUnit(v[999] == 42);
+   }  // teardown
+
+private:
+   // xorshift64, one sequence per thread so tests may run side by side
+   static std::uint64_t next()
+   {
+      static thread_local std::uint64_t seed = 88172645463325252ULL;
+      seed ^= seed << 13;
+      seed ^= seed >> 7;
+      seed ^= seed << 17;
+      return seed;
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,307 @@
+/***********************************************************************
+ * Header:
+ *    TEST SIMD
+ * Summary:
+ *    Unit tests for the SIMD kernels
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "simd.h"       // functions under test
+#include "unitTest.h"   // unit test baseclass
+#include "spy.h"        // for counting copies of the key
+
+#include <cstdint>      // for std::int64_t
+#include <memory>       // for std::unique_ptr
+#include <string>       // for a T with no vector path
+
+/***********************************************
+ * TEST SIMD
+ * Every test runs at each level this CPU has, from the
+ * plain loop up, so each path gives the same answer.
+ * The sizes are not multiples of the register width
+ * so the leftover elements are covered too.
+ ***********************************************/
+class TestSimd : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Level
+      addTest(test_level_clamp);
+
+      // Find
+      addTest(test_find_int);
+      addTest(test_find_int64);
+      addTest(test_find_double);
+      addTest(test_find_string);
+      addTest(test_find_noCopy);
+      addTest(test_find_moveOnly);
+      addTest(test_contains_empty);
+
+      // Count
+      addTest(test_count_int);
+      addTest(test_count_float);
+
+      // Min and Max
+      addTest(test_minmax_int);
+      addTest(test_minmax_unsigned);
+      addTest(test_minmax_double);
+
+      // Fill
+      addTest(test_fill_int);
+      addTest(test_fill_int64);
+
+      runTests();
+      custom::simd::setLevel(custom::simd::detect());
+      report("Simd");
+   }
+
+   /***************************************
+    * LEVEL
+    ***************************************/
+
+   // the level can go down but never above the CPU
+   void test_level_clamp()
+   {  // setup
+      custom::simd::Level most = custom::simd::detect();
+      // exercise
+      custom::simd::setLevel(custom::simd::AVX2);
+      // verify
+      assertUnit(custom::simd::level() == most);
+      // exercise
+      custom::simd::setLevel(custom::simd::SCALAR);
+      // verify
+      assertUnit(custom::simd::level() == custom::simd::SCALAR);
+      // teardown
+      custom::simd::setLevel(most);
+   }
+
+   /***************************************
+    * FIND
+    ***************************************/
+
+   // every position of 0..36 is found, and a missing value is not
+   void test_find_int()
+   {
+      for (int l = custom::simd::SCALAR; l <= custom::simd::detect(); l++)
+      {  // setup
+         custom::simd::setLevel(custom::simd::Level(l));
+         custom::vector<int> v;
+         for (int i = 0; i < 37; i++)
+            v.push_back(i * 10);
+         // exercise and verify
+         for (int i = 0; i < 37; i++)
+            assertUnit(custom::find(v, i * 10) == custom::vector<int>::iterator(&v[i]));
+         assertUnit(custom::find(v, 5) == v.end());
+         assertUnit(custom::contains(v, 360));
+         assertUnit(!custom::contains(v, -10));
+      }  // teardown
+   }
+
+   // 64-bit integers compare all 64 bits
+   void test_find_int64()
+   {
+      for (int l = custom::simd::SCALAR; l <= custom::simd::detect(); l++)
+      {  // setup
+         custom::simd::setLevel(custom::simd::Level(l));
+         custom::vector<std::int64_t> v;
+         for (std::int64_t i = 0; i < 11; i++)
+            v.push_back(i << 32);
+         // exercise and verify
+         assertUnit(custom::find(v, std::int64_t(7) << 32) == custom::vector<std::int64_t>::iterator(&v[7]));
+         assertUnit(custom::find(v, std::int64_t(7)) == v.end());
+         assertUnit(custom::contains(v, std::int64_t(10) << 32));
+      }  // teardown
+   }
+
+   // the first of two equal doubles is the one found
+   void test_find_double()
+   {
+      for (int l = custom::simd::SCALAR; l <= custom::simd::detect(); l++)
+      {  // setup
+         custom::simd::setLevel(custom::simd::Level(l));
+         custom::vector<double> v{ 1.5, 2.5, 3.5, 4.5, 5.5, 2.5, 7.5 };
+         // exercise and verify
+         assertUnit(custom::find(v, 2.5) == custom::vector<double>::iterator(&v[1]));
+         assertUnit(custom::find(v, 7.5) == custom::vector<double>::iterator(&v[6]));
+         assertUnit(custom::find(v, 0.0) == v.end());
+      }  // teardown
+   }
+
+   // a T with no vector path still works, one element at a time
+   void test_find_string()
+   {  // setup
+      custom::vector<std::string> v{ "Alpha", "Bravo", "Charlie" };
+      // exercise and verify
+      assertUnit(custom::find(v, std::string("Bravo")) == custom::vector<std::string>::iterator(&v[1]));
+      assertUnit(custom::count(v, std::string("Delta")) == 0);
+   }  // teardown
+
+   // a class key is compared where it is, never copied
+   void test_find_noCopy()
+   {  // setup
+      Spy a[5] = { Spy(26), Spy(49), Spy(67), Spy(11), Spy(49) };
+      Spy s(49);
+      Spy::reset();
+      // exercise
+      std::size_t i = custom::simd::find(a, 5, s);
+      std::size_t n = custom::simd::count(a, 5, s);
+      // verify
+      assertUnit(i == 1);
+      assertUnit(n == 2);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numEquals() == 2 + 5);
+   }  // teardown
+
+   // a key that cannot be copied can still be found
+   void test_find_moveOnly()
+   {  // setup
+      std::unique_ptr<int> a[3];
+      a[1].reset(new int(26));
+      // exercise and verify
+      assertUnit(custom::simd::find(a, 3, a[1]) == 1);
+      assertUnit(custom::simd::count(a, 3, a[0]) == 2);
+   }  // teardown
+
+   // nothing is in an empty vector
+   void test_contains_empty()
+   {  // setup
+      custom::vector<int> v;
+      // exercise and verify
+      assertUnit(!custom::contains(v, 0));
+      assertUnit(custom::find(v, 0) == v.end());
+      assertUnit(custom::count(v, 0) == 0);
+   }  // teardown
+
+   /***************************************
+    * COUNT
+    ***************************************/
+
+   // count every third element of 0..99
+   void test_count_int()
+   {
+      for (int l = custom::simd::SCALAR; l <= custom::simd::detect(); l++)
+      {  // setup
+         custom::simd::setLevel(custom::simd::Level(l));
+         custom::vector<int> v;
+         for (int i = 0; i < 100; i++)
+            v.push_back(i % 3);
+         // exercise and verify
+         assertUnit(custom::count(v, 0) == 34);
+         assertUnit(custom::count(v, 1) == 33);
+         assertUnit(custom::count(v, 3) == 0);
+      }  // teardown
+   }
+
+   // floats compare by value
+   void test_count_float()
+   {
+      for (int l = custom::simd::SCALAR; l <= custom::simd::detect(); l++)
+      {  // setup
+         custom::simd::setLevel(custom::simd::Level(l));
+         custom::vector<float> v;
+         for (int i = 0; i < 21; i++)
+            v.push_back(i % 2 ? 0.25f : -0.0f);
+         // exercise and verify
+         assertUnit(custom::count(v, 0.25f) == 10);
+         assertUnit(custom::count(v, 0.0f) == 11);
+      }  // teardown
+   }
+
+   /***************************************
+    * MIN AND MAX
+    ***************************************/
+
+   // negative numbers, with the extremes in the leftover elements
+   void test_minmax_int()
+   {
+      for (int l = custom::simd::SCALAR; l <= custom::simd::detect(); l++)
+      {  // setup
+         custom::simd::setLevel(custom::simd::Level(l));
+         custom::vector<int> v;
+         for (int i = 0; i < 19; i++)
+            v.push_back((i * 7) % 19 - 9);
+         v.push_back(-50);
+         v.push_back(50);
+         // exercise and verify
+         assertUnit(custom::min(v) == -50);
+         assertUnit(custom::max(v) == 50);
+      }  // teardown
+   }
+
+   // unsigned values above the largest int are still the biggest
+   void test_minmax_unsigned()
+   {
+      for (int l = custom::simd::SCALAR; l <= custom::simd::detect(); l++)
+      {  // setup
+         custom::simd::setLevel(custom::simd::Level(l));
+         custom::vector<unsigned int> v;
+         for (unsigned int i = 0; i < 17; i++)
+            v.push_back(i + 3);
+         v[5] = 0xF0000000u;
+         // exercise and verify
+         assertUnit(custom::min(v) == 3u);
+         assertUnit(custom::max(v) == 0xF0000000u);
+      }  // teardown
+   }
+
+   // a single element is both
+   void test_minmax_double()
+   {
+      for (int l = custom::simd::SCALAR; l <= custom::simd::detect(); l++)
+      {  // setup
+         custom::simd::setLevel(custom::simd::Level(l));
+         custom::vector<double> vOne{ 3.25 };
+         custom::vector<double> v{ 2.0, -1.5, 8.0, 0.5, 3.0, -7.25, 4.0 };
+         // exercise and verify
+         assertUnit(custom::min(vOne) == 3.25);
+         assertUnit(custom::max(vOne) == 3.25);
+         assertUnit(custom::min(v) == -7.25);
+         assertUnit(custom::max(v) == 8.0);
+      }  // teardown
+   }
+
+   /***************************************
+    * FILL
+    ***************************************/
+
+   // every element, including the leftovers, gets the value
+   void test_fill_int()
+   {
+      for (int l = custom::simd::SCALAR; l <= custom::simd::detect(); l++)
+      {  // setup
+         custom::simd::setLevel(custom::simd::Level(l));
+         custom::vector<int> v(13);
+         // exercise
+         custom::fill(v, 99);
+         // verify
+         assertUnit(custom::count(v, 99) == 13);
+         assertUnit(v.size() == 13);
+      }  // teardown
+   }
+
+   // 64-bit values are written whole
+   void test_fill_int64()
+   {
+      for (int l = custom::simd::SCALAR; l <= custom::simd::detect(); l++)
+      {  // setup
+         custom::simd::setLevel(custom::simd::Level(l));
+         custom::vector<std::int64_t> v(7);
+         std::int64_t value = (std::int64_t(3) << 40) + 1;
+         // exercise
+         custom::fill(v, value);
+         // verify
+         for (std::size_t i = 0; i < v.size(); i++)
+            assertUnit(v[i] == value);
+      }  // teardown
+   }
+};
+
+#endif // DEBUG
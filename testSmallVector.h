@@ -0,0 +1,330 @@
+/***********************************************************************
+ * Header:
+ *    TEST SMALL VECTOR
+ * Summary:
+ *    Unit tests for the small vector
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "smallVector.h"   // class under test
+#include "unitTest.h"      // unit test baseclass
+#include "allocTracker.h"  // to see when it reaches the heap
+#include "spy.h"           // to see what happens to the elements
+
+/***********************************************
+ * TEST SMALL VECTOR
+ * Unit tests for custom::small_vector. Most use room
+ * for four elements inline so spilling is easy to see.
+ ***********************************************/
+class TestSmallVector : public UnitTest
+{
+   typedef custom::small_vector<int, 4> Vector4;
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      addTest(test_construct_default);
+      addTest(test_construct_initializerList);
+      addTest(test_construct_copyInline);
+      addTest(test_construct_moveInline);
+      addTest(test_construct_moveHeap);
+
+      // Assign
+      addTest(test_assign_heapToInline);
+      addTest(test_swap_inlineHeap);
+
+      // Insert
+      addTest(test_pushback_inline);
+      addTest(test_pushback_spill);
+      addTest(test_pushback_selfReference);
+      addTest(test_emplace_middle);
+      addTest(test_resize_growShrink);
+
+      // Remove
+      addTest(test_clear_spy);
+      addTest(test_shrink_backInline);
+
+      // Memory
+      addTest(test_memory_noHeap);
+
+      runTests();
+      report("SmallVector");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // an empty vector already has room for N
+   void test_construct_default()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      AllocTracker::reset();
+      // exercise
+      Vector4 v;
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 0);
+      assertUnit(v.numElements == 0);
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.isInline());
+      assertUnit(v.empty());
+   }  // teardown
+
+   // an initializer list that fits stays inline
+   void test_construct_initializerList()
+   {  // setup
+      // exercise
+      Vector4 v{ 26, 49, 67 };
+      // verify
+      assertUnit(v.isInline());
+      assertUnit(v.size() == 3);
+      assertUnit(v[0] == 26);
+      assertUnit(v[1] == 49);
+      assertUnit(v[2] == 67);
+   }  // teardown
+
+   // copying an inline vector copies into our own inline storage
+   void test_construct_copyInline()
+   {  // setup
+      Vector4 vSrc{ 26, 49, 67 };
+      // exercise
+      Vector4 vDes(vSrc);
+      // verify
+      assertUnit(vDes.isInline());
+      assertUnit(vDes.data != vSrc.data);
+      assertUnit(vDes.size() == 3);
+      assertUnit(vDes[2] == 67);
+      assertUnit(vSrc.size() == 3);
+   }  // teardown
+
+   // moving an inline vector moves the elements one at a time
+   void test_construct_moveInline()
+   {  // setup
+      custom::small_vector<Spy, 4> vSrc;
+      vSrc.emplace_back(26);
+      vSrc.emplace_back(49);
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4> vDes(std::move(vSrc));
+      // verify
+      assertUnit(Spy::numCopyMove() == 2);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(vDes.isInline());
+      assertUnit(vDes.size() == 2);
+      assertUnit(vDes[0].get() == 26);
+      assertUnit(vDes[1].get() == 49);
+      assertUnit(vSrc.empty());
+   }  // teardown
+
+   // moving a vector on the heap steals its buffer
+   void test_construct_moveHeap()
+   {  // setup
+      Vector4 vSrc{ 1, 2, 3, 4, 5 };
+      int * pData = vSrc.data;
+      // exercise
+      Vector4 vDes(std::move(vSrc));
+      // verify
+      assertUnit(vDes.data == pData);
+      assertUnit(vDes.size() == 5);
+      assertUnit(vDes[4] == 5);
+      assertUnit(vSrc.isInline());
+      assertUnit(vSrc.empty());
+      assertUnit(vSrc.capacity() == 4);
+   }  // teardown
+
+   /***************************************
+    * ASSIGN
+    ***************************************/
+
+   // copying a big vector onto a small one spills it to the heap
+   void test_assign_heapToInline()
+   {  // setup
+      Vector4 vSrc{ 1, 2, 3, 4, 5, 6 };
+      Vector4 vDes{ 99 };
+      // exercise
+      vDes = vSrc;
+      // verify
+      assertUnit(!vDes.isInline());
+      assertUnit(vDes.size() == 6);
+      for (int i = 0; i < 6; i++)
+         assertUnit(vDes[i] == i + 1);
+   }  // teardown
+
+   // swapping an inline vector with one on the heap
+   void test_swap_inlineHeap()
+   {  // setup
+      Vector4 vLeft{ 26, 49 };
+      Vector4 vRight{ 1, 2, 3, 4, 5 };
+      // exercise
+      vLeft.swap(vRight);
+      // verify
+      assertUnit(!vLeft.isInline());
+      assertUnit(vLeft.size() == 5);
+      assertUnit(vLeft[4] == 5);
+      assertUnit(vRight.isInline());
+      assertUnit(vRight.size() == 2);
+      assertUnit(vRight[0] == 26);
+      assertUnit(vRight[1] == 49);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the first N elements never touch the heap
+   void test_pushback_inline()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      Vector4 v;
+      AllocTracker::reset();
+      // exercise
+      for (int i = 0; i < 4; i++)
+         v.push_back(i);
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 0);
+      assertUnit(v.isInline());
+      assertUnit(v.size() == 4);
+      assertUnit(v.back() == 3);
+   }  // teardown
+
+   // the N+1st element moves everything to a buffer twice the size
+   void test_pushback_spill()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      Vector4 v{ 0, 1, 2, 3 };
+      AllocTracker::reset();
+      // exercise
+      v.push_back(4);
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 1);
+      assertUnit(!v.isInline());
+      assertUnit(v.capacity() == 8);
+      assertUnit(v.size() == 5);
+      for (int i = 0; i < 5; i++)
+         assertUnit(v[i] == i);
+   }  // teardown
+
+   // pushing back one of our own elements survives the spill
+   void test_pushback_selfReference()
+   {  // setup
+      custom::small_vector<Spy, 2> v;
+      v.emplace_back(26);
+      v.emplace_back(49);
+      // exercise
+      v.push_back(v[0]);
+      // verify
+      assertUnit(v.size() == 3);
+      assertUnit(v[0].get() == 26);
+      assertUnit(v[1].get() == 49);
+      assertUnit(v[2].get() == 26);
+   }  // teardown
+
+   // emplace in the middle slides the rest back
+   void test_emplace_middle()
+   {  // setup
+      Vector4 v{ 26, 67, 89 };
+      // exercise
+      Vector4::iterator it = v.emplace(++v.begin(), 49);
+      // verify
+      assertUnit(*it == 49);
+      assertUnit(v.size() == 4);
+      assertUnit(v[0] == 26);
+      assertUnit(v[1] == 49);
+      assertUnit(v[2] == 67);
+      assertUnit(v[3] == 89);
+   }  // teardown
+
+   // resize grows with copies and shrinks from the back
+   void test_resize_growShrink()
+   {  // setup
+      Vector4 v{ 26 };
+      // exercise
+      v.resize(6, 99);
+      // verify
+      assertUnit(v.size() == 6);
+      assertUnit(v[0] == 26);
+      assertUnit(v[5] == 99);
+      // exercise
+      v.resize(2);
+      // verify
+      assertUnit(v.size() == 2);
+      assertUnit(v[1] == 99);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // clear destroys every element and keeps the storage
+   void test_clear_spy()
+   {  // setup
+      custom::small_vector<Spy, 4> v;
+      v.emplace_back(26);
+      v.emplace_back(49);
+      v.emplace_back(67);
+      Spy::reset();
+      // exercise
+      v.clear();
+      // verify
+      assertUnit(Spy::numDestructor() == 3);
+      assertUnit(v.empty());
+      assertUnit(v.isInline());
+   }  // teardown
+
+   // shrinking to N or fewer goes back inline and frees the heap buffer
+   void test_shrink_backInline()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      Vector4 v{ 1, 2, 3, 4, 5 };
+      v.pop_back();
+      v.pop_back();
+      AllocTracker::reset();
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numFree == 1);
+      assertUnit(v.isInline());
+      assertUnit(v.capacity() == 4);
+      assertUnit(v.size() == 3);
+      assertUnit(v[0] == 1);
+      assertUnit(v[2] == 3);
+   }  // teardown
+
+   /***************************************
+    * MEMORY
+    ***************************************/
+
+   // building and dropping short vectors costs no allocation at all
+   void test_memory_noHeap()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      AllocTracker::reset();
+      // exercise
+      for (int i = 0; i < 100; i++)
+      {
+         custom::small_vector<int> v;
+         for (int j = 0; j < 8; j++)
+            v.push_back(i + j);
+      }
+      // verify
+      assertUnit(AllocTracker::thread().numAlloc == 0);
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,258 @@
+/***********************************************************************
+ * Header:
+ *    TEST SOA VECTOR
+ * Summary:
+ *    Unit tests for the struct-of-arrays vector
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "soaVector.h"     // class under test
+#include "unitTest.h"      // unit test baseclass
+#include "allocTracker.h"  // to see how much the arrays take
+
+#include <string>          // for the seconds
+
+/***********************************************
+ * TEST SOA VECTOR
+ * Most tests use records of an int key and a string
+ * so the two arrays are easy to tell apart.
+ ***********************************************/
+class TestSoaVector : public UnitTest
+{
+   typedef custom::pair<int, std::string> Record;
+   typedef custom::soa_vector<Record> Records;
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      addTest(test_construct_default);
+      addTest(test_construct_initializerList);
+      addTest(test_construct_copy);
+
+      // Insert and remove
+      addTest(test_pushback_both);
+      addTest(test_popback_both);
+      addTest(test_resize_both);
+
+      // Access
+      addTest(test_reference_write);
+      addTest(test_reference_toPair);
+      addTest(test_iterator_walk);
+
+      // Spans
+      addTest(test_firsts_contiguous);
+      addTest(test_seconds_write);
+      addTest(test_spans_empty);
+
+      // Memory
+      addTest(test_memory_firstsOnly);
+
+      runTests();
+      report("SoaVector");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // both arrays start empty
+   void test_construct_default()
+   {  // setup
+      // exercise
+      Records v;
+      // verify
+      assertUnit(v.empty());
+      assertUnit(v.size() == 0);
+      assertUnit(v.firstsVec.size() == 0);
+      assertUnit(v.secondsVec.size() == 0);
+   }  // teardown
+
+   // each pair is split between the two arrays
+   void test_construct_initializerList()
+   {  // setup
+      // exercise
+      Records v{ Record(26, "Alpha"), Record(49, "Bravo") };
+      // verify
+      assertUnit(v.size() == 2);
+      assertUnit(v.firstsVec[0] == 26);
+      assertUnit(v.firstsVec[1] == 49);
+      assertUnit(v.secondsVec[0] == "Alpha");
+      assertUnit(v.secondsVec[1] == "Bravo");
+   }  // teardown
+
+   // a copy has its own arrays
+   void test_construct_copy()
+   {  // setup
+      Records vSrc{ Record(26, "Alpha") };
+      // exercise
+      Records vDes(vSrc);
+      vDes[0].first = 99;
+      // verify
+      assertUnit(vSrc[0].first == 26);
+      assertUnit(vDes[0].first == 99);
+      assertUnit(vDes[0].second == "Alpha");
+   }  // teardown
+
+   /***************************************
+    * INSERT AND REMOVE
+    ***************************************/
+
+   // push_back and emplace_back grow both arrays together
+   void test_pushback_both()
+   {  // setup
+      Records v;
+      // exercise
+      v.push_back(Record(26, "Alpha"));
+      v.emplace_back(49, std::string("Bravo"));
+      // verify
+      assertUnit(v.size() == 2);
+      assertUnit(v.firstsVec.size() == 2);
+      assertUnit(v.secondsVec.size() == 2);
+      assertUnit(v.back().first == 49);
+      assertUnit(v.back().second == "Bravo");
+   }  // teardown
+
+   // pop_back shrinks both arrays together
+   void test_popback_both()
+   {  // setup
+      Records v{ Record(26, "Alpha"), Record(49, "Bravo") };
+      // exercise
+      v.pop_back();
+      // verify
+      assertUnit(v.size() == 1);
+      assertUnit(v.secondsVec.size() == 1);
+      assertUnit(v.front().second == "Alpha");
+   }  // teardown
+
+   // resize fills both halves with defaults
+   void test_resize_both()
+   {  // setup
+      Records v{ Record(26, "Alpha") };
+      // exercise
+      v.resize(3);
+      // verify
+      assertUnit(v.size() == 3);
+      assertUnit(v[2].first == 0);
+      assertUnit(v[2].second.empty());
+      assertUnit(v[0].second == "Alpha");
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // assigning a pair through the reference writes both arrays
+   void test_reference_write()
+   {  // setup
+      Records v{ Record(26, "Alpha"), Record(49, "Bravo") };
+      // exercise
+      v[1] = Record(99, "Zulu");
+      v[0].second = "Echo";
+      // verify
+      assertUnit(v.firstsVec[1] == 99);
+      assertUnit(v.secondsVec[1] == "Zulu");
+      assertUnit(v.secondsVec[0] == "Echo");
+   }  // teardown
+
+   // a reference copies out to a real pair
+   void test_reference_toPair()
+   {  // setup
+      const Records v{ Record(26, "Alpha") };
+      // exercise
+      Record p = v[0];
+      // verify
+      assertUnit(p.first == 26);
+      assertUnit(p.second == "Alpha");
+   }  // teardown
+
+   // the iterator visits every record in order
+   void test_iterator_walk()
+   {  // setup
+      Records v{ Record(1, "A"), Record(2, "B"), Record(3, "C") };
+      int sum = 0;
+      std::string s;
+      // exercise
+      for (Records::iterator it = v.begin(); it != v.end(); ++it)
+      {
+         sum += (*it).first;
+         s += (*it).second;
+      }
+      // verify
+      assertUnit(sum == 6);
+      assertUnit(s == "ABC");
+   }  // teardown
+
+   /***************************************
+    * SPANS
+    ***************************************/
+
+   // the firsts are packed with nothing between them
+   void test_firsts_contiguous()
+   {  // setup
+      Records v{ Record(26, "Alpha"), Record(49, "Bravo"), Record(67, "Charlie") };
+      // exercise
+      custom::span<int> firsts = v.firsts();
+      // verify
+      assertUnit(firsts.size() == 3);
+      assertUnit(&firsts[1] == &firsts[0] + 1);
+      assertUnit(&firsts[2] == &firsts[0] + 2);
+      int sum = 0;
+      for (int i : firsts)
+         sum += i;
+      assertUnit(sum == 26 + 49 + 67);
+   }  // teardown
+
+   // writing through the seconds span changes the records
+   void test_seconds_write()
+   {  // setup
+      Records v{ Record(26, "Alpha"), Record(49, "Bravo") };
+      // exercise
+      for (std::string & s : v.seconds())
+         s += "!";
+      // verify
+      assertUnit(v[0].second == "Alpha!");
+      assertUnit(v[1].second == "Bravo!");
+   }  // teardown
+
+   // an empty vector has empty spans
+   void test_spans_empty()
+   {  // setup
+      Records v;
+      // exercise
+      custom::span<int> firsts = v.firsts();
+      custom::span<std::string> seconds = v.seconds();
+      // verify
+      assertUnit(firsts.empty());
+      assertUnit(seconds.empty());
+      assertUnit(firsts.begin() == firsts.end());
+   }  // teardown
+
+   /***************************************
+    * MEMORY
+    ***************************************/
+
+   // the firsts take sizeof(first) each, with no padding out to a pair
+   void test_memory_firstsOnly()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      custom::soa_vector<custom::pair<int, double>> v;
+      AllocTracker::reset();
+      // exercise
+      v.reserve(100);
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 2);
+      assertUnit(stats.bytesLive == (std::int64_t)(100 * (sizeof(int) + sizeof(double))));
+      assertUnit(stats.bytesLive < (std::int64_t)(100 * sizeof(custom::pair<int, double>)));
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -12,6 +12,7 @@
 
 #include "spy.h"        // class under test
 #include "unitTest.h"   // unit test baseclass
+#include <thread>       // for std::thread
 
 /***********************************************
  * TEST SPY
@@ -26,55 +27,64 @@ public:
       reset();
       
       // Constructor
-      test_constructorDefault();
-      test_constructorNondefault();
+      addTest(test_constructorDefault);
+      addTest(test_constructorNondefault);
       
       // Destructor
-      test_destructor_empty();
-      test_destructor_full();
+      addTest(test_destructor_empty);
+      addTest(test_destructor_full);
       
       // Copy Constructor
-      test_constructorCopy_empty();
-      test_constructorCopy_full();
+      addTest(test_constructorCopy_empty);
+      addTest(test_constructorCopy_full);
       
       // Move Constructor
-      test_constructorMove_empty();
-      test_constructorMove_full();
+      addTest(test_constructorMove_empty);
+      addTest(test_constructorMove_full);
       
       // Copy Assignment Operator
-      test_assignCopy_emptyToEmpty();
-      test_assignCopy_fullToEmpty();
-      test_assignCopy_emptyToFull();
-      test_assignCopy_fullToFull();
+      addTest(test_assignCopy_emptyToEmpty);
+      addTest(test_assignCopy_fullToEmpty);
+      addTest(test_assignCopy_emptyToFull);
+      addTest(test_assignCopy_fullToFull);
 
       // Assign Move
-      test_assignMove_emptyToEmpty();
-      test_assignMove_fullToEmpty();
-      test_assignMove_emptyToFull();
-      test_assignMove_fullToFull();
+      addTest(test_assignMove_emptyToEmpty);
+      addTest(test_assignMove_fullToEmpty);
+      addTest(test_assignMove_emptyToFull);
+      addTest(test_assignMove_fullToFull);
       
       // Equivalence
-      test_equivalence_emptyToEmpty();
-      test_equivalence_fullToEmpty();
-      test_equivalence_emptyToFull();
-      test_equivalence_same();
-      test_equivalence_firstSmaller();
-      test_equivalence_firstLarger();
+      addTest(test_equivalence_emptyToEmpty);
+      addTest(test_equivalence_fullToEmpty);
+      addTest(test_equivalence_emptyToFull);
+      addTest(test_equivalence_same);
+      addTest(test_equivalence_firstSmaller);
+      addTest(test_equivalence_firstLarger);
       
       // Less Than
-      test_lessthan_emptyToEmpty();
-      test_lessthan_fullToEmpty();
-      test_lessthan_emptyToFull();
-      test_lessthan_same();
-      test_lessthan_firstSmaller();
-      test_lessthan_firstLarger();
+      addTest(test_lessthan_emptyToEmpty);
+      addTest(test_lessthan_fullToEmpty);
+      addTest(test_lessthan_emptyToFull);
+      addTest(test_lessthan_same);
+      addTest(test_lessthan_firstSmaller);
+      addTest(test_lessthan_firstLarger);
   
       // Swap
-      test_swap_emptyToEmpty();
-      test_swap_fullToEmpty();
-      test_swap_emptyToFull();
-      test_swap_fullToFull();
+      addTest(test_swap_emptyToEmpty);
+      addTest(test_swap_fullToEmpty);
+      addTest(test_swap_emptyToFull);
+      addTest(test_swap_fullToFull);
+
+      // Hash
+      addTest(test_hash_empty);
+      addTest(test_hash_full);
+      addTest(test_hash_same);
+
+      // Counters
+      addTest(test_counters_otherThread);
       
+      runTests();
       report("Spy");
    }
    
@@ -772,6 +782,78 @@ public:
       assertUnit(2 == *(s1.p));
       assertUnit(1 == *(s2.p));
    }  // teardown
+
+   /***************************************
+    * HASH
+    *    std::hash<Spy>::operator()
+    ***************************************/
+
+   // hash an empty spy: zero, counted once
+   void test_hash_empty()
+   {  // setup
+      Spy s;
+      Spy::reset();
+      // exercise
+      std::size_t h = std::hash<Spy>()(s);
+      // verify
+      assertUnit(0 == h);
+      assertUnit(Spy::numHash() == 1);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(nullptr == s.p);
+   }  // teardown
+
+   // hash a full spy: the hash of the value, counted once
+   void test_hash_full()
+   {  // setup
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      std::size_t h = std::hash<Spy>()(s);
+      // verify
+      assertUnit(std::hash<int>()(99) == h);
+      assertUnit(Spy::numHash() == 1);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(99 == *(s.p));
+   }  // teardown
+
+   // two spies with the same value have the same hash
+   void test_hash_same()
+   {  // setup
+      Spy s1(99);
+      Spy s2(99);
+      Spy::reset();
+      // exercise
+      bool same = std::hash<Spy>()(s1) == std::hash<Spy>()(s2);
+      // verify
+      assertUnit(same);
+      assertUnit(Spy::numHash() == 2);
+      assertUnit(Spy::numEquals() == 0);
+   }  // teardown
+
+   /***************************************
+    * COUNTERS
+    *    Spy::total()
+    ***************************************/
+
+   // another thread's counts show in the total but not in ours
+   void test_counters_otherThread()
+   {  // setup
+      Spy::reset();
+      std::uint64_t totalBefore = Spy::total(NONDEFAULT);
+      // exercise
+      std::thread thread([]()
+      {
+         for (int i = 0; i < 5; i++)
+            Spy s(i);
+      });
+      thread.join();
+      // verify
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::total(NONDEFAULT) >= totalBefore + 5);
+   }  // teardown
 };
 
 #endif // DEBUG
@@ -0,0 +1,415 @@
+/***********************************************************************
+ * Header:
+ *    TEST UNROLLED LIST
+ * Summary:
+ *    Unit tests for the unrolled list
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "unrolledList.h"  // class under test
+#include "unitTest.h"      // unit test baseclass
+#include "allocTracker.h"  // to count the nodes
+#include "spy.h"           // to see what happens to the elements
+
+#include <string>          // for elements that can be moved from
+
+/***********************************************
+ * TEST UNROLLED LIST
+ * Unit tests for custom::unrolled_list. Most use four
+ * elements a node so the nodes are easy to see.
+ ***********************************************/
+class TestUnrolledList : public UnitTest
+{
+   typedef custom::unrolled_list<int, 4> List4;
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      addTest(test_construct_default);
+      addTest(test_construct_initializerList);
+      addTest(test_construct_copy);
+      addTest(test_construct_move);
+
+      // Push
+      addTest(test_pushback_fillNode);
+      addTest(test_pushback_newNode);
+      addTest(test_pushfront_room);
+      addTest(test_pushfront_newNode);
+
+      // Insert
+      addTest(test_insert_middle);
+      addTest(test_insert_split);
+      addTest(test_insert_end);
+      addTest(test_insert_aliasSplit);
+
+      // Erase
+      addTest(test_erase_middle);
+      addTest(test_erase_lastInNode);
+      addTest(test_erase_freeNode);
+      addTest(test_pop_both);
+
+      // Iterator
+      addTest(test_iterator_forward);
+      addTest(test_iterator_backward);
+
+      // Elements
+      addTest(test_spy_destructor);
+
+      // Memory
+      addTest(test_memory_nodes);
+
+      runTests();
+      report("UnrolledList");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // an empty list has no nodes
+   void test_construct_default()
+   {  // setup
+      // exercise
+      List4 l;
+      // verify
+      assertUnit(l.numElements == 0);
+      assertUnit(l.pHead == nullptr);
+      assertUnit(l.pTail == nullptr);
+      assertUnit(l.begin() == l.end());
+   }  // teardown
+
+   // six elements fill one node and half another
+   void test_construct_initializerList()
+   {  // setup
+      // exercise
+      List4 l{ 1, 2, 3, 4, 5, 6 };
+      // verify
+      assertStandardFixture(l);
+   }  // teardown
+
+   // a copy has its own nodes
+   void test_construct_copy()
+   {  // setup
+      List4 lSrc{ 1, 2, 3, 4, 5, 6 };
+      // exercise
+      List4 lDest(lSrc);
+      // verify
+      assertStandardFixture(lSrc);
+      assertStandardFixture(lDest);
+      assertUnit(lDest.pHead != lSrc.pHead);
+   }  // teardown
+
+   // a move takes the nodes
+   void test_construct_move()
+   {  // setup
+      List4 lSrc{ 1, 2, 3, 4, 5, 6 };
+      auto * pHead = lSrc.pHead;
+      // exercise
+      List4 lDest(std::move(lSrc));
+      // verify
+      assertUnit(lSrc.numElements == 0);
+      assertUnit(lSrc.pHead == nullptr);
+      assertUnit(lDest.pHead == pHead);
+      assertStandardFixture(lDest);
+   }  // teardown
+
+   /***************************************
+    * PUSH
+    ***************************************/
+
+   // four elements share one node
+   void test_pushback_fillNode()
+   {  // setup
+      List4 l;
+      // exercise
+      for (int i = 1; i <= 4; i++)
+         l.push_back(i);
+      // verify
+      assertUnit(l.pHead == l.pTail);
+      assertUnit(l.pHead->num == 4);
+      assertUnit(l.back() == 4);
+   }  // teardown
+
+   // the fifth element starts a new node
+   void test_pushback_newNode()
+   {  // setup
+      List4 l{ 1, 2, 3, 4 };
+      // exercise
+      l.push_back(5);
+      // verify
+      assertUnit(l.pHead != l.pTail);
+      assertUnit(l.pHead->pNext == l.pTail);
+      assertUnit(l.pTail->pPrev == l.pHead);
+      assertUnit(l.pTail->num == 1);
+      assertUnit(l.back() == 5);
+      assertUnit(l.size() == 5);
+   }  // teardown
+
+   // pushing on the front of a node with room slides the others back
+   void test_pushfront_room()
+   {  // setup
+      List4 l{ 2, 3 };
+      // exercise
+      l.push_front(1);
+      // verify
+      assertUnit(l.pHead == l.pTail);
+      assertUnit(l.pHead->num == 3);
+      assertUnit(*l.pHead->slot(0) == 1);
+      assertUnit(*l.pHead->slot(1) == 2);
+      assertUnit(*l.pHead->slot(2) == 3);
+   }  // teardown
+
+   // pushing on the front of a full node makes a new node in front
+   void test_pushfront_newNode()
+   {  // setup
+      List4 l{ 2, 3, 4, 5 };
+      auto * pOld = l.pHead;
+      // exercise
+      l.push_front(1);
+      // verify
+      assertUnit(l.pHead != pOld);
+      assertUnit(l.pHead->num == 1);
+      assertUnit(pOld->num == 4);
+      assertUnit(l.front() == 1);
+      assertUnit(l.size() == 5);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // inserting in a node with room slides the rest back
+   void test_insert_middle()
+   {  // setup
+      List4 l{ 1, 3, 4 };
+      auto it = l.begin();
+      ++it;
+      // exercise
+      it = l.insert(it, 2);
+      // verify
+      assertUnit(*it == 2);
+      assertUnit(l.pHead == l.pTail);
+      assertUnit(*l.pHead->slot(0) == 1);
+      assertUnit(*l.pHead->slot(1) == 2);
+      assertUnit(*l.pHead->slot(2) == 3);
+      assertUnit(*l.pHead->slot(3) == 4);
+   }  // teardown
+
+   // inserting in a full node splits it in half
+   void test_insert_split()
+   {  // setup
+      List4 l{ 1, 2, 4, 5 };
+      auto it = l.begin();
+      ++it;
+      ++it;
+      // exercise
+      it = l.insert(it, 3);
+      // verify
+      //    +---+---+   +---+---+---+
+      //    | 1 | 2 |   | 3 | 4 | 5 |
+      //    +---+---+   +---+---+---+
+      assertUnit(*it == 3);
+      assertUnit(l.pHead->num == 3);
+      assertUnit(l.pTail->num == 2);
+      assertUnit(l.size() == 5);
+      int expected = 1;
+      for (auto it2 = l.begin(); it2 != l.end(); ++it2)
+         assertUnit(*it2 == expected++);
+      assertUnit(expected == 6);
+   }  // teardown
+
+   // inserting at the end is a push_back
+   void test_insert_end()
+   {  // setup
+      List4 l{ 1, 2 };
+      // exercise
+      auto it = l.insert(l.end(), 3);
+      // verify
+      assertUnit(*it == 3);
+      assertUnit(l.back() == 3);
+      assertUnit(l.pHead->num == 3);
+   }  // teardown
+
+   // inserting an element of the same full node copies it before the split
+   void test_insert_aliasSplit()
+   {  // setup
+      custom::unrolled_list<std::string, 4> l{ "Alpha", "Bravo", "Charlie", "Delta" };
+      // exercise
+      auto it = l.insert(++l.begin(), l.back());
+      // verify
+      assertUnit(*it == "Delta");
+      assertUnit(l.size() == 5);
+      const char * expected[] = { "Alpha", "Delta", "Bravo", "Charlie", "Delta" };
+      std::size_t i = 0;
+      for (auto it2 = l.begin(); it2 != l.end(); ++it2)
+         assertUnit(*it2 == expected[i++]);
+      assertUnit(i == 5);
+   }  // teardown
+
+   /***************************************
+    * ERASE
+    ***************************************/
+
+   // erasing in the middle of a node slides the rest forward
+   void test_erase_middle()
+   {  // setup
+      List4 l{ 1, 2, 3, 4, 5, 6 };
+      auto it = l.begin();
+      ++it;
+      // exercise
+      it = l.erase(it);
+      // verify
+      assertUnit(*it == 3);
+      assertUnit(l.pHead->num == 3);
+      assertUnit(l.size() == 5);
+   }  // teardown
+
+   // erasing the last of a node returns the front of the next
+   void test_erase_lastInNode()
+   {  // setup
+      List4 l{ 1, 2, 3, 4, 5, 6 };
+      auto it = l.begin();
+      ++it;
+      ++it;
+      ++it;
+      // exercise
+      it = l.erase(it);
+      // verify
+      assertUnit(it.p == l.pTail);
+      assertUnit(*it == 5);
+      assertUnit(l.pHead->num == 3);
+   }  // teardown
+
+   // erasing the only element of a node frees the node
+   void test_erase_freeNode()
+   {  // setup
+      List4 l{ 1, 2, 3, 4, 5 };
+      auto it = l.rbegin();
+      // exercise
+      it = l.erase(it);
+      // verify
+      assertUnit(it == l.end());
+      assertUnit(l.pHead == l.pTail);
+      assertUnit(l.pTail->pNext == nullptr);
+      assertUnit(l.size() == 4);
+   }  // teardown
+
+   // popping from both ends until empty
+   void test_pop_both()
+   {  // setup
+      List4 l{ 1, 2, 3, 4, 5, 6 };
+      // exercise
+      l.pop_front();
+      l.pop_back();
+      l.pop_front();
+      l.pop_back();
+      // verify
+      assertUnit(l.size() == 2);
+      assertUnit(l.front() == 3);
+      assertUnit(l.back() == 4);
+      l.pop_back();
+      l.pop_back();
+      assertUnit(l.empty());
+      assertUnit(l.pHead == nullptr);
+      assertUnit(l.pTail == nullptr);
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // increment crosses from node to node
+   void test_iterator_forward()
+   {  // setup
+      List4 l{ 1, 2, 3, 4, 5, 6 };
+      int expected = 1;
+      // exercise
+      for (auto it = l.begin(); it != l.end(); it++)
+         assertUnit(*it == expected++);
+      // verify
+      assertUnit(expected == 7);
+   }  // teardown
+
+   // decrement crosses back from node to node
+   void test_iterator_backward()
+   {  // setup
+      List4 l{ 1, 2, 3, 4, 5, 6 };
+      int expected = 6;
+      // exercise
+      for (auto it = l.rbegin(); it != l.end(); it--)
+         assertUnit(*it == expected--);
+      // verify
+      assertUnit(expected == 0);
+   }  // teardown
+
+   /***************************************
+    * ELEMENTS
+    ***************************************/
+
+   // every element is destroyed exactly once
+   void test_spy_destructor()
+   {  // setup
+      {
+         custom::unrolled_list<Spy, 4> l;
+         for (int i = 0; i < 10; i++)
+            l.push_back(Spy(i));
+         l.erase(l.begin());
+         l.insert(l.begin(), Spy(99));
+         Spy::reset();
+      }  // exercise
+      // verify
+      assertUnit(Spy::numDestructor() == 10);
+   }  // teardown
+
+   /***************************************
+    * MEMORY
+    ***************************************/
+
+   // one allocation per K elements, not per element
+   void test_memory_nodes()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      custom::unrolled_list<int> l;
+      AllocTracker::reset();
+      // exercise
+      for (int i = 0; i < 160; i++)
+         l.push_back(i);
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 10);
+      assertUnit(l.size() == 160);
+   }  // teardown
+
+   /*************************************************************
+    * VERIFY STANDARD FIXTURE
+    *    +---+---+---+---+   +---+---+
+    *    | 1 | 2 | 3 | 4 |   | 5 | 6 |
+    *    +---+---+---+---+   +---+---+
+    *************************************************************/
+   void assertStandardFixtureParameters(const List4 & l, int line, const char * function)
+   {
+      assertIndirect(l.numElements == 6);
+      assertIndirect(l.pHead != nullptr);
+      assertIndirect(l.pTail != nullptr);
+      if (l.pHead == nullptr || l.pTail == nullptr)
+         return;
+      assertIndirect(l.pHead->pNext == l.pTail);
+      assertIndirect(l.pTail->pPrev == l.pHead);
+      assertIndirect(l.pHead->num == 4);
+      assertIndirect(l.pTail->num == 2);
+      for (int i = 0; i < 4; i++)
+         assertIndirect(*l.pHead->slot(i) == i + 1);
+      for (int i = 0; i < 2; i++)
+         assertIndirect(*l.pTail->slot(i) == i + 5);
+   }
+};
+
+#endif // DEBUG
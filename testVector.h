@@ -14,6 +14,9 @@
 #include <vector>
 #include "vector.h"
 #include "unitTest.h"
+#include "spy.h"
+#include "allocTracker.h"
+#include "arena.h"
 
 
 #include <cassert>
@@ -21,6 +24,46 @@
 
 #include <iostream>
 
+/***********************************************
+ * COUNTING ALLOCATOR
+ * A stateful allocator that follows the data on copy
+ * assignment. Each keeps a count of its live buffers
+ * so a test can see which one freed what.
+ ***********************************************/
+template <typename T>
+struct counting_allocator
+{
+   typedef T value_type;
+   typedef std::true_type propagate_on_container_copy_assignment;
+
+   counting_allocator(int & numLive) noexcept : pLive(&numLive) {}
+   template <class U>
+   counting_allocator(const counting_allocator<U> & rhs) noexcept : pLive(rhs.pLive) {}
+
+   T * allocate(std::size_t n)
+   {
+      (*pLive)++;
+      return std::allocator<T>().allocate(n);
+   }
+   void deallocate(T * p, std::size_t n) noexcept
+   {
+      (*pLive)--;
+      std::allocator<T>().deallocate(p, n);
+   }
+
+   int * pLive;   // the buffers this allocator has out
+};
+template <class T, class U>
+bool operator == (const counting_allocator<T> & lhs, const counting_allocator<U> & rhs) noexcept
+{
+   return lhs.pLive == rhs.pLive;
+}
+template <class T, class U>
+bool operator != (const counting_allocator<T> & lhs, const counting_allocator<U> & rhs) noexcept
+{
+   return !(lhs == rhs);
+}
+
 class TestVector : public UnitTest
 {
    
@@ -30,96 +73,123 @@ public:
       reset();
       
       // Construct
-      test_construct_default();
-      test_construct_sizeZero();
-      test_construct_sizeFour();
-      test_construct_sizeFourFill();
-      test_constructCopy_empty();
-      test_constructCopy_standard();
-      test_constructCopy_partiallyFilled();
-      test_constructMove_empty();
-      test_constructMove_standard();
-      test_constructMove_partiallyFilled();
-      test_constructInit_empty();
-      test_constructInit_standard();
-      test_destructor_empty();
-      test_destructor_standard();
-      test_destructor_partiallyFilled();
+      addTest(test_construct_default);
+      addTest(test_construct_sizeZero);
+      addTest(test_construct_sizeFour);
+      addTest(test_construct_sizeFourFill);
+      addTest(test_constructCopy_empty);
+      addTest(test_constructCopy_standard);
+      addTest(test_constructCopy_partiallyFilled);
+      addTest(test_constructMove_empty);
+      addTest(test_constructMove_standard);
+      addTest(test_constructMove_partiallyFilled);
+      addTest(test_constructInit_empty);
+      addTest(test_constructInit_standard);
+      addTest(test_destructor_empty);
+      addTest(test_destructor_standard);
+      addTest(test_destructor_partiallyFilled);
       
       // Assign
-      test_assign_empty();
-      test_assign_sameSize();
-      test_assign_rightBigger();
-      test_assign_leftBigger();
-      test_assignMove_empty();
-      test_assignMove_sameSize();
-      test_assignMove_rightBigger();
-      test_assignMove_leftBigger();
-      test_swap_empty();
-      test_swap_sameSize();
-      test_swap_rightBigger();
-      test_swap_leftBigger();
+      addTest(test_assign_empty);
+      addTest(test_assign_sameSize);
+      addTest(test_assign_rightBigger);
+      addTest(test_assign_leftBigger);
+      addTest(test_assignMove_empty);
+      addTest(test_assignMove_sameSize);
+      addTest(test_assignMove_rightBigger);
+      addTest(test_assignMove_leftBigger);
+      addTest(test_swap_empty);
+      addTest(test_swap_sameSize);
+      addTest(test_swap_rightBigger);
+      addTest(test_swap_leftBigger);
 
       // Iterator
-      test_iterator_beginEmpty();
-      test_iterator_beginFull();
-      test_iterator_endFull();
-      test_iterator_incrementFull();
-      test_iterator_dereferenceReadFull();
-      test_iterator_dereferenceUpdate();
-      test_iterator_construct_default();
-      test_iterator_construct_pointer();
-      test_iterator_construct_index();
+      addTest(test_iterator_beginEmpty);
+      addTest(test_iterator_beginFull);
+      addTest(test_iterator_endFull);
+      addTest(test_iterator_incrementFull);
+      addTest(test_iterator_dereferenceReadFull);
+      addTest(test_iterator_dereferenceUpdate);
+      addTest(test_iterator_construct_default);
+      addTest(test_iterator_construct_pointer);
+      addTest(test_iterator_construct_index);
 
       // Access
-      test_subscript_read();
-      test_subscript_write();
-      test_front_read();
-      test_front_write();
-      test_back_read();
-      test_back_write();
+      addTest(test_subscript_read);
+      addTest(test_subscript_write);
+      addTest(test_front_read);
+      addTest(test_front_write);
+      addTest(test_back_read);
+      addTest(test_back_write);
 
       // Insert
-      test_pushback_empty();
-      test_pushback_excessCapacity();
-      test_pushback_requireReallocate();
-      test_pushback_moveEmpty();
-      test_pushback_moveExcessCapacity();
-      test_pushback_moveRequireReallocate();
-      test_resize_emptyZero();
-      test_resize_emptyFourDefault();
-      test_resize_emptyFourValue();
-      test_resize_fourZero();
-      test_resize_fourSixDefault();
-      test_resize_fourSixValue();
-      test_reserve_emptyZero();
-      test_reserve_emptyTen();
-      test_reserve_fourZero();
-      test_reserve_fourFour();
-      test_reserve_fourTen();
-      test_reserve_standardZero();
-      test_reserve_standardTen();
+      addTest(test_pushback_empty);
+      addTest(test_pushback_excessCapacity);
+      addTest(test_pushback_requireReallocate);
+      addTest(test_pushback_moveEmpty);
+      addTest(test_pushback_moveExcessCapacity);
+      addTest(test_pushback_moveRequireReallocate);
+      addTest(test_emplaceBack_spy);
+      addTest(test_emplaceBack_requireReallocate);
+      addTest(test_emplace_standardMiddle);
+      addTest(test_resize_emptyZero);
+      addTest(test_resize_emptyFourDefault);
+      addTest(test_resize_emptyFourValue);
+      addTest(test_resize_fourZero);
+      addTest(test_resize_fourSixDefault);
+      addTest(test_resize_fourSixValue);
+      addTest(test_reserve_emptyZero);
+      addTest(test_reserve_emptyTen);
+      addTest(test_reserve_fourZero);
+      addTest(test_reserve_fourFour);
+      addTest(test_reserve_fourTen);
+      addTest(test_reserve_standardZero);
+      addTest(test_reserve_standardTen);
+      addTest(test_reserve_spyMoves);
+      addTest(test_resize_spyShrink);
+      addTest(test_pushback_selfReference);
 
       // Remove
-      test_popback_empty();
-      test_popback_full();
-      test_popback_partiallyFilled();
-      test_clear_empty();
-      test_clear_full();
-      test_clear_partiallyFilled();
-      test_shrink_empty();
-      test_shrink_toEmpty();
-      test_shrink_standard();
-      test_shrink_twoExtraSlots();
+      addTest(test_popback_empty);
+      addTest(test_popback_full);
+      addTest(test_popback_partiallyFilled);
+      addTest(test_clear_empty);
+      addTest(test_clear_full);
+      addTest(test_clear_partiallyFilled);
+      addTest(test_shrink_empty);
+      addTest(test_shrink_toEmpty);
+      addTest(test_shrink_standard);
+      addTest(test_shrink_twoExtraSlots);
 
       // Status
-      test_size_empty();
-      test_size_full();
-      test_empty_empty();
-      test_empty_full();
-      test_capacity_empty();
-      test_capacity_full();
+      addTest(test_size_empty);
+      addTest(test_size_full);
+      addTest(test_empty_empty);
+      addTest(test_empty_full);
+      addTest(test_capacity_empty);
+      addTest(test_capacity_full);
 
+      // Performance
+      addPerfTest(test_perf_pushback_amortized);
+      addPerfTest(test_perf_subscript_constant);
+
+      // Memory
+      addTest(test_memory_reserve);
+      addTest(test_memory_destructor);
+#ifdef __linux__
+      addTest(test_memory_mappedGrowth);
+      addTest(test_memory_mappedShrink);
+#endif // __linux__
+
+      // Allocator
+      addTest(test_allocator_arena);
+      addTest(test_allocator_copyPropagate);
+#ifdef __cpp_lib_memory_resource
+      addTest(test_allocator_pmr);
+      addTest(test_allocator_pmrMoveUnequal);
+#endif // __cpp_lib_memory_resource
+
+      runTests();
       report("Vector");
    }
    
@@ -260,7 +330,7 @@ public:
          //    | 26 | 49 |    |    |
          //    +----+----+----+----+
          custom::vector<int> v;
-         v.data = new int[4];
+         v.data = std::allocator<int>().allocate(4);
          v.data[0] = 99;
          v.data[1] = 99;
          v.numElements = 2;
@@ -319,7 +389,7 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[4];
+      vSrc.data = std::allocator<int>().allocate(4);
       vSrc.data[0] = 26;
       vSrc.data[1] = 49;
       vSrc.numElements = 2;
@@ -403,7 +473,7 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[4];\
+      vSrc.data = std::allocator<int>().allocate(4);\
       vSrc.data[0] = 26;
       vSrc.data[1] = 49;
       vSrc.numElements = 2;
@@ -626,7 +696,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = std::allocator<int>().allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -650,7 +720,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = std::allocator<int>().allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -674,7 +744,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = std::allocator<int>().allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -734,6 +804,61 @@ public:
       // teardown
       teardownStandardFixture(v);
    }
+
+   // growing moves each element once and builds nothing in the spare slots
+   void test_reserve_spyMoves()
+   {  // setup
+      custom::vector<Spy> v;
+      v.reserve(4);
+      v.emplace_back(26);
+      v.emplace_back(49);
+      v.emplace_back(67);
+      v.emplace_back(89);
+      Spy::reset();
+      // exercise
+      v.reserve(100);
+      // verify
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 4);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numDestructor() == 4);
+      assertUnit(v.numCapacity == 100);
+      assertUnit(v.numElements == 4);
+      assertUnit(v.data[0].get() == 26);
+      assertUnit(v.data[3].get() == 89);
+   }  // teardown
+
+   // shrinking with resize destroys the elements that are dropped
+   void test_resize_spyShrink()
+   {  // setup
+      custom::vector<Spy> v(4);
+      Spy::reset();
+      // exercise
+      v.resize(1);
+      // verify
+      assertUnit(Spy::numDestructor() == 3);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(v.numElements == 1);
+      assertUnit(v.numCapacity == 4);
+   }  // teardown
+
+   // pushing back one of our own elements survives the buffer moving
+   void test_pushback_selfReference()
+   {  // setup
+      custom::vector<Spy> v;
+      v.emplace_back(26);
+      v.emplace_back(49);
+      assertUnit(v.numCapacity == 2);
+      // exercise
+      v.push_back(v[0]);
+      // verify
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 3);
+      assertUnit(v.data[0].get() == 26);
+      assertUnit(v.data[1].get() == 49);
+      assertUnit(v.data[2].get() == 26);
+   }  // teardown
    
    // shrink an empty fixture
    void test_shrink_empty()
@@ -753,7 +878,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = std::allocator<int>().allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -787,7 +912,7 @@ public:
       //    | 26 | 49 | 67 | 89 |    |    |
       //    +----+----+----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[6];
+      v.data = std::allocator<int>().allocate(6);
       v.data[0] = 26;
       v.data[1] = 49;
       v.data[2] = 67;
@@ -966,7 +1091,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vDest;
-      vDest.data = new int[2];
+      vDest.data = std::allocator<int>().allocate(2);
       vDest.data[0] = 99;
       vDest.data[1] = 99;
       vDest.numElements = 2;
@@ -998,7 +1123,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[2];
+      vSrc.data = std::allocator<int>().allocate(2);
       vSrc.data[0] = 99;
       vSrc.data[1] = 99;
       vSrc.numElements = 2;
@@ -1105,7 +1230,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vDest;
-      vDest.data = new int[2];
+      vDest.data = std::allocator<int>().allocate(2);
       vDest.data[0] = 99;
       vDest.data[1] = 99;
       vDest.numElements = 2;
@@ -1134,7 +1259,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[2];
+      vSrc.data = std::allocator<int>().allocate(2);
       vSrc.data[0] = 99;
       vSrc.data[1] = 99;
       vSrc.numElements = 2;
@@ -1245,7 +1370,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vDest;
-      vDest.data = new int[2];
+      vDest.data = std::allocator<int>().allocate(2);
       vDest.data[0] = 99;
       vDest.data[1] = 99;
       vDest.numElements = 2;
@@ -1284,7 +1409,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[2];
+      vSrc.data = std::allocator<int>().allocate(2);
       vSrc.data[0] = 99;
       vSrc.data[1] = 99;
       vSrc.numElements = 2;
@@ -1525,7 +1650,7 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = std::allocator<int>().allocate(4);
       v.data[0] = 26;
       v.data[1] = 49;
       v.numElements = 2;
@@ -1592,7 +1717,7 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = std::allocator<int>().allocate(4);
       v.data[0] = 26;
       v.data[1] = 49;
       v.numElements = 2;
@@ -1650,7 +1775,7 @@ public:
       //    | 26 | 49 | 67 |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = std::allocator<int>().allocate(4);
       v.data[0] = 26;
       v.data[1] = 49;
       v.data[2] = 67;
@@ -1680,7 +1805,7 @@ public:
       //    | 26 | 49 | 67 |
       //    +----+----+----+
       custom::vector<int> v;
-      v.data = new int[3];
+      v.data = std::allocator<int>().allocate(3);
       v.data[0] = 26;
       v.data[1] = 49;
       v.data[2] = 67;
@@ -1749,7 +1874,7 @@ public:
       //    | 26 | 49 | 67 |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = std::allocator<int>().allocate(4);
       
       v.data[0] = 26;
       v.data[1] = 49;
@@ -1782,7 +1907,7 @@ public:
       //    | 26 | 49 | 67 |
       //    +----+----+----+
       custom::vector<int> v;
-      v.data = new int[3];
+      v.data = std::allocator<int>().allocate(3);
       
       v.data[0] = 26;
       v.data[1] = 49;
@@ -1815,6 +1940,84 @@ public:
       // teardown
       teardownStandardFixture(v);
    }
+
+   /***************************************
+    * EMPLACE
+    ***************************************/
+
+   // emplace_back builds the Spy once, in its slot
+   void test_emplaceBack_spy()
+   {  // setup
+      custom::vector<Spy> v;
+      v.reserve(4);
+      Spy::reset();
+      // exercise
+      Spy & s = v.emplace_back(99);
+      // verify
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(&s == v.data);
+      assertUnit(s.get() == 99);
+      assertUnit(v.numElements == 1);
+   }  // teardown
+
+   // emplace_back grows the buffer when it is full
+   void test_emplaceBack_requireReallocate()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      // exercise
+      v.emplace_back(99);
+      // verify
+      //      0    1    2    3    4    5    6    7
+      //    +----+----+----+----+----+----+----+----+
+      //    | 26 | 49 | 67 | 89 | 99 |    |    |    |
+      //    +----+----+----+----+----+----+----+----+
+      assertUnit(v.numCapacity == 8);
+      assertUnit(v.numElements == 5);
+      assertUnit(v.data[0] == 26);
+      assertUnit(v.data[3] == 89);
+      assertUnit(v.data[4] == 99);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // emplace in the middle slides the rest back
+   void test_emplace_standardMiddle()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      //           it
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      custom::vector<int>::iterator it(v.data + 1);
+      // exercise
+      it = v.emplace(it, 99);
+      // verify
+      //      0    1    2    3    4
+      //    +----+----+----+----+----+
+      //    | 26 | 99 | 49 | 67 | 89 |
+      //    +----+----+----+----+----+
+      assertUnit(*it == 99);
+      assertUnit(v.numElements == 5);
+      assertUnit(v.data[0] == 26);
+      assertUnit(v.data[1] == 99);
+      assertUnit(v.data[2] == 49);
+      assertUnit(v.data[3] == 67);
+      assertUnit(v.data[4] == 89);
+      // teardown
+      teardownStandardFixture(v);
+   }
    
    
    /***************************************
@@ -2009,6 +2212,211 @@ public:
       teardownStandardFixture(v);
    }
 
+
+   /***************************************
+    * PERFORMANCE
+    ***************************************/
+
+   // push_back copies the Spy once, growth only moves the others.
+   // Copying all 100000 on every call would blow the median.
+   void test_perf_pushback_amortized()
+   {  // setup
+      custom::vector<Spy> v;
+      for (int i = 0; i < 100000; i++)
+         v.push_back(Spy(i));
+      Spy s(99);
+      Spy::reset();
+      auto pushback = [&]() { v.push_back(s); };
+      // exercise and verify
+      assertPerf(pushback, PerfBudget(5000.0 /*ns*/, 1 /*alloc*/, 0 /*compare*/));
+      assertUnit(v.size() == 100000 + 101);
+   }  // teardown
+
+   // the subscript operator does no work beyond the access, however
+   // many elements there are
+   void test_perf_subscript_constant()
+   {  // setup
+      custom::vector<int> v(100000);
+      size_t index = 0;
+      auto subscript = [&]() { v[index] = 99; index = (index + 7) % 100000; };
+      // exercise and verify
+      assertPerf(subscript, PerfBudget(2000.0 /*ns*/, 0 /*alloc*/, 0 /*compare*/));
+      assertUnit(v.size() == 100000);
+   }  // teardown
+
+   /***************************************
+    * MEMORY
+    ***************************************/
+
+   // reserve allocates one buffer of exactly the capacity
+   void test_memory_reserve()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      custom::vector<int> v;
+      AllocTracker::reset();
+      // exercise
+      v.reserve(10);
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 1);
+      assertUnit(stats.bytesLive == 10 * sizeof(int));
+   }  // teardown
+
+   // the destructor gives back the buffer
+   void test_memory_destructor()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      AllocTracker::reset();
+      {
+         custom::vector<int> v(100);
+      }  // exercise
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 1);
+      assertUnit(stats.numFree == 1);
+      assertUnit(stats.bytesLive == 0);
+      assertUnit(stats.bytesPeak == 100 * sizeof(int));
+   }  // teardown
+
+#ifdef __linux__
+   // a big vector of int grows by remapping pages, never through operator new
+   void test_memory_mappedGrowth()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      custom::vector<int> v;
+      v.reserve(1 << 18);   // exactly 1 MiB
+      for (int i = 0; i < (1 << 18); i++)
+         v.push_back(i);
+      AllocTracker::reset();
+      // exercise
+      for (int i = (1 << 18); i < (1 << 20); i++)
+         v.push_back(i);
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 0);
+      assertUnit(v.numCapacity == (1 << 20));
+      assertUnit(v.numElements == (1 << 20));
+      assertUnit(v.data[0] == 0);
+      assertUnit(v.data[(1 << 18) - 1] == (1 << 18) - 1);
+      assertUnit(v.data[(1 << 20) - 1] == (1 << 20) - 1);
+   }  // teardown
+
+   // shrinking a mapped buffer below the threshold keeps every element
+   void test_memory_mappedShrink()
+   {  // setup
+      custom::vector<int> v;
+      v.reserve(1 << 20);
+      for (int i = 0; i < 100; i++)
+         v.push_back(i);
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      assertUnit(v.numCapacity == 100);
+      assertUnit(v.numElements == 100);
+      assertUnit(v.data[0] == 0);
+      assertUnit(v.data[99] == 99);
+   }  // teardown
+#endif // __linux__
+
+   /***************************************
+    * ALLOCATOR
+    ***************************************/
+
+   // growing a vector in an arena on the stack never reaches operator new
+   void test_allocator_arena()
+   {  // setup
+      if (!AllocTracker::enabled())
+         return;
+      alignas(16) char buffer[1024];
+      custom::arena a(buffer, sizeof(buffer));
+      AllocTracker::reset();
+      // exercise
+      size_t size;
+      int back;
+      {
+         custom::vector<int, custom::arena_allocator<int>> v{ custom::arena_allocator<int>(a) };
+         for (int i = 0; i < 20; i++)
+            v.push_back(i);
+         size = v.size();
+         back = v.back();
+      }
+      // verify
+      AllocStats stats = AllocTracker::thread();
+      assertUnit(stats.numAlloc == 0);
+      assertUnit(size == 20);
+      assertUnit(back == 19);
+      assertUnit(a.used() >= 20 * sizeof(int));
+   }  // teardown
+
+#ifdef __cpp_lib_memory_resource
+   // a pmr vector takes its buffer from the memory resource
+   void test_allocator_pmr()
+   {  // setup
+      alignas(16) char buffer[1024];
+      std::pmr::monotonic_buffer_resource resource(buffer, sizeof(buffer),
+                                                   std::pmr::null_memory_resource());
+      custom::pmr::vector<int> v(&resource);
+      // exercise
+      v.push_back(26);
+      v.push_back(49);
+      v.push_back(67);
+      // verify
+      assertUnit(v.size() == 3);
+      assertUnit(v.data >= (int *)buffer && v.data < (int *)(buffer + sizeof(buffer)));
+      assertUnit(v.get_allocator().resource() == &resource);
+      assertUnit(v[0] == 26);
+      assertUnit(v[2] == 67);
+   }  // teardown
+
+   // copy assignment takes rhs's allocator, freeing the old buffer with the old one
+   void test_allocator_copyPropagate()
+   {  // setup
+      int numLiveSrc = 0;
+      int numLiveDest = 0;
+      {
+         custom::vector<int, counting_allocator<int>> vSrc{ counting_allocator<int>(numLiveSrc) };
+         custom::vector<int, counting_allocator<int>> vDest{ counting_allocator<int>(numLiveDest) };
+         vSrc.push_back(26);
+         vSrc.push_back(49);
+         for (int i = 0; i < 10; i++)
+            vDest.push_back(99);
+         // exercise
+         vDest = vSrc;
+         // verify
+         assertUnit(vDest.size() == 2);
+         assertUnit(vDest[0] == 26);
+         assertUnit(vDest[1] == 49);
+         assertUnit(vDest.get_allocator() == vSrc.get_allocator());
+         assertUnit(numLiveDest == 0);
+         assertUnit(numLiveSrc == 2);
+      }
+      assertUnit(numLiveSrc == 0);
+   }  // teardown
+
+   // moving between resources moves the elements, not the buffer
+   void test_allocator_pmrMoveUnequal()
+   {  // setup
+      std::pmr::unsynchronized_pool_resource resource1;
+      std::pmr::unsynchronized_pool_resource resource2;
+      custom::pmr::vector<int> vSrc(&resource1);
+      custom::pmr::vector<int> vDest(&resource2);
+      vSrc.push_back(26);
+      vSrc.push_back(49);
+      int * pSrc = vSrc.data;
+      // exercise
+      vDest = std::move(vSrc);
+      // verify
+      assertUnit(vDest.size() == 2);
+      assertUnit(vDest.data != pSrc);
+      assertUnit(vDest[0] == 26);
+      assertUnit(vDest[1] == 49);
+      assertUnit(vDest.get_allocator().resource() == &resource2);
+      assertUnit(vSrc.size() == 0);
+   }  // teardown
+#endif // __cpp_lib_memory_resource
    
    /*************************************************************
     * SETUP STANDARD FIXTURE
@@ -2022,7 +2430,7 @@ public:
       
       try
       {
-         v.data = new int[4];
+         v.data = std::allocator<int>().allocate(4);
          v.data[0] = 26;
          v.data[1] = 49;
          v.data[2] = 67;
@@ -15,6 +15,9 @@
 #undef assertComplexFixture
 #undef assertStandardFixture
 #undef assertEmptyFixture
+#undef assertPerf
+#undef addTest
+#undef addPerfTest
 
 
 #define assertUnit(condition)     assertUnitParameters(condition, #condition, __LINE__, __FUNCTION__)
@@ -22,11 +25,56 @@
 #define assertComplexFixture(x)   assertComplexFixtureParameters( x, __LINE__, __FUNCTION__)
 #define assertStandardFixture(x)  assertStandardFixtureParameters(x, __LINE__, __FUNCTION__)
 #define assertEmptyFixture(x)     assertEmptyFixtureParameters(   x, __LINE__, __FUNCTION__)
+#define assertPerf(x, budget)     assertPerfParameters(x, budget, #x, __LINE__, __FUNCTION__)
+#define addTest(x)                addTestParameters([this]() { x(); }, #x)
+#define addPerfTest(x)            addTestParameters([this]() { x(); }, #x, true)
+
+// number of threads running the test cases; zero means one per core
+#ifndef UNIT_TEST_THREADS
+#define UNIT_TEST_THREADS 0
+#endif
 
 #include <iostream>  // for std::cerr
 #include <string>    // for std::string
 #include <vector>    // for std::vector
 #include <map>       // for std::map
+#include <chrono>    // for std::chrono::steady_clock
+#include <algorithm> // for std::sort
+#include <fstream>   // for the performance baseline file
+#include <functional>// for std::function
+#include <thread>    // for std::thread
+#include <mutex>     // for std::mutex
+#include <atomic>    // for std::atomic
+#include "spy.h"     // for the allocation and comparison counters
+#include "perfCounters.h" // for the hardware cache miss counters
+
+/*************************************************************
+ * PERF BUDGET
+ * The limits a performance assertion must stay within. The
+ * time is the median of all the runs; the Spy counts are the
+ * worst single run; the cache misses are the average run. A
+ * negative limit is not checked, and neither are cache misses
+ * when the hardware counters are not available.
+ *************************************************************/
+struct PerfBudget
+{
+   PerfBudget(double nanoseconds,
+              long long allocations = -1,
+              long long comparisons = -1,
+              double cacheMisses = -1.0,
+              int iterations = 101,
+              double tolerance = 0.25) :
+      nanoseconds(nanoseconds), allocations(allocations),
+      comparisons(comparisons), cacheMisses(cacheMisses),
+      iterations(iterations), tolerance(tolerance) {}
+
+   double    nanoseconds;   // median wall-clock time of one call
+   long long allocations;   // Spy::numAlloc() of one call
+   long long comparisons;   // Spy::numEquals() + Spy::numLessthan() of one call
+   double    cacheMisses;   // L1 data cache misses of one call
+   int       iterations;    // how many times to call the lambda
+   double    tolerance;     // allowed regression against the stored baseline
+};
 
 
 class UnitTest
@@ -42,9 +90,26 @@ private:
       int         lineNumber;
    };
 
+   // a test case waiting to be run by runTests()
+   struct TestCase
+   {
+      std::function<void()> test;
+      std::string           name;
+      bool                  alone;   // a timed case runs with no others
+   };
+
    // each test has a name (the key) and the list of failures(value).
    std::map<std::string, std::vector<Failure>> tests;
 
+   // how long each test case took in milliseconds
+   std::map<std::string, double> timings;
+
+   // the test cases added but not yet run
+   std::vector<TestCase> cases;
+
+   // the test cases report from many threads at once
+   std::mutex mutexTests;
+
 protected:
    /*************************************************************
     * RESET
@@ -53,6 +118,79 @@ protected:
    void reset()
    {
       tests.clear();
+      timings.clear();
+      cases.clear();
+   }
+
+   /*************************************************************
+    * ADD TEST PARAMETERS
+    * Queue up a test case to be run by runTests(). A case that
+    * checks wall-clock time is added with alone set, through
+    * addPerfTest, so it is not measured while every core is busy.
+    *************************************************************/
+   void addTestParameters(std::function<void()> test, const char * name,
+                          bool alone = false)
+   {
+      cases.push_back(TestCase{test, std::string(name), alone});
+   }
+
+   /*************************************************************
+    * RUN TESTS
+    * Run all the queued test cases across a pool of threads. Each
+    * thread has its own Spy counters so the test cases do not
+    * disturb each other. The cases added with addPerfTest wait
+    * until the pool is done and then run one at a time.
+    *************************************************************/
+   void runTests()
+   {
+      size_t numThreads = UNIT_TEST_THREADS ? UNIT_TEST_THREADS :
+                          std::thread::hardware_concurrency();
+      numThreads = std::max(size_t(1), std::min(numThreads, cases.size()));
+      std::atomic<size_t> next(0);
+
+      // run one case, recording its time and whether it threw
+      auto runCase = [&](size_t i)
+      {
+         auto begin = std::chrono::steady_clock::now();
+         bool thrown = false;
+         try
+         {
+            cases[i].test();
+         }
+         catch (...)
+         {
+            thrown = true;
+         }
+         auto end = std::chrono::steady_clock::now();
+
+         std::lock_guard<std::mutex> lock(mutexTests);
+         timings[cases[i].name] =
+            std::chrono::duration<double, std::milli>(end - begin).count();
+         if (thrown)
+            tests[cases[i].name].push_back(Failure{"uncaught exception", 0});
+      };
+
+      // each worker takes the next test case until there are none left
+      auto worker = [&]()
+      {
+         for (size_t i = next++; i < cases.size(); i = next++)
+            if (!cases[i].alone)
+               runCase(i);
+      };
+
+      std::vector<std::thread> threads;
+      for (size_t i = 1; i < numThreads; i++)
+         threads.push_back(std::thread(worker));
+      worker();
+      for (auto & thread : threads)
+         thread.join();
+
+      // then the timed cases, with the other cores idle
+      for (size_t i = 0; i < cases.size(); i++)
+         if (cases[i].alone)
+            runCase(i);
+
+      cases.clear();
    }
    
    /*************************************************************
@@ -95,6 +233,18 @@ protected:
          << " tests run for a success rate of: "
          << (successRate * 100.0) << "%\n";
 
+      // display the slowest test cases
+      std::vector<std::pair<double, std::string>> slowest;
+      for (auto & timing : timings)
+         slowest.push_back(std::make_pair(timing.second, timing.first));
+      std::sort(slowest.rbegin(), slowest.rend());
+      if (slowest.size() > 3)
+         slowest.resize(3);
+      std::cerr.precision(2);
+      for (auto & timing : slowest)
+         std::cerr << "\tslow: " << timing.second << "() "
+                   << timing.first << "ms\n";
+
    }
    
    /*************************************************************
@@ -105,6 +255,7 @@ protected:
                              int line, const char* func)
    {
       std::string sFunc(func);
+      std::lock_guard<std::mutex> lock(mutexTests);
 
       if (!condition)
       {
@@ -130,6 +281,7 @@ protected:
                                      int lineCheck, const char* funcCheck)
    {
       std::string sFunc(funcOriginal);
+      std::lock_guard<std::mutex> lock(mutexTests);
       
       if (!condition)
       {
@@ -143,6 +295,137 @@ protected:
          tests[sFunc];
       }
    }
+
+   /*************************************************************
+    * ASSERT PERF PARAMETERS
+    * Call the lambda budget.iterations times and fail the test when
+    * the median time, the allocations, the comparisons, or the cache
+    * misses exceed the budget. When PERF_BASELINE names a file, the
+    * median time is also checked against the time stored there, and
+    * new measurements are appended to it. The median is returned so
+    * a test can compare two measurements.
+    *************************************************************/
+   template <class F>
+   double assertPerfParameters(F && f, const PerfBudget & budget,
+                               const char* lambdaString,
+                               int line, const char* func)
+   {
+      std::string sFunc(func);
+      std::vector<double> times;
+      long long allocations = 0;
+      long long comparisons = 0;
+      std::uint64_t hardware[custom::perf_counters::NUM_EVENTS] = {};
+      custom::perf_counters counters;
+
+      // run the lambda, recording each call separately
+      for (int i = 0; i < budget.iterations; i++)
+      {
+         long long numAlloc = Spy::numAlloc();
+         long long numCompare = Spy::numEquals() + Spy::numLessthan();
+         counters.start();
+         auto begin = std::chrono::steady_clock::now();
+         f();
+         auto end = std::chrono::steady_clock::now();
+         counters.stop();
+         for (int e = 0; e < custom::perf_counters::NUM_EVENTS; e++)
+            hardware[e] += counters.get(custom::perf_counters::event(e));
+         times.push_back(std::chrono::duration<double, std::nano>(end - begin).count());
+         allocations = std::max(allocations, (long long)Spy::numAlloc() - numAlloc);
+         comparisons = std::max(comparisons,
+                                (long long)(Spy::numEquals() + Spy::numLessthan()) - numCompare);
+      }
+      std::sort(times.begin(), times.end());
+      double median = times.empty() ? 0.0 : times[times.size() / 2];
+
+      // this ensures there is a placeholder for the successful test
+      std::lock_guard<std::mutex> lock(mutexTests);
+      std::vector<Failure> & failures = tests[sFunc];
+      std::string name(lambdaString);
+
+      if (median > budget.nanoseconds)
+         failures.push_back(Failure{name + " median " + std::to_string((long)median) +
+                                    "ns exceeds the budget of " +
+                                    std::to_string((long)budget.nanoseconds) + "ns" +
+                                    perfSummary(counters, hardware, budget.iterations), line});
+      if (budget.allocations >= 0 && allocations > budget.allocations)
+         failures.push_back(Failure{name + " made " + std::to_string(allocations) +
+                                    " allocations, budget is " +
+                                    std::to_string(budget.allocations), line});
+      if (budget.comparisons >= 0 && comparisons > budget.comparisons)
+         failures.push_back(Failure{name + " made " + std::to_string(comparisons) +
+                                    " comparisons, budget is " +
+                                    std::to_string(budget.comparisons), line});
+      double cacheMisses = budget.iterations <= 0 ? 0.0 :
+         (double)hardware[custom::perf_counters::L1D_MISSES] / budget.iterations;
+      if (budget.cacheMisses >= 0.0 &&
+          counters.available(custom::perf_counters::L1D_MISSES) &&
+          cacheMisses > budget.cacheMisses)
+         failures.push_back(Failure{name + " averaged " + std::to_string(cacheMisses) +
+                                    " L1 misses, budget is " +
+                                    std::to_string(budget.cacheMisses) +
+                                    perfSummary(counters, hardware, budget.iterations), line});
+
+#ifdef PERF_BASELINE
+      // compare against the last recorded median, or record this one
+      std::string key = sFunc + ":" + name;
+      std::map<std::string, double> & baseline = perfBaseline();
+      auto it = baseline.find(key);
+      if (it == baseline.end())
+      {
+         baseline[key] = median;
+         std::ofstream fout(PERF_BASELINE, std::ios::app);
+         fout << median << ' ' << key << '\n';
+      }
+      else if (median > it->second * (1.0 + budget.tolerance))
+         failures.push_back(Failure{name + " median " + std::to_string((long)median) +
+                                    "ns regressed from the baseline of " +
+                                    std::to_string((long)it->second) + "ns", line});
+#endif // PERF_BASELINE
+      return median;
+   }
+
+private:
+   /*************************************************************
+    * PERF SUMMARY
+    * Every available hardware counter per call, for a failure message
+    *************************************************************/
+   static std::string perfSummary(const custom::perf_counters & counters,
+                                  const std::uint64_t * hardware, int iterations)
+   {
+      if (!counters.available() || iterations <= 0)
+         return std::string();
+      std::string summary(" (per call:");
+      for (int e = 0; e < custom::perf_counters::NUM_EVENTS; e++)
+         if (counters.available(custom::perf_counters::event(e)))
+            summary += std::string(" ") +
+                       custom::perf_counters::name(custom::perf_counters::event(e)) +
+                       "=" + std::to_string(hardware[e] / (std::uint64_t)iterations);
+      return summary + ")";
+   }
+
+#ifdef PERF_BASELINE
+   /*************************************************************
+    * PERF BASELINE
+    * The stored medians, read from PERF_BASELINE the first time.
+    * Each line is the median then the key; the key is the rest of
+    * the line because the lambda in it may contain spaces.
+    *************************************************************/
+   static std::map<std::string, double> & perfBaseline()
+   {
+      static std::map<std::string, double> baseline;
+      static bool loaded = false;
+      if (!loaded)
+      {
+         std::ifstream fin(PERF_BASELINE);
+         std::string key;
+         double median;
+         while (fin >> median && std::getline(fin >> std::ws, key))
+            baseline[key] = median;
+         loaded = true;
+      }
+      return baseline;
+   }
+#endif // PERF_BASELINE
 };
 
 #endif // DEBUG
@@ -0,0 +1,455 @@
+/***********************************************************************
+ * Header:
+ *    UNROLLED LIST
+ * Summary:
+ *    A linked list where each node holds up to K elements side by side.
+ *    Walking custom::list costs one dependent load, and usually one
+ *    cache miss, per element. Here it is one per K elements, and
+ *    within a node the elements are contiguous, so the prefetcher can
+ *    help.
+ *
+ *    This will contain the class definition of:
+ *        unrolled_list           : A list of arrays of up to K elements
+ *        unrolled_list::iterator : An iterator through it
+ *
+ *    The interface is that of custom::list. Inserting into a full node
+ *    splits it in half. A node left empty by an erase is freed.
+ * Author
+ *    Br. Helfrich
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>     // for assert
+#include <cstddef>     // for std::size_t
+#include <memory>      // for std::allocator
+#include <new>         // for placement new
+#include <utility>     // for std::move
+
+class TestUnrolledList;   // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * UNROLLED LIST
+ * Just like custom::list but with K elements per node.
+ * The nodes come from the allocator A, rebound to the
+ * node type.
+ **************************************************/
+template <typename T, std::size_t K = 16, typename A = std::allocator<T>>
+class unrolled_list
+{
+   friend class ::TestUnrolledList; // give unit tests access to the privates
+   static_assert(K >= 2, "a node must be able to split");
+public:
+   //
+   // Construct
+   //
+
+   unrolled_list() : numElements(0), pHead(nullptr), pTail(nullptr) {}
+   explicit unrolled_list(const A & a) :
+      numElements(0), pHead(nullptr), pTail(nullptr), nodeAlloc(a) {}
+   unrolled_list(const unrolled_list & rhs) :
+      numElements(0), pHead(nullptr), pTail(nullptr),
+      nodeAlloc(NodeTraits::select_on_container_copy_construction(rhs.nodeAlloc))
+   {
+      *this = rhs;
+   }
+   unrolled_list(unrolled_list && rhs) :
+      numElements(rhs.numElements), pHead(rhs.pHead), pTail(rhs.pTail),
+      nodeAlloc(std::move(rhs.nodeAlloc))
+   {
+      rhs.numElements = 0;
+      rhs.pHead = rhs.pTail = nullptr;
+   }
+   unrolled_list(const std::initializer_list<T> & il) :
+      numElements(0), pHead(nullptr), pTail(nullptr)
+   {
+      for (auto & t : il)
+         push_back(t);
+   }
+   template <class Iterator>
+   unrolled_list(Iterator first, Iterator last) :
+      numElements(0), pHead(nullptr), pTail(nullptr)
+   {
+      for (; first != last; ++first)
+         push_back(*first);
+   }
+  ~unrolled_list()
+   {
+      clear();
+   }
+
+   //
+   // Assign
+   //
+
+   unrolled_list & operator = (const unrolled_list & rhs)
+   {
+      if (this != &rhs)
+      {
+         clear();
+         for (Node * p = rhs.pHead; p; p = p->pNext)
+            for (std::size_t i = 0; i < p->num; i++)
+               push_back(*p->slot(i));
+      }
+      return *this;
+   }
+   unrolled_list & operator = (unrolled_list && rhs)
+   {
+      clear();
+
+      // nodes from another allocator cannot be stolen, only their data
+      if (!NodeTraits::propagate_on_container_move_assignment::value &&
+          !(nodeAlloc == rhs.nodeAlloc))
+      {
+         for (Node * p = rhs.pHead; p; p = p->pNext)
+            for (std::size_t i = 0; i < p->num; i++)
+               push_back(std::move(*p->slot(i)));
+         rhs.clear();
+         return *this;
+      }
+      moveAllocator(rhs.nodeAlloc, typename NodeTraits::propagate_on_container_move_assignment());
+
+      numElements = rhs.numElements;
+      pHead = rhs.pHead;
+      pTail = rhs.pTail;
+      rhs.numElements = 0;
+      rhs.pHead = rhs.pTail = nullptr;
+      return *this;
+   }
+   unrolled_list & operator = (const std::initializer_list<T> & il)
+   {
+      clear();
+      for (auto & t : il)
+         push_back(t);
+      return *this;
+   }
+   void swap(unrolled_list & rhs)
+   {
+      unrolled_list temp(std::move(*this));
+      *this = std::move(rhs);
+      rhs = std::move(temp);
+   }
+
+   //
+   // Iterator
+   //
+
+   class iterator;
+   iterator begin()  { return iterator(pHead, 0); }
+   iterator rbegin() { return pTail ? iterator(pTail, pTail->num - 1) : end(); }
+   iterator end()    { return iterator(nullptr, 0); }
+
+   //
+   // Access
+   //
+
+   T & front()
+   {
+      assert(pHead);
+      return *pHead->slot(0);
+   }
+   T & back()
+   {
+      assert(pTail);
+      return *pTail->slot(pTail->num - 1);
+   }
+
+   //
+   // Insert
+   //
+
+   void push_front(const T &  data) { insert(begin(), data);            }
+   void push_front(      T && data) { insert(begin(), std::move(data)); }
+   void push_back (const T &  data) { emplaceBack(data);                }
+   void push_back (      T && data) { emplaceBack(std::move(data));     }
+   iterator insert(iterator it, const T &  data) { return emplace(it, data);            }
+   iterator insert(iterator it,       T && data) { return emplace(it, std::move(data)); }
+
+   //
+   // Remove
+   //
+
+   void pop_back()
+   {
+      if (pTail)
+         erase(rbegin());
+   }
+   void pop_front()
+   {
+      if (pHead)
+         erase(begin());
+   }
+   void clear()
+   {
+      while (pHead)
+      {
+         Node * p = pHead;
+         pHead = pHead->pNext;
+         for (std::size_t i = 0; i < p->num; i++)
+            p->slot(i)->~T();
+         freeNode(p);
+      }
+      pTail = nullptr;
+      numElements = 0;
+   }
+   iterator erase(const iterator & it);
+
+   //
+   // Status
+   //
+
+   bool empty()  const { return numElements == 0; }
+   std::size_t size() const { return numElements; }
+   A get_allocator() const { return A(nodeAlloc); }
+
+private:
+   // up to K elements, constructed in place in the front num slots
+   struct Node
+   {
+      Node() : pNext(nullptr), pPrev(nullptr), num(0) {}
+      T * slot(std::size_t i) { return reinterpret_cast<T *>(storage) + i; }
+
+      Node * pNext;
+      Node * pPrev;
+      std::size_t num;
+      alignas(T) unsigned char storage[K * sizeof(T)];
+   };
+
+   typedef typename std::allocator_traits<A>::template rebind_alloc<Node> NodeAlloc;
+   typedef std::allocator_traits<NodeAlloc> NodeTraits;
+
+   // an empty node linked in after pBefore, or at the head if pBefore is nullptr
+   Node * linkNode(Node * pBefore)
+   {
+      Node * p = NodeTraits::allocate(nodeAlloc, 1);
+      NodeTraits::construct(nodeAlloc, p);
+      p->pPrev = pBefore;
+      p->pNext = pBefore ? pBefore->pNext : pHead;
+      if (p->pNext)
+         p->pNext->pPrev = p;
+      else
+         pTail = p;
+      if (pBefore)
+         pBefore->pNext = p;
+      else
+         pHead = p;
+      return p;
+   }
+
+   // take an empty node out of the chain
+   void unlinkNode(Node * p)
+   {
+      if (p->pPrev)
+         p->pPrev->pNext = p->pNext;
+      else
+         pHead = p->pNext;
+      if (p->pNext)
+         p->pNext->pPrev = p->pPrev;
+      else
+         pTail = p->pPrev;
+      freeNode(p);
+   }
+
+   void freeNode(Node * p)
+   {
+      NodeTraits::destroy(nodeAlloc, p);
+      NodeTraits::deallocate(nodeAlloc, p, 1);
+   }
+
+   // move the elements at [iSrc, pSrc->num) to the end of pDest
+   static void moveTail(Node * pSrc, std::size_t iSrc, Node * pDest)
+   {
+      for (std::size_t i = iSrc; i < pSrc->num; i++)
+      {
+         new (pDest->slot(pDest->num)) T(std::move(*pSrc->slot(i)));
+         pDest->num++;
+         pSrc->slot(i)->~T();
+      }
+      pSrc->num = iSrc;
+   }
+
+   template <class U>
+   void emplaceBack(U && data)
+   {
+      Node * p = (pTail && pTail->num < K) ? pTail : linkNode(pTail);
+      new (p->slot(p->num)) T(std::forward<U>(data));
+      p->num++;
+      numElements++;
+   }
+
+   template <class U>
+   iterator emplace(iterator it, U && data);
+
+   // the allocator follows the nodes only when it says it should
+   void moveAllocator(NodeAlloc & rhs, std::true_type) { nodeAlloc = std::move(rhs); }
+   void moveAllocator(NodeAlloc &,     std::false_type) { }
+
+   std::size_t numElements;  // the number of elements in all the nodes
+   Node * pHead;             // the first node
+   Node * pTail;             // the last node
+   NodeAlloc nodeAlloc;      // where the nodes come from
+};
+
+/*************************************************
+ * UNROLLED LIST ITERATOR
+ * A node and a slot in it. The end is no node.
+ ************************************************/
+template <typename T, std::size_t K, typename A>
+class unrolled_list <T, K, A> :: iterator
+{
+   friend class ::TestUnrolledList; // give unit tests access to the privates
+   friend class unrolled_list;
+public:
+   iterator() : p(nullptr), i(0) {}
+   iterator(Node * p, std::size_t i) : p(p), i(i) {}
+
+   bool operator == (const iterator & rhs) const { return p == rhs.p && i == rhs.i; }
+   bool operator != (const iterator & rhs) const { return p != rhs.p || i != rhs.i; }
+
+   T & operator * () { return *p->slot(i); }
+
+   iterator & operator ++ ()
+   {
+      if (++i == p->num)
+      {
+         p = p->pNext;
+         i = 0;
+      }
+      return *this;
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator temp(*this);
+      ++(*this);
+      return temp;
+   }
+   iterator & operator -- ()
+   {
+      if (i > 0)
+         i--;
+      else
+      {
+         p = p->pPrev;
+         i = p ? p->num - 1 : 0;
+      }
+      return *this;
+   }
+   iterator operator -- (int postfix)
+   {
+      iterator temp(*this);
+      --(*this);
+      return temp;
+   }
+
+private:
+   Node * p;        // the node, or nullptr for end()
+   std::size_t i;   // the slot in the node
+};
+
+/*********************************************
+ * UNROLLED LIST :: EMPLACE
+ * Put a new element in front of it. A full node
+ * is split in two first.
+ *    INPUT  : where the new element goes
+ *    OUTPUT : an iterator to the new element
+ *    COST   : O(K)
+ *********************************************/
+template <typename T, std::size_t K, typename A>
+template <class U>
+typename unrolled_list <T, K, A> ::iterator
+unrolled_list <T, K, A> ::emplace(iterator it, U && data)
+{
+   // the end is the back of the last node
+   if (nullptr == it.p)
+   {
+      emplaceBack(std::forward<U>(data));
+      return rbegin();
+   }
+
+   // data may be one of the elements a split or slide moves
+   T temp(std::forward<U>(data));
+   Node * p = it.p;
+   std::size_t i = it.i;
+
+   // at the front of a full node: the back of the node before, or a new one
+   if (i == 0 && p->num == K)
+   {
+      p = (p->pPrev && p->pPrev->num < K) ? p->pPrev : linkNode(p->pPrev);
+      i = p->num;
+   }
+
+   // no room: move the back half to a new node
+   if (p->num == K)
+   {
+      Node * pNew = linkNode(p);
+      moveTail(p, K / 2, pNew);
+      if (i > p->num)
+      {
+         i -= p->num;
+         p = pNew;
+      }
+   }
+
+   // slide everything from i back one to make a hole
+   if (i == p->num)
+      new (p->slot(i)) T(std::move(temp));
+   else
+   {
+      new (p->slot(p->num)) T(std::move(*p->slot(p->num - 1)));
+      for (std::size_t j = p->num - 1; j > i; j--)
+         *p->slot(j) = std::move(*p->slot(j - 1));
+      *p->slot(i) = std::move(temp);
+   }
+   p->num++;
+   numElements++;
+   return iterator(p, i);
+}
+
+/*********************************************
+ * UNROLLED LIST :: ERASE
+ * Remove the element at it, freeing the node
+ * if that leaves it empty
+ *    INPUT  : the element to remove
+ *    OUTPUT : the element after it
+ *    COST   : O(K)
+ *********************************************/
+template <typename T, std::size_t K, typename A>
+typename unrolled_list <T, K, A> ::iterator
+unrolled_list <T, K, A> ::erase(const iterator & it)
+{
+   Node * p = it.p;
+   if (nullptr == p)
+      return end();
+
+   // slide everything after i forward one
+   for (std::size_t j = it.i; j + 1 < p->num; j++)
+      *p->slot(j) = std::move(*p->slot(j + 1));
+   p->slot(p->num - 1)->~T();
+   p->num--;
+   numElements--;
+
+   if (p->num == 0)
+   {
+      Node * pNext = p->pNext;
+      unlinkNode(p);
+      return iterator(pNext, 0);
+   }
+   if (it.i == p->num)
+      return iterator(p->pNext, 0);
+   return iterator(p, it.i);
+}
+
+/**********************************************
+ * SWAP
+ * Stand-alone unrolled list swap
+ **********************************************/
+template <typename T, std::size_t K, typename A>
+void swap(unrolled_list <T, K, A> & lhs, unrolled_list <T, K, A> & rhs)
+{
+   lhs.swap(rhs);
+}
+
+} // namespace custom
@@ -20,8 +20,22 @@
 #pragma once
 
 #include <cassert>  // because I am paranoid
+#include <cstring>  // for std::memcpy
 #include <new>      // std::bad_alloc
 #include <memory>   // for std::allocator
+#include <type_traits> // for std::is_trivially_copyable
+#include <utility>  // for std::move
+#include "hashing.h" // for hash_bytes and hash_combine
+
+#ifdef __linux__
+#include <sys/mman.h> // for mmap and mremap
+#endif
+
+#ifdef __has_include
+#if __has_include(<memory_resource>)
+#include <memory_resource> // for std::pmr::polymorphic_allocator
+#endif
+#endif
 
 class TestVector; // forward declaration for unit tests
 class TestStack;
@@ -31,11 +45,29 @@ class TestHash;
 namespace custom
 {
 
+/*****************************************
+ * IS TRIVIALLY RELOCATABLE
+ * A T whose bytes can be copied to a new address
+ * and the old ones forgotten, with no move and
+ * no destructor. Every trivially copyable T is;
+ * specialize this for others that are, such as a
+ * type that only holds a pointer it owns.
+ ****************************************/
+template <class T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
 /*****************************************
  * VECTOR
- * Just like the std :: vector <T> class
+ * Just like the std :: vector <T> class. The buffer
+ * comes from the allocator A. Only the first
+ * numElements slots hold a T; the rest are raw.
+ *
+ * On Linux, a buffer of at least 1 MiB of trivially
+ * relocatable T with the default allocator comes
+ * from mmap instead, so growing it is an mremap
+ * and no bytes are copied.
  ****************************************/
-template <typename T>
+template <typename T, typename A = std::allocator<T>>
 class vector
 {
    friend class ::TestVector; // give unit tests access to the privates
@@ -49,6 +81,7 @@ public:
    //
 
    vector() : data(nullptr), numElements(0), numCapacity(0) {}
+   explicit vector(const A & a) : data(nullptr), numElements(0), numCapacity(0), alloc(a) {}
    vector(size_t numElements                );
    vector(size_t numElements, const T & t   );
    vector(const std::initializer_list<T>& l );
@@ -65,6 +98,7 @@ public:
       std::swap(data, rhs.data);
       std::swap(numElements, rhs.numElements);
       std::swap(numCapacity, rhs.numCapacity);
+      swapAllocator(rhs.alloc, typename Traits::propagate_on_container_swap());
    }
    vector & operator = (const vector & rhs);
    vector & operator = (vector&& rhs);
@@ -94,6 +128,10 @@ public:
 
    void push_back(const T& t);
    void push_back(T&& t);
+   template <class... Args>
+   T & emplace_back(Args&&... args);
+   template <class... Args>
+   iterator emplace(iterator it, Args&&... args);
    void reserve(size_t newCapacity);
    void resize(size_t newElements);
    void resize(size_t newElements, const T& t);
@@ -104,12 +142,13 @@ public:
 
    void clear()
    {
+      destroy(0, numElements);
       numElements = 0;
    }
    void pop_back()
    {
       if (numElements)
-         --numElements;
+         Traits::destroy(alloc, data + --numElements);
    }
    void shrink_to_fit();
 
@@ -120,12 +159,101 @@ public:
    size_t  size()          const { return numElements;}
    size_t  capacity()      const { return numCapacity;}
    bool empty()            const { return numElements == 0;}
+   A get_allocator()       const { return alloc;}
 
 private:
+   typedef std::allocator_traits<A> Traits;
+
+   // big buffers of plain bytes come straight from the kernel
+   static const size_t MAP_THRESHOLD = 1 << 20;
+   static bool isMapped(size_t num)
+   {
+#ifdef __linux__
+      return std::is_same<A, std::allocator<T>>::value &&
+             is_trivially_relocatable<T>::value &&
+             num * sizeof(T) >= MAP_THRESHOLD;
+#else
+      return false;
+#endif
+   }
+
+   // room for num T from the allocator, nothing constructed
+   T * allocateBuffer(size_t num)
+   {
+#ifdef __linux__
+      if (isMapped(num))
+      {
+         void * p = mmap(nullptr, num * sizeof(T), PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+         if (MAP_FAILED == p)
+            throw std::bad_alloc();
+         return static_cast<T *>(p);
+      }
+#endif
+      return Traits::allocate(alloc, num);
+   }
+
+   // give a buffer back; its elements must already be gone
+   void freeBuffer(T * p, size_t num)
+   {
+#ifdef __linux__
+      if (isMapped(num))
+      {
+         munmap(p, num * sizeof(T));
+         return;
+      }
+#endif
+      Traits::deallocate(alloc, p, num);
+   }
+
+   // move everything to a buffer of newCapacity
+   void reallocate(size_t newCapacity);
+
+   // destroy the elements in [iBegin, iEnd)
+   void destroy(size_t iBegin, size_t iEnd)
+   {
+      for (size_t i = iBegin; i < iEnd; i++)
+         Traits::destroy(alloc, data + i);
+   }
+
+   // build T in the raw slots [iBegin, iEnd), copying t if given
+   template <class... Args>
+   void construct(size_t iBegin, size_t iEnd, const Args &... t)
+   {
+      size_t i = iBegin;
+      try
+      {
+         for (; i < iEnd; i++)
+            Traits::construct(alloc, data + i, t...);
+      }
+      catch (...)
+      {
+         destroy(iBegin, i);
+         throw;
+      }
+   }
+
+   // move the elements into pNew and end their lives here
+   void relocate(T * pNew);
+   void relocate(T * pNew, std::true_type);
+   void relocate(T * pNew, std::false_type);
+
+   // move to a bigger buffer, building the new element first
+   template <class... Args>
+   T & growAndEmplace(Args&&... args);
+
+   // the allocator follows the buffer only when it says it should
+   void swapAllocator(A & rhs, std::true_type) { using std::swap; swap(alloc, rhs); }
+   void swapAllocator(A &,     std::false_type) { }
+   void moveAllocator(A & rhs, std::true_type) { alloc = std::move(rhs); }
+   void moveAllocator(A &,     std::false_type) { }
+   void copyAllocator(const A & rhs, std::true_type) { alloc = rhs; }
+   void copyAllocator(const A &,     std::false_type) { }
 
    T *  data;             // user data, a dynamically-allocated array
    size_t  numCapacity;   // the capacity of the array
    size_t  numElements;   // the number of items currently used
+   A alloc;               // where the buffer comes from
 };
 
 /**************************************************
@@ -139,19 +267,21 @@ private:
  * This particular iterator is a bi-directional meaning
  * that ++ and -- both work.  Not all iterators are that way.
  *************************************************/
-template <typename T>
-class vector <T> ::iterator
+template <typename T, typename A>
+class vector <T, A> ::iterator
 {
    friend class ::TestVector; // give unit tests access to the privates
    friend class ::TestStack;
    friend class ::TestPQueue;
    friend class ::TestHash;
+   template <typename TT, typename AA>
+   friend class custom::vector;
 public:
    // constructors, destructors, and assignment operator
    iterator() : p(nullptr)              {                     }
    iterator(T* p) : p(p)                {                     }
    iterator(const iterator& rhs)        { *this = rhs;        }
-   iterator(size_t index, vector<T>& v) { p = v.data + index; }
+   iterator(size_t index, vector<T, A>& v) { p = v.data + index; }
    iterator& operator = (const iterator& rhs)
    {
       this->p = rhs.p;
@@ -210,21 +340,28 @@ private:
  * non-default constructor: set the number of elements,
  * construct each element, and copy the values over
  ****************************************/
-template <typename T>
-vector <T> :: vector(size_t num, const T & t) :
+template <typename T, typename A>
+vector <T, A> :: vector(size_t num, const T & t) :
 data(nullptr), numElements(0), numCapacity(0)
 {
    // do nothing if there is nothing to do
    if (num > 0)
    {
       // allocate memory
-      data = new T[num];
+      data = allocateBuffer(num);
       numCapacity = num;
-      numElements = num;
 
       // copy the value
-      for (size_t i = size_t(0); i < num; i++)
-         data[i] = t;
+      try
+      {
+         construct(0, num, t);
+      }
+      catch (...)
+      {
+         freeBuffer(data, num);
+         throw;
+      }
+      numElements = num;
    }
 
 }
@@ -233,21 +370,31 @@ data(nullptr), numElements(0), numCapacity(0)
  * VECTOR :: INITIALIZATION LIST constructors
  * Create a vector with an initialization list.
  ****************************************/
-template <typename T>
-vector <T> :: vector(const std::initializer_list<T> & l) :
+template <typename T, typename A>
+vector <T, A> :: vector(const std::initializer_list<T> & l) :
       data(nullptr), numElements(0), numCapacity(0)
 {
    if (l.size())
    {
       // allocate memory
-      data = new T[l.size()];
+      data = allocateBuffer(l.size());
+      numCapacity = l.size();
 
       // copy the value
-      size_t i = size_t(0);
-      for (auto &item : l)
-         data[i++] = item;
-      numElements = l.size();
-      numCapacity = l.size();
+      try
+      {
+         for (auto &item : l)
+         {
+            Traits::construct(alloc, data + numElements, item);
+            numElements++;
+         }
+      }
+      catch (...)
+      {
+         clear();
+         freeBuffer(data, numCapacity);
+         throw;
+      }
    }
 }
 
@@ -256,18 +403,25 @@ vector <T> :: vector(const std::initializer_list<T> & l) :
  * non-default constructor: set the number of elements,
  * construct each element, and copy the values over
  ****************************************/
-template <typename T>
-vector <T> :: vector(size_t num):
+template <typename T, typename A>
+vector <T, A> :: vector(size_t num):
       data(nullptr), numElements(0), numCapacity(0)
 {
    // do nothing if there is nothing to do
    if (num > size_t(0))
    {
-      numElements = num;
+      data = allocateBuffer(num);
       numCapacity = num;
-      data = new T[num];
-      for (size_t i = size_t(0); i < num; i++)
-         data[i] = T();
+      try
+      {
+         construct(0, num);
+      }
+      catch (...)
+      {
+         freeBuffer(data, num);
+         throw;
+      }
+      numElements = num;
    }
 }
 
@@ -276,8 +430,9 @@ vector <T> :: vector(size_t num):
  * Allocate the space for numElements and
  * call the copy constructor on each element
  ****************************************/
-template <typename T>
-vector <T> :: vector (const vector & rhs) : data(nullptr), numElements(0), numCapacity(0)
+template <typename T, typename A>
+vector <T, A> :: vector (const vector & rhs) : data(nullptr), numElements(0), numCapacity(0),
+   alloc(Traits::select_on_container_copy_construction(rhs.alloc))
 {
    *this = rhs;
 }
@@ -286,8 +441,9 @@ vector <T> :: vector (const vector & rhs) : data(nullptr), numElements(0), numCa
  * VECTOR :: MOVE CONSTRUCTOR
  * Steal the values from the RHS and set it to zero.
  ****************************************/
-template <typename T>
-vector <T> :: vector (vector && rhs) : data(nullptr), numElements(0), numCapacity(0)
+template <typename T, typename A>
+vector <T, A> :: vector (vector && rhs) : data(nullptr), numElements(0), numCapacity(0),
+   alloc(std::move(rhs.alloc))
 {
    *this = std::move(rhs);
 }
@@ -297,13 +453,14 @@ vector <T> :: vector (vector && rhs) : data(nullptr), numElements(0), numCapacit
  * Call the destructor for each element from 0..numElements
  * and then free the memory
  ****************************************/
-template <typename T>
-vector <T> :: ~vector()
+template <typename T, typename A>
+vector <T, A> :: ~vector()
 {
    if (numCapacity > 0)
    {
       assert(nullptr != data);
-      delete [] data;
+      destroy(0, numElements);
+      freeBuffer(data, numCapacity);
    }
 }
 
@@ -314,8 +471,8 @@ vector <T> :: ~vector()
  *     INPUT  : newCapacity the size of the new buffer
  *     OUTPUT :
  **************************************/
-template <typename T>
-void vector <T> :: resize(size_t newElements)
+template <typename T, typename A>
+void vector <T, A> :: resize(size_t newElements)
 {
    assert(newElements >= 0);
 
@@ -327,17 +484,18 @@ void vector <T> :: resize(size_t newElements)
          reserve(newElements);
 
       // now fill the new slots with the default T
-      for (size_t i = numElements; i < newElements; i++)
-         data[i] = T();
+      construct(numElements, newElements);
    }
+   else
+      destroy(newElements, numElements);
 
    // if we have made it this far, adjust the number of elements
    numElements = newElements;
 
 }
 
-template <typename T>
-void vector <T> :: resize(size_t newElements, const T & t)
+template <typename T, typename A>
+void vector <T, A> :: resize(size_t newElements, const T & t)
 {
    assert(newElements >= 0);
 
@@ -348,43 +506,122 @@ void vector <T> :: resize(size_t newElements, const T & t)
     if (newElements > numCapacity)
        reserve(newElements);
 
-    // now fill the new slots with the default T
-    for (size_t i = numElements; i < newElements; i++)
-       data[i] = t;
+    // now fill the new slots with copies of t
+    construct(numElements, newElements, t);
    }
+   else
+      destroy(newElements, numElements);
 
    // if we have made it this far, adjust the number of elements
    numElements = newElements;
 }
 
+/***************************************
+ * VECTOR :: RELOCATE
+ * Move the elements to the raw buffer pNew,
+ * leaving nothing alive in the old one. A
+ * trivially relocatable T is one memcpy. Any
+ * other T is moved if that cannot throw and
+ * copied otherwise, so a throw part way leaves
+ * the old buffer as it was.
+ *     INPUT  : pNew room for numElements
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A>
+void vector <T, A> :: relocate(T * pNew)
+{
+   relocate(pNew, typename is_trivially_relocatable<T>::type());
+}
+
+template <typename T, typename A>
+void vector <T, A> :: relocate(T * pNew, std::true_type)
+{
+   if (numElements)
+      std::memcpy(static_cast<void *>(pNew), static_cast<const void *>(data),
+                  numElements * sizeof(T));
+}
+
+template <typename T, typename A>
+void vector <T, A> :: relocate(T * pNew, std::false_type)
+{
+   size_t i = 0;
+   try
+   {
+      for (; i < numElements; i++)
+         Traits::construct(alloc, pNew + i, std::move_if_noexcept(data[i]));
+   }
+   catch (...)
+   {
+      while (i--)
+         Traits::destroy(alloc, pNew + i);
+      throw;
+   }
+   destroy(0, numElements);
+}
+
 /***************************************
  * VECTOR :: RESERVE
  * This method will grow the current buffer
- * to newCapacity.  It will also copy all
+ * to newCapacity.  It will also move all
  * the data from the old buffer into the new
  *     INPUT  : newCapacity the size of the new buffer
  *     OUTPUT :
  **************************************/
-template <typename T>
-void vector <T> :: reserve(size_t newCapacity)
+template <typename T, typename A>
+void vector <T, A> :: reserve(size_t newCapacity)
 {
    // do nothing if we are already big enough
    if (newCapacity <= numCapacity)
       return;
    assert(newCapacity > 0 && newCapacity > numCapacity);
 
+   reallocate(newCapacity);
+}
+
+/***************************************
+ * VECTOR :: REALLOCATE
+ * Move the elements to a new buffer of
+ * newCapacity and free the old one. When both
+ * buffers are mapped, the kernel moves the pages.
+ *     INPUT  : newCapacity at least numElements
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A>
+void vector <T, A> :: reallocate(size_t newCapacity)
+{
+   assert(newCapacity >= numElements);
+#ifdef __linux__
+   if (isMapped(numCapacity) && isMapped(newCapacity))
+   {
+      void * p = mremap(data, numCapacity * sizeof(T), newCapacity * sizeof(T),
+                        MREMAP_MAYMOVE);
+      if (MAP_FAILED == p)
+         throw std::bad_alloc();
+      data = static_cast<T *>(p);
+      numCapacity = newCapacity;
+      return;
+   }
+#endif
+
    // allocate the new array
-   T* pNew = new T[newCapacity];
+   T* pNew = allocateBuffer(newCapacity);
 
-   // copy over the data from the old array
-   for (size_t i = 0; i < numElements; i++)
-      pNew[i] = std::move(data[i]);
+   // move over the data from the old array
+   try
+   {
+      relocate(pNew);
+   }
+   catch (...)
+   {
+      freeBuffer(pNew, newCapacity);
+      throw;
+   }
 
-   delete[] data;
+   if (nullptr != data)
+      freeBuffer(data, numCapacity);
 
    data = pNew;
    numCapacity = newCapacity;
-
 }
 
 /***************************************
@@ -393,32 +630,24 @@ void vector <T> :: reserve(size_t newCapacity)
  *     INPUT  :
  *     OUTPUT :
  **************************************/
-template <typename T>
-void vector <T> :: shrink_to_fit()
+template <typename T, typename A>
+void vector <T, A> :: shrink_to_fit()
 {
    // do nothing if we have no space
    if (numCapacity == numElements)
       return;
 
-   // allocate the new array
-   T * pNew;
+   // move to a buffer of just the right size
    if (numElements != 0)
-   {
-      pNew = new T[numElements];
-      for (size_t i = 0; i < numElements; i++)
-         pNew[i] = data[i];
-   }
+      reallocate(numElements);
    else
-      pNew = nullptr;
-
-
-   // delete the old and assign the new
-   if (nullptr != data)
    {
-      delete[] data;
+      // delete the old
+      if (nullptr != data)
+         freeBuffer(data, numCapacity);
+      data = nullptr;
+      numCapacity = 0;
    }
-   data = pNew;
-   numCapacity = numElements;
 }
 
 
@@ -427,8 +656,8 @@ void vector <T> :: shrink_to_fit()
  * VECTOR :: SUBSCRIPT
  * Read-Write access
  ****************************************/
-template <typename T>
-T & vector <T> :: operator [] (size_t index)
+template <typename T, typename A>
+T & vector <T, A> :: operator [] (size_t index)
 {
    // sanity check. Note that we do not do error-checking with []
    assert (index >= 0 && index < numElements);
@@ -440,8 +669,8 @@ T & vector <T> :: operator [] (size_t index)
  * VECTOR :: SUBSCRIPT
  * Read-Write access
  *****************************************/
-template <typename T>
-const T & vector <T> :: operator [] (size_t index) const
+template <typename T, typename A>
+const T & vector <T, A> :: operator [] (size_t index) const
 {
    // sanity check
    assert (index >= 0 && index < numElements);
@@ -452,8 +681,8 @@ const T & vector <T> :: operator [] (size_t index) const
  * VECTOR :: FRONT
  * Read-Write access
  ****************************************/
-template <typename T>
-T & vector <T> :: front ()
+template <typename T, typename A>
+T & vector <T, A> :: front ()
 {
    // sanity check. Note that we do not do error-checking with front
    assert(numElements > 0);
@@ -464,8 +693,8 @@ T & vector <T> :: front ()
  * VECTOR :: FRONT
  * Read-Write access
  *****************************************/
-template <typename T>
-const T & vector <T> :: front () const
+template <typename T, typename A>
+const T & vector <T, A> :: front () const
 {
    // sanity check
    assert(numElements > 0);
@@ -476,8 +705,8 @@ const T & vector <T> :: front () const
  * VECTOR :: FRONT
  * Read-Write access
  ****************************************/
-template <typename T>
-T & vector <T> :: back()
+template <typename T, typename A>
+T & vector <T, A> :: back()
 {
    // sanity check. Note that we do not do error-checking with back
    assert(numElements > 0);
@@ -488,8 +717,8 @@ T & vector <T> :: back()
  * VECTOR :: FRONT
  * Read-Write access
  *****************************************/
-template <typename T>
-const T & vector <T> :: back() const
+template <typename T, typename A>
+const T & vector <T, A> :: back() const
 {
    // sanity check
    assert(numElements > 0);
@@ -504,38 +733,120 @@ const T & vector <T> :: back() const
  *     INPUT  : 't' the new element to be added
  *     OUTPUT : *this
  **************************************/
-template <typename T>
-void vector <T> :: push_back (const T & t)
+template <typename T, typename A>
+void vector <T, A> :: push_back (const T & t)
 {
-   assert(numElements <= numCapacity);
+   emplace_back(t);
+}
 
-   // grow if necessary
-   if (numCapacity == 0)
-      reserve(1);
-   else if (numElements == numCapacity)
-      reserve(numCapacity * 2);   // could throw ERROR: Unable to allocate ...
-   assert(numElements < numCapacity);
-
-   // actually add on to the end of the list
-   data[numElements++] = t;
+template <typename T, typename A>
+void vector <T, A> ::push_back(T && t)
+{
+   emplace_back(std::move(t));
 }
 
-template <typename T>
-void vector <T> ::push_back(T && t)
+/***************************************
+ * VECTOR :: GROW AND EMPLACE
+ * Double the buffer and build a new element
+ * at the back. The element is built before
+ * the old ones move: the arguments may refer
+ * to one of them.
+ *     INPUT  : the arguments for T's constructor
+ *     OUTPUT : the new element
+ **************************************/
+template <typename T, typename A>
+template <class... Args>
+T & vector <T, A> ::growAndEmplace(Args&&... args)
+{
+   size_t newCapacity = numCapacity ? numCapacity * 2 : 1;
+
+   // a remapped buffer may move under the arguments, so copy them out first
+   if (isMapped(numCapacity))
+   {
+      T t(std::forward<Args>(args)...);
+      reallocate(newCapacity);
+      T * p = data + numElements;
+      Traits::construct(alloc, p, std::move(t));
+      numElements++;
+      return *p;
+   }
+
+   T * pNew = allocateBuffer(newCapacity);
+   T * p = pNew + numElements;
+   try
+   {
+      Traits::construct(alloc, p, std::forward<Args>(args)...);
+      try
+      {
+         relocate(pNew);
+      }
+      catch (...)
+      {
+         Traits::destroy(alloc, p);
+         throw;
+      }
+   }
+   catch (...)
+   {
+      freeBuffer(pNew, newCapacity);
+      throw;
+   }
+
+   if (nullptr != data)
+      freeBuffer(data, numCapacity);
+   data = pNew;
+   numCapacity = newCapacity;
+   numElements++;
+   return *p;
+}
+
+/***************************************
+ * VECTOR :: EMPLACE
+ * Build a new element in its slot from the
+ * arguments to one of T's constructors, so
+ * nothing is copied or moved into it.
+ *     INPUT  : where the element goes: the back,
+ *              or in front of it
+ *              the arguments for T's constructor
+ *     OUTPUT : the new element
+ **************************************/
+template <typename T, typename A>
+template <class... Args>
+T & vector <T, A> ::emplace_back(Args&&... args)
 {
    assert(numElements <= numCapacity);
 
    // grow if necessary
-   if (numCapacity == 0)
-      reserve(1);
-   else if (numElements == numCapacity)
-      reserve(numCapacity * 2);   // could throw ERROR: Unable to allocate ...
-   assert(numElements < numCapacity);
-
-   // actually add on to the end of the list
-   data[numElements++] = std::move(t);
+   if (numElements == numCapacity)
+      return growAndEmplace(std::forward<Args>(args)...);
+
+   // build it in the first raw slot
+   T * p = data + numElements;
+   Traits::construct(alloc, p, std::forward<Args>(args)...);
+   numElements++;
+   return *p;
 }
 
+template <typename T, typename A>
+template <class... Args>
+typename vector <T, A> ::iterator vector <T, A> ::emplace(iterator it, Args&&... args)
+{
+   size_t index = it.p ? it.p - data : 0;
+   assert(index <= numElements);
+   if (index == numElements)
+   {
+      emplace_back(std::forward<Args>(args)...);
+      return iterator(data + index);
+   }
+
+   // build it first: the arguments may refer to an element we are about to slide
+   T t(std::forward<Args>(args)...);
+   emplace_back(std::move(data[numElements - 1]));
+   for (size_t i = numElements - 2; i > index; i--)
+      data[i] = std::move(data[i - 1]);
+   data[index] = std::move(t);
+   return iterator(data + index);
+}
 
 /***************************************
  * VECTOR :: ASSIGNMENT
@@ -544,33 +855,142 @@ void vector <T> ::push_back(T && t)
  *     INPUT  : rhs the vector to copy from
  *     OUTPUT : *this
  **************************************/
-template <typename T>
-vector <T> & vector <T> :: operator = (const vector & rhs)
+template <typename T, typename A>
+vector <T, A> & vector <T, A> :: operator = (const vector & rhs)
 {
-   // clear out the old data
-   clear();
+   if (this == &rhs)
+      return *this;
 
-   // ensure we have sufficient size
-   if (rhs.size() > numElements)
+   // a buffer from the old allocator cannot go back to the new one
+   if (Traits::propagate_on_container_copy_assignment::value &&
+       !(alloc == rhs.alloc))
+   {
+      clear();
+      shrink_to_fit();
+   }
+   copyAllocator(rhs.alloc, typename Traits::propagate_on_container_copy_assignment());
+
+   // ensure we have sufficient size, keeping nothing of the old
+   if (rhs.size() > numCapacity)
+   {
+      clear();
       reserve(rhs.size());
+   }
 
-   // copy over the elements from the initialization list
-   for (size_t i = size_t(0); i < rhs.size(); i++)
+   // assign onto the elements we have, then build or destroy the rest
+   size_t numAssign = rhs.numElements < numElements ? rhs.numElements : numElements;
+   for (size_t i = size_t(0); i < numAssign; i++)
       data[i] = rhs.data[i];
+   if (rhs.numElements > numElements)
+   {
+      for (size_t i = numElements; i < rhs.numElements; i++)
+      {
+         Traits::construct(alloc, data + i, rhs.data[i]);
+         numElements++;
+      }
+   }
+   else
+      destroy(rhs.numElements, numElements);
    numElements = rhs.numElements;
 
    // return self
    return *this;
 }
-template <typename T>
-vector <T>& vector <T> :: operator = (vector&& rhs)
+template <typename T, typename A>
+vector <T, A>& vector <T, A> :: operator = (vector&& rhs)
 {
    clear();
    shrink_to_fit();
-   swap(rhs);
+
+   // a buffer from another allocator cannot be stolen, only its data
+   if (!Traits::propagate_on_container_move_assignment::value &&
+       !(alloc == rhs.alloc))
+   {
+      reserve(rhs.numElements);
+      for (size_t i = 0; i < rhs.numElements; i++)
+      {
+         Traits::construct(alloc, data + i, std::move(rhs.data[i]));
+         numElements++;
+      }
+      rhs.clear();
+      return *this;
+   }
+   moveAllocator(rhs.alloc, typename Traits::propagate_on_container_move_assignment());
+
+   std::swap(data, rhs.data);
+   std::swap(numElements, rhs.numElements);
+   std::swap(numCapacity, rhs.numCapacity);
    return *this;
 }
 
 
 
+/*****************************************
+ * VECTOR EQUIVALENCE
+ * The same size, and equal element by element
+ ****************************************/
+template <typename T, typename A>
+bool operator == (const vector <T, A> & lhs, const vector <T, A> & rhs)
+{
+   if (lhs.size() != rhs.size())
+      return false;
+   for (size_t i = 0; i < lhs.size(); i++)
+      if (!(lhs[i] == rhs[i]))
+         return false;
+   return true;
+}
+
+template <typename T, typename A>
+bool operator != (const vector <T, A> & lhs, const vector <T, A> & rhs)
+{
+   return !(lhs == rhs);
+}
+
+#ifdef __cpp_lib_memory_resource
+namespace pmr
+{
+/*****************************************
+ * PMR VECTOR
+ * A vector drawing from a std::pmr::memory_resource:
+ *    custom::pmr::vector<int> v(&resource);
+ ****************************************/
+template <typename T>
+using vector = custom::vector<T, std::pmr::polymorphic_allocator<T>>;
+} // namespace pmr
+#endif // __cpp_lib_memory_resource
+
 } // namespace custom
+
+namespace std
+{
+/*****************************************
+ * HASH VECTOR
+ * When every bit of a T is part of its value, as
+ * with the integers, equal vectors have equal bytes
+ * and the whole buffer is hashed in one go.
+ * Otherwise, as with a float (0.0 == -0.0) or a
+ * string, each element is hashed and combined.
+ ****************************************/
+template <typename T, typename A>
+struct hash <custom::vector <T, A>>
+{
+   size_t operator () (const custom::vector <T, A> & v) const
+   {
+      return hashVector(v, typename has_unique_object_representations<T>::type());
+   }
+private:
+   static size_t hashVector(const custom::vector <T, A> & v, true_type)
+   {
+      if (v.empty())
+         return static_cast<size_t>(custom::hash_bytes(nullptr, 0));
+      return static_cast<size_t>(custom::hash_bytes(&v[0], v.size() * sizeof(T)));
+   }
+   static size_t hashVector(const custom::vector <T, A> & v, false_type)
+   {
+      size_t seed = v.size();
+      for (size_t i = 0; i < v.size(); i++)
+         custom::hash_combine(seed, v[i]);
+      return seed;
+   }
+};
+} // namespace std